@@ -28,66 +28,150 @@
 #include <time.h>
 #include <unistd.h>
 
+#include "../src/data/shm_channel.h"
+
 /* ============================================================================
  * CONFIGURATION AND CONSTANTS
  * ============================================================================ */
 
 /**
- * @brief Number of cryptocurrency symbols to monitor.
+ * @brief Number of symbol slots: the most cryptocurrency symbols monitored at once.
  */
 #define NUM_SYMBOLS 8
 
+#define SYMBOL_NAME_MAX 24 /**< Longest instrument id + 1 (e.g., "BTC-USDT") */
+
 /**
- * @brief Array of symbol names (e.g., "BTC-USDT").
+ * @brief Default symbol names (e.g., "BTC-USDT"), used unless the config file lists others.
  */
 extern const char *SYMBOLS[NUM_SYMBOLS];
 
+/* Runtime configuration (re-read on SIGHUP, see runtime_config.h) */
+#define CONFIG_PATH "trader.conf" /**< Default config file; the compile-time defaults apply when it is missing */
+
 /* Data directories for logging and metrics */
 #define BASE_DATA_DIR "data"
 #define TRADES_LOG_DIR "data/trades"
 #define METRICS_DIR "data/metrics"
 #define VWAP_DIR "data/metrics/vwap"
 #define CORRELATION_DIR "data/metrics/correlations"
+#define BARS_DIR "data/metrics/bars"
+#define FLOW_DIR "data/metrics/flow"
+#define VOLATILITY_DIR "data/metrics/volatility"
+#define QUANTILES_DIR "data/metrics/quantiles"
+#define RANGE_DIR "data/metrics/range"
+#define PROFILE_DIR "data/metrics/profile"
+#define ALERTS_DIR "data/alerts"
 #define PERFORMANCE_LOGS_DIR "data/performance"
 
 /* Time window and history sizes */
 #define WINDOW_MINUTES 15                        /**< 15-minute sliding window for trades */
 #define WINDOW_MS (WINDOW_MINUTES * 60 * 1000LL) /**< Window duration in milliseconds */
-#define WINDOW_CAPACITY 50000                    /**< Maximum trades in sliding window per symbol */
+#define WINDOW_CAPACITY 131072                   /**< Maximum trades in sliding window per symbol (power of two) */
+#define WINDOW_CHUNK_SHIFT 10                    /**< log2 of the trades per window chunk */
+#define WINDOW_CHUNK_TRADES (1 << WINDOW_CHUNK_SHIFT)                 /**< Trades per chunk (48 KB), taken from the pool as the window grows */
+#define WINDOW_MAX_CHUNKS (WINDOW_CAPACITY / WINDOW_CHUNK_TRADES)     /**< Chunks spanning WINDOW_CAPACITY */
+#define WINDOW_POOL_CHUNKS 512                   /**< Chunks shared by all symbols' windows (24 MB): bounds their memory */
+#define WINDOW_POOL_BYTES ((size_t)WINDOW_POOL_CHUNKS * WINDOW_CHUNK_TRADES * sizeof(processed_trade)) /**< Trade storage of the pool */
+#define WINDOW_QUANTILE_NODES (2u * WINDOW_POOL_CHUNKS * WINDOW_CHUNK_TRADES) /**< Quantile nodes shared by all windows (exact mode, 32 MB): one per pooled trade in each of the two sets */
+#define WINDOW_SPARE_CHUNKS 2                    /**< Empty chunks a window caches between pool trips (returned each minute) */
+#define WINDOW_QUANTILE_MODE QUANTILE_EXACT      /**< Window price/size quantiles: QUANTILE_EXACT or QUANTILE_APPROX (see quantiles.h) */
 
 /* History for moving averages and correlations */
 #define MOVING_AVG_POINTS 8                                          /**< Number of recent points for correlation analysis */
 #define MAX_LAG_MINUTES 60                                           /**< Maximum lag (minutes) to search for correlations */
-#define VWAP_HISTORY_SIZE_MINUTES (MAX_LAG_MINUTES + MOVING_AVG_POINTS) /**< Number of moving averages to keep in memory per symbol */
+#define VWAP_HISTORY_SIZE_MINUTES (MAX_LAG_MINUTES + MOVING_AVG_POINTS + 1) /**< Minutes of VWAPs kept (+1 so a view survives one concurrent append) */
+#define CORRELATION_PRUNING 1                                        /**< Skip lag windows whose screening bound cannot beat the best (exact); 0: batched GEMM of all windows */
+#define CORRELATION_FLOAT32 0                                        /**< Single-precision search on z-normalized windows (|error| ~2e-7, ignores pruning) */
+
+/* OHLCV bars (built per trade, closed at every minute tick) */
+#define NUM_BAR_INTERVALS 3         /**< Number of bar intervals in BAR_INTERVALS_MINUTES */
+#define BAR_HISTORY_SIZE_MINUTES 60 /**< Closed 1-minute bars kept per symbol (>= largest interval) */
+
+/**
+ * @brief Bar intervals in minutes (1 first; others are multiples aggregated from 1-minute bars).
+ */
+extern const int BAR_INTERVALS_MINUTES[NUM_BAR_INTERVALS];
+
+/* Volume profile (per-window volume by price bucket) */
+#define VOLUME_PROFILE_BUCKET_BPS 5.0  /**< Bucket width relative to the first price (rounded to 1/2/5 x 10^k) */
+#define VOLUME_PROFILE_SLOTS 4096      /**< Direct-mapped slots; the window's price span must stay below SLOTS buckets */
+#define VOLUME_PROFILE_VALUE_AREA 0.70 /**< Share of window volume inside the value area */
+
+/* Volatility estimators */
+#define EWMA_VOL_LAMBDA 0.94 /**< Decay of the per-minute EWMA variance (RiskMetrics) */
+
+/* Alerting (threshold rules evaluated after every tick) */
+#define ALERT_RULES_PATH "alerts.conf"              /**< Default rule file; alerting is off when it is missing */
+#define ALERT_SOCKET_PATH "data/alerts/alerts.sock" /**< Unix datagram socket alerts are also sent to, if bound */
+#define ALERT_MAX_RULES 65536                       /**< Maximum compiled rules (after '*' expansion) */
 
 /* Event queue capacity */
 #define RAW_TRADE_QUEUE_SIZE 1024 /**< Capacity of the raw trade queue */
 
+/* Multi-process deployment (--role ingest / --role analytics over shared memory) */
+#define SHM_CHANNEL_NAME "/okx-trader" /**< POSIX shared memory object of the trade ring and VWAP snapshot */
+#define SHM_TRADE_RING_SIZE 65536      /**< Trades buffered for the analytics process (power of two, ~2.5 MB) */
+#define SHM_ATTACH_RETRY_MS 1000       /**< Interval at which analytics retries attaching to the ingest process */
+#define SHM_WAIT_TIMEOUT_MS 100        /**< Longest consumer sleep before it rechecks shutdown and the producer */
+
+/* Shutdown (SIGINT/SIGTERM, read from a signalfd by the main thread) */
+#define SHUTDOWN_BUDGET_MS 5000                   /**< Default time for draining the queue and flushing outputs */
+#define CHECKPOINT_PREFIX "data/checkpoint"       /**< `<prefix>-<role>.json`, written at the end of a graceful shutdown */
+#define SHUTDOWN_WAKE_SIGNAL SIGUSR1              /**< Interrupts the scheduler's sleep (no-op handler) */
+
+/* Memory accounting (see utils/mem_budget.h) */
+#define MEMORY_BUDGET_MB 256 /**< Default ceiling of a process's accounted memory, checked at startup (0 = none) */
+#define ALLOC_AUDIT_WARMUP_MS WINDOW_MS /**< `make audit`: trade time before allocations count (every window filled once) */
+
 /* Synchronization settings */
 #define FSYNC_PER_WRITE 0 /**< Set to 1 for fsync on every write (durability but slower) */
 
+/* Output rotation and compression (trade logs and latency log); the policies, size limit,
+ * retention and fsync flag are defaults that the config file can change at runtime */
+#define TRADE_LOG_ROTATE ROTATE_HOURLY          /**< Rotation policy for data/trades/<SYMBOL>.jsonl */
+#define LATENCY_LOG_ROTATE ROTATE_HOURLY        /**< Rotation policy for data/performance/latency.{bin,csv} */
+#define LATENCY_LOG_BINARY 1                    /**< Set to 1 for 16-byte binary latency records (latency.bin), 0 for CSV */
+#define LOG_ROTATE_MAX_BYTES (64LL * 1024 * 1024) /**< Segment size limit used by ROTATE_SIZE */
+#define LOG_COMPRESS_SEGMENTS 1                 /**< Set to 1 to gzip closed segments in the background */
+#define LOG_RETAIN_SEGMENTS 72                  /**< Closed segments kept per stream (0 = keep all) */
+#define COMPRESSOR_QUEUE_SIZE 64                /**< Pending segments awaiting compression */
+
+/* Memory-mapped trade log segments */
+#define TRADE_SEGMENT_BYTES (8 * 1024 * 1024) /**< Preallocated size of each trade log segment */
+#define TRADE_SEGMENT_SYNC_MS 1000            /**< Interval of the background msync of active segments */
+#define TRADE_SEGMENT_RETIRED_MAX 4           /**< Retired segments awaiting the sync thread before the writer finalizes one itself */
+
 /* Time conversion constants */
 #define NS_PER_MS 1000000LL
 #define NS_PER_SEC 1000000000LL
 #define MS_PER_MINUTE 60000LL
 #define NS_PER_MINUTE (MS_PER_MINUTE * NS_PER_MS)
 
-/* Global flags */
-extern int shutdown_requested; /**< Flag to signal graceful shutdown on SIGINT */
+/* Global flags, set by the shutdown coordinator in this order. Always accessed with
+ * __atomic_store_n (release) and __atomic_load_n (acquire): every thread polls them. */
+extern int ingest_stop_requested; /**< Feed threads stop reading (the queue is still drained) */
+extern int shutdown_requested;    /**< Every other thread stops */
 
 /* ============================================================================
  * CORE DATA STRUCTURES
  * ============================================================================ */
 
+/* Taker side of a trade (OKX "side" field) */
+#define TRADE_SIDE_BUY 1
+#define TRADE_SIDE_SELL -1
+#define TRADE_SIDE_UNKNOWN 0
+
 /**
  * @brief Raw trade message received from WebSocket with metadata.
  */
 typedef struct
 {
-  int symbol_index;       /**< Index in the global SYMBOLS array. */
+  int symbol_index;       /**< Slot of the symbol in the published configuration. */
   int64_t exchange_ts_ms; /**< Exchange-provided trade timestamp (milliseconds). */
   double price;           /**< Trade price. */
   double size;            /**< Trade size/volume. */
+  int side;               /**< Taker side: TRADE_SIDE_BUY, TRADE_SIDE_SELL or TRADE_SIDE_UNKNOWN. */
   char raw_json[1024];    /**< Raw JSON message for logging. Assumes messages fit. */
   int64_t receive_ts_ms;  /**< Local timestamp when the message was received. */
 } raw_trade_message;
@@ -100,21 +184,147 @@ typedef struct
   int64_t trade_ts_ms;
   double price;
   double size;
+  int side;            /**< taker side (TRADE_SIDE_*) */
+  float sq_log_return; /**< squared log-return vs. the previous trade (fits the padding) */
+  uint32_t prev[2];    /**< previous (older) trade in the max [0] and min [1] deques */
+  uint32_t next[2];    /**< next (newer) trade in the max [0] and min [1] deques */
 } processed_trade;
 
 /**
- * @brief A single data point in the moving average history, representing one minute's VWAP and volume.
+ * @brief Order-flow snapshot of a sliding window, split by taker side.
  */
 typedef struct
 {
-  int64_t minute_ts_ms; /**< minute timestamp (aligned to minute) */
-  double vwap;          /**< VWAP over WINDOW_MS ending at this minute */
-} vwap_point;
+  double buy_volume;  /**< volume of buyer-initiated trades */
+  double sell_volume; /**< volume of seller-initiated trades */
+  double imbalance;   /**< (buy - sell) / (buy + sell), NAN without sided volume */
+  double buy_vwap;    /**< VWAP of buyer-initiated trades, NAN if none */
+  double sell_vwap;   /**< VWAP of seller-initiated trades, NAN if none */
+} trade_flow;
+
+/**
+ * @brief An open/high/low/close/volume bar of one symbol.
+ */
+typedef struct
+{
+  int64_t start_ms;       /**< bar open time (aligned to minute) */
+  int interval_minutes;   /**< bar length in minutes */
+  double open, high, low, close; /**< NAN until the bar (or an earlier one) has a trade */
+  double volume;          /**< sum of trade sizes */
+  double notional;        /**< sum of price * size (VWAP = notional / volume) */
+  uint32_t trade_count;   /**< number of trades in the bar */
+} ohlcv_bar;
+
+/**
+ * @brief Rotation policy for long-lived append-only output files.
+ */
+typedef enum
+{
+  ROTATE_NONE = 0, /**< never rotate */
+  ROTATE_HOURLY,   /**< new segment at every UTC hour boundary */
+  ROTATE_DAILY,    /**< new segment at every UTC midnight */
+  ROTATE_SIZE      /**< new segment once the configured size limit is reached */
+} rotate_policy;
+
+/**
+ * @brief Subsystems whose memory is accounted against the budget (see mem_budget.h).
+ */
+typedef enum
+{
+  MEM_QUEUE = 0,   /**< raw trade queue */
+  MEM_WINDOWS,     /**< window chunk pool, min/max deques, quantile sets and volume profiles */
+  MEM_HISTORY,     /**< VWAP matrix and 1-minute bars */
+  MEM_CORRELATION, /**< correlation search buffers */
+  MEM_ALERTS,      /**< compiled alert rules */
+  MEM_WRITERS,     /**< mapped trade log segments and the compressor's buffer */
+  MEM_IPC,         /**< shared-memory channel mapping */
+  NUM_MEM_SUBSYSTEMS
+} mem_subsystem;
+
+/**
+ * @brief One immutable generation of the runtime configuration.
+ * @details Published by pointer swap and never modified afterwards; a reload builds a
+ * new generation and swaps it in (see runtime_config.h).
+ */
+struct runtime_config
+{
+  uint64_t generation;                        /**< 1 at startup, +1 per published change */
+  char symbols[NUM_SYMBOLS][SYMBOL_NAME_MAX]; /**< instrument of each slot, "" if the slot is free */
+  int num_symbols;                            /**< occupied slots */
+  rotate_policy trade_log_rotate;             /**< roll-over of data/trades/<SYMBOL> segments */
+  rotate_policy latency_log_rotate;           /**< rotation of the latency log */
+  int64_t rotate_max_bytes;                   /**< segment size limit of ROTATE_SIZE */
+  int retain_segments;                        /**< closed segments kept per stream (0 = all) */
+  int fsync_per_write;                        /**< fsync/msync after every write */
+  int shutdown_budget_ms;                     /**< time allowed for draining and flushing at shutdown */
+  int memory_budget_mb;                       /**< ceiling of the accounted memory (0 = none) */
+  const struct runtime_config *previous;      /**< older generation (kept until exit) */
+};
+typedef struct runtime_config runtime_config;
 
 /* ============================================================================
  * DATA STRUCTURE DEFINITIONS
  * ============================================================================ */
 
+/**
+ * @brief An append-only log file that is rotated into closed segments by its writer thread.
+ */
+struct rotating_log
+{
+  int fd;                /**< active file descriptor (-1 if closed) */
+  char dir[64];          /**< output directory */
+  char name[32];         /**< base file name (e.g., "BTC-USDT") */
+  char ext[8];           /**< file extension (e.g., "jsonl") */
+  const char *header;    /**< header written at the top of every new segment (may be NULL) */
+  rotate_policy policy;  /**< rotation policy */
+  int64_t period_start_ms; /**< start of the current segment */
+  int64_t period_end_ms;   /**< time at which the active segment must be closed */
+  int64_t bytes_written;   /**< bytes in the active segment */
+};
+typedef struct rotating_log rotating_log;
+
+/**
+ * @brief A segment the writer has replaced, waiting for the sync thread to finalize it.
+ */
+typedef struct
+{
+  int fd;
+  char *map;
+  size_t used;
+  char path[256];
+} segment_retiree;
+
+/**
+ * @brief An append-only log written through a memory mapping of preallocated segment files.
+ * @details Only the writer thread touches `map` contents and `used`; the sync thread
+ * flushes the published range and finalizes (msync, unmap, truncate) the segments the
+ * writer has retired. If it falls TRADE_SEGMENT_RETIRED_MAX segments behind, the writer
+ * finalizes the oldest retired segment itself instead of waiting, skipping the one whose
+ * mapping the sync thread is flushing so that mapping stays valid.
+ */
+struct segment_log
+{
+  int fd;                 /**< active segment file descriptor (-1 if closed) */
+  char *map;              /**< shared mapping of the active segment */
+  size_t capacity;        /**< preallocated segment size */
+  size_t used;            /**< published bytes (written by the writer, read atomically) */
+  size_t synced;          /**< bytes already flushed by msync (sync thread only) */
+  char path[256];         /**< active segment path */
+  char dir[64];           /**< output directory */
+  char name[32];          /**< base file name (e.g., "BTC-USDT") */
+  char ext[8];            /**< file extension (e.g., "jsonl") */
+  rotate_policy policy;   /**< time-based roll-over policy */
+  int64_t period_end_ms;  /**< time at which the active segment is rolled over */
+  int index_fd;           /**< minute index of the active segment (-1 if unavailable) */
+  int64_t last_index_minute_ms; /**< last minute written to the index */
+  segment_retiree retired[TRADE_SEGMENT_RETIRED_MAX]; /**< segments handed over for finalization, oldest first */
+  int num_retired;
+  char *flushing;         /**< mapping the sync thread is flushing outside the lock (NULL if none) */
+  uint64_t writer_finalized; /**< retired segments the writer finalized itself (sync thread behind) */
+  pthread_mutex_t lock;   /**< protects the active/retired hand-over with the sync thread */
+};
+typedef struct segment_log segment_log;
+
 /**
  * @brief A thread-safe, bounded, circular queue for raw trade messages.
  */
@@ -125,62 +335,272 @@ struct raw_trade_queue
   uint32_t head_idx, tail_idx;
   pthread_mutex_t lock;          /**< mutex for thread safety (producer-consumer) */
   pthread_cond_t cond_not_empty; /**< condition variable to signal non-empty queue */
+  int closed;                    /**< no more pushes expected: pop returns 0 once empty */
 };
 typedef struct raw_trade_queue raw_trade_queue;
 
+/**
+ * @brief A list of window sequence numbers whose prices are monotonic (for O(1) window min/max).
+ * @details Linked through the prev/next fields of the window's trades, so it lives in the
+ * pooled chunks and needs no storage of its own.
+ */
+typedef struct
+{
+  uint32_t front; /**< oldest sequence number held */
+  uint32_t back;  /**< newest sequence number held */
+  uint32_t size;  /**< number of sequence numbers held */
+  int link;       /**< which prev/next pair of the trades it uses (0 max, 1 min) */
+} monotonic_deque;
+
+/**
+ * @brief Window volume by price bucket, direct-mapped on bucket id modulo the slot count.
+ */
+typedef struct
+{
+  double *volume;        /**< volume per slot */
+  int64_t *bucket_id;    /**< bucket id (floor(price / bucket_width)) held by each slot */
+  uint32_t *trades;      /**< trades per slot (volume is reset to 0 when it reaches 0) */
+  uint32_t num_slots;    /**< number of slots */
+  double bucket_width;   /**< price width of a bucket (set from the first trade) */
+  uint64_t collisions;   /**< adds that hit a slot held by another bucket (span too wide) */
+} volume_profile;
+
 /**
  * @brief A circular buffer for a sliding window of trades, with running sums for O(1) VWAP calculation.
  */
 struct sliding_window
 {
-  processed_trade *buffer; /**< pre-allocated circular buffer */
-  uint32_t capacity;      /**< buffer size (e.g., 20000) */
-  uint32_t head_idx;          /**< oldest valid entry */
-  uint32_t tail_idx;          /**< next insertion point */
+  processed_trade *chunks[WINDOW_MAX_CHUNKS]; /**< sparse ring of WINDOW_CAPACITY trades, NULL where no trade is held */
+  processed_trade *spare[WINDOW_SPARE_CHUNKS]; /**< empty chunks kept for reuse (stack) */
+  struct chunk_pool *pool;    /**< where chunks come from and return to */
+  uint32_t num_chunks;        /**< chunks in the ring */
+  uint32_t num_spare;         /**< chunks on the spare stack */
+  uint32_t head_seq;          /**< sequence number of the oldest entry (mod 2^32) */
   uint32_t size;              /**< number of valid entries */
+  uint32_t peak_size;         /**< highest size since the last trim */
+  uint32_t minute_peaks[WINDOW_MINUTES]; /**< peak size of each of the last minutes (trim history) */
+  uint32_t minute_cursor;     /**< next minute_peaks entry */
+  uint64_t forced_evictions;  /**< trades lost while still inside WINDOW_MS (window full or pool empty) */
+  uint64_t chunk_allocs;      /**< chunks taken from the pool (spare stack empty) */
   double sum_price_volume;    /**< running sum of price * size */
   double sum_volume;          /**< running sum of size */
+  double sum_buy_notional;    /**< running sum of price * size over buys */
+  double sum_buy_volume;      /**< running sum of size over buys */
+  double sum_sell_notional;   /**< running sum of price * size over sells */
+  double sum_sell_volume;     /**< running sum of size over sells */
+  double sum_sq_log_return;   /**< running sum of squared trade log-returns (realized variance) */
+  double last_price;          /**< price of the latest trade, base of the next log-return */
+  struct quantile_set *price_quantiles; /**< order statistics of trade prices in the window */
+  struct quantile_set *size_quantiles;  /**< order statistics of trade sizes in the window */
+  monotonic_deque max_deque;  /**< indices with decreasing prices (front = window high) */
+  monotonic_deque min_deque;  /**< indices with increasing prices (front = window low) */
+  volume_profile profile;     /**< volume by price bucket */
+  double sum_price_time;      /**< running integral of the last price over time (price * ms) */
+  double sum_time;            /**< running length of that integral (ms) */
   pthread_mutex_t lock;
 };
 typedef struct sliding_window sliding_window;
 
 /**
- * @brief A circular buffer to store the history of per-minute VWAP and volume data points.
+ * @brief Occupancy and memory of a sliding window.
+ */
+typedef struct
+{
+  uint32_t trades;           /**< trades in the window */
+  uint32_t peak_trades;      /**< peak occupancy over the last WINDOW_MINUTES */
+  uint32_t capacity_trades;  /**< trades the chunks held by the window fit (in use and spare) */
+  size_t memory_bytes;       /**< chunks (trades and min/max deque links) and quantile nodes held */
+  uint64_t forced_evictions; /**< trades lost before expiring (window full or pool empty) */
+  uint64_t chunk_allocs;     /**< chunks taken from the pool so far */
+  uint32_t pool_free_chunks; /**< chunks left in the shared pool */
+} window_occupancy;
+
+/**
+ * @brief Window quantiles of trade price and size.
  */
-struct vwap_history
+typedef struct
 {
-  vwap_point *buffer;
+  double price_p50; /**< median trade price */
+  double size_p50;  /**< median trade size */
+  double size_p90;  /**< 90th percentile trade size */
+  double size_p99;  /**< 99th percentile trade size */
+} window_quantiles;
+
+/**
+ * @brief Price range of a sliding window.
+ */
+typedef struct
+{
+  double high;       /**< highest trade price in the window */
+  double low;        /**< lowest trade price in the window */
+  double last_price; /**< latest trade price */
+} window_range;
+
+/**
+ * @brief Time-weighted price and volume profile of a sliding window.
+ */
+typedef struct
+{
+  double twap;            /**< last price integrated over time between the window's trades */
+  double poc;             /**< point of control: center of the bucket with the most volume */
+  double value_area_low;  /**< lower bound of the value area */
+  double value_area_high; /**< upper bound of the value area */
+} window_profile;
+
+/**
+ * @brief Time-major history of every symbol's per-minute VWAP.
+ * @details Row r holds one minute: a single timestamp and the VWAPs of all symbols side by
+ * side. Each row is written twice, at its ring index and `capacity` rows further, so the
+ * newest n rows always form one contiguous block (no wrap, no copy).
+ */
+struct vwap_matrix
+{
+  double *vwap;          /**< mirrored rows, 2 * capacity x width */
+  int64_t *minute_ts_ms; /**< mirrored row timestamps, 2 * capacity */
+  int width;             /**< symbols per row */
   int capacity;
-  int head_idx;  /**< oldest entry index */
+  int head_idx;  /**< oldest row index */
   int tail_idx;  /**< next insertion point */
-  int size;      /**< current number of entries */
+  int size;      /**< current number of rows */
+  pthread_mutex_t lock;
+};
+typedef struct vwap_matrix vwap_matrix;
+
+/**
+ * @brief Per-symbol OHLCV bar builder with a ring of closed 1-minute bars.
+ * @details The trade processor updates `current` in O(1) per trade; the per-minute
+ * worker closes it into the ring and aggregates the longer intervals from there.
+ */
+struct bar_builder
+{
+  ohlcv_bar current;  /**< bar being built since the last minute close */
+  double last_close;  /**< close of the latest bar with trades (NAN if none yet) */
+  ohlcv_bar *buffer;  /**< ring of closed 1-minute bars */
+  int capacity;
+  int head_idx;       /**< oldest entry index */
+  int tail_idx;       /**< next insertion point */
+  int size;           /**< current number of entries */
   pthread_mutex_t lock;
 };
-typedef struct vwap_history vwap_history;
+typedef struct bar_builder bar_builder;
+
+/**
+ * @brief Volatility estimates of one symbol, as variances over the WINDOW_MINUTES horizon.
+ */
+typedef struct
+{
+  double realized_var;     /**< sum of squared trade log-returns in the window */
+  double parkinson_var;    /**< sum of per-minute Parkinson (high/low) variances */
+  double garman_klass_var; /**< sum of per-minute Garman-Klass (OHLC) variances */
+  double ewma_var;         /**< EWMA of squared 1-minute close returns, scaled to the window */
+} volatility_estimate;
+
+/**
+ * @brief Per-minute volatility state, updated from closed 1-minute bars by the VWAP worker only.
+ */
+struct volatility_state
+{
+  double parkinson[WINDOW_MINUTES];    /**< ring of per-minute Parkinson variances */
+  double garman_klass[WINDOW_MINUTES]; /**< ring of per-minute Garman-Klass variances */
+  int next_idx;                        /**< next ring slot */
+  int size;                            /**< number of filled slots */
+  double sum_parkinson;                /**< running sum over the ring */
+  double sum_garman_klass;             /**< running sum over the ring */
+  double ewma_var;                     /**< per-minute EWMA variance (NAN until the first return) */
+  double prev_close;                   /**< previous 1-minute close */
+};
+typedef struct volatility_state volatility_state;
+
+/**
+ * @brief Per-symbol values published each tick for the alert rules.
+ */
+typedef enum
+{
+  ALERT_METRIC_VWAP,           /**< window VWAP */
+  ALERT_METRIC_VWAP_CHANGE_BP, /**< VWAP change since the previous tick, in basis points */
+  ALERT_METRIC_CORRELATION,    /**< best lagged correlation found this tick */
+  ALERT_METRIC_IMBALANCE,      /**< buy/sell order-flow imbalance */
+  ALERT_METRIC_REALIZED_VOL,   /**< realized volatility over the window */
+  ALERT_METRIC_RANGE_BPS,      /**< window high-low range, in basis points */
+  NUM_ALERT_METRICS
+} alert_metric;
+
+/**
+ * @brief One compiled alert rule: a threshold test on one metric slot with hysteresis.
+ * @details Comparisons are normalized so that the rule fires when `sign * value`
+ * (or its absolute value) rises above `fire_above` and re-arms when it falls to
+ * `clear_below` or lower.
+ */
+typedef struct
+{
+  uint32_t slot;          /**< symbol * NUM_ALERT_METRICS + metric */
+  uint8_t use_abs;        /**< compare |value| */
+  uint8_t active;         /**< fired and not yet cleared */
+  uint16_t cooldown_min;  /**< minimum minutes between two fires */
+  double sign;            /**< 1 for '>' and 'abs>', -1 for '<' */
+  double fire_above;      /**< sign * threshold */
+  double clear_below;     /**< sign * clear level */
+  int64_t last_fired_ms;  /**< tick of the last fire */
+  uint32_t rule;          /**< index of the source rule (name, metric, op) */
+} alert_instr;
+
+/**
+ * @brief Source form of a rule, kept for the alert messages.
+ */
+typedef struct
+{
+  char name[48];
+  char op[8];
+  alert_metric metric;
+  double threshold;
+  int line_no;      /**< line of the rule file */
+  int merged_tests; /**< tests merged into an earlier rule's identical test */
+} alert_rule;
 
 /**
  * @brief A consolidated data structure holding all real-time and historical data for a single symbol.
  */
 struct symbol_data
 {
-  const char *symbol;       /**< symbol name (e.g., "BTC-USDT") */
+  char symbol[SYMBOL_NAME_MAX];   /**< symbol name (e.g., "BTC-USDT"), "" while the slot is free */
   sliding_window trade_window;    /**< sliding window for trades */
-  vwap_history vwap_hist;         /**< moving average history */
-  int trade_log_fd;               /**< file descriptor for trade log */
+  bar_builder bars;               /**< OHLCV bars */
+  volatility_state vol;           /**< volatility estimators */
+  segment_log trade_log;          /**< memory-mapped trade log */
+  uint64_t trades;                /**< trades processed since the slot was assigned (slot writer only) */
+  int64_t last_trade_ts_ms;       /**< exchange timestamp of the newest processed trade */
 };
 typedef struct symbol_data symbol_data;
 
+/**
+ * @brief Outcome of a graceful shutdown, reported on stdout and in the checkpoint file.
+ */
+typedef struct
+{
+  const char *role;           /**< "all", "ingest" or "analytics" */
+  int64_t requested_ms;       /**< wall-clock time of the termination signal */
+  int64_t finished_ms;        /**< wall-clock time the outputs were flushed */
+  int budget_ms;              /**< time budget in effect */
+  uint32_t queued;            /**< trades in the queue when ingestion stopped */
+  uint32_t abandoned;         /**< trades still queued when the budget ran out */
+  int budget_exceeded;        /**< nonzero if some step was cut short */
+} shutdown_report;
+
 /* Global data arrays */
 extern symbol_data symbols[NUM_SYMBOLS];
+extern vwap_matrix vwap_hist; /**< per-minute VWAPs of all symbols, appended by the VWAP worker */
 extern raw_trade_queue raw_queue;
-extern int latency_log_fd;
+extern rotating_log latency_log;
+extern shm_channel *trade_channel; /**< shared-memory channel in the ingest/analytics roles, NULL in one process */
 
 /* Worker thread synchronization */
 extern pthread_t vwap_worker_thread;
 extern pthread_t correlation_worker_thread;
 extern pthread_barrier_t compute_start_barrier;
 extern pthread_barrier_t compute_done_barrier;
+extern pthread_mutex_t compute_lock; /**< Held by the scheduler for each tick; a config reload takes it to resize */
 extern int64_t current_minute_ms;
+extern double minute_metrics[NUM_SYMBOLS][NUM_ALERT_METRICS]; /**< Published by the workers before the done barrier */
 
 /* WebSocket globals */
 extern struct lws_context *lws_context;
@@ -11,6 +11,7 @@ real-time cryptocurrency trading system, providing insights into:
 - Cross-cryptocurrency price correlation analysis
 """
 
+import gzip
 import json
 from pathlib import Path
 import pandas as pd
@@ -22,6 +23,17 @@ import seaborn as sns
 plt.style.use('seaborn-v0_8')
 sns.set_palette("husl")
 
+# Binary latency log format (mirrors src/logging/latency_record.h)
+LATENCY_LOG_MAGIC = b'OKXLAT1\n'
+LATENCY_REBASE_SYMBOL = 0xFFFF
+LATENCY_RECORD_DTYPE = np.dtype([
+    ('exchange_delta_ms', '<i4'),
+    ('network_latency_ms', '<i4'),
+    ('processing_latency_ms', '<i4'),
+    ('symbol_index', '<u2'),
+    ('reserved', '<u2'),
+])
+
 class CryptocurrencyTradingSystemVisualizer:
     """
     Comprehensive visualization and analysis tool for cryptocurrency trading system metrics.
@@ -157,6 +169,39 @@ class CryptocurrencyTradingSystemVisualizer:
         )
         plt.close()
 
+    def _log_segment_files(self, directory, name, extension):
+        """
+        List the closed (possibly gzipped) segments of a rotated log followed by its active file.
+
+        Args:
+            directory (Path): Directory containing the log
+            name (str): Base file name (e.g. 'latency')
+            extension (str): File extension without the dot (e.g. 'csv')
+
+        Returns:
+            list: Existing segment paths in chronological order
+        """
+        segment_files = sorted(directory.glob(f'{name}.*.{extension}*'))
+        active_file = directory / f'{name}.{extension}'
+        if active_file.exists():
+            segment_files.append(active_file)
+        return segment_files
+
+    def _load_report(self, filename):
+        """
+        Load an aggregate CSV written by the native report tool (tools/report.c).
+
+        Args:
+            filename (str): Report file name inside <data>/reports
+
+        Returns:
+            pandas.DataFrame or None: Report contents, or None if it has not been generated
+        """
+        report_file_path = self.data_directory / 'reports' / filename
+        if not report_file_path.exists():
+            return None
+        return pd.read_csv(report_file_path)
+
     def load_scheduler_performance_data(self):
         """
         Load and preprocess scheduler performance metrics from CSV file.
@@ -184,21 +229,78 @@ class CryptocurrencyTradingSystemVisualizer:
             print(f"Error loading scheduler performance data: {error}")
             return None
     
+    def _read_binary_latency_segment(self, file_path):
+        """
+        Decode a binary latency segment (see src/logging/latency_record.h).
+
+        Args:
+            file_path (Path): Segment path, possibly gzipped
+
+        Returns:
+            pandas.DataFrame or None: Columns symbol_index, exchange_ts_ms,
+                                    network_latency_ms and processing_latency_ms
+        """
+        opener = gzip.open if file_path.suffix == '.gz' else open
+        with opener(file_path, 'rb') as segment_file:
+            raw_bytes = segment_file.read()
+
+        if raw_bytes[:len(LATENCY_LOG_MAGIC)] != LATENCY_LOG_MAGIC:
+            print(f"Warning: {file_path} is not a binary latency log")
+            return None
+
+        record_count = (len(raw_bytes) - len(LATENCY_LOG_MAGIC)) // LATENCY_RECORD_DTYPE.itemsize
+        records = np.frombuffer(raw_bytes, dtype=LATENCY_RECORD_DTYPE,
+                                offset=len(LATENCY_LOG_MAGIC), count=record_count)
+
+        # Rebase records carry an absolute exchange timestamp; other records a delta
+        rebase_mask = records['symbol_index'] == LATENCY_REBASE_SYMBOL
+        rebase_positions = np.flatnonzero(rebase_mask)
+        rebase_timestamps = (
+            (records['network_latency_ms'][rebase_positions].astype(np.int64) << 32) |
+            (records['processing_latency_ms'][rebase_positions].astype(np.int64) & 0xFFFFFFFF)
+        )
+
+        cumulative_delta = np.cumsum(records['exchange_delta_ms'].astype(np.int64))
+        rebase_group = np.cumsum(rebase_mask) - 1
+        sample_mask = ~rebase_mask & (rebase_group >= 0)
+        sample_group = rebase_group[sample_mask]
+        exchange_timestamps = (
+            rebase_timestamps[sample_group] +
+            cumulative_delta[sample_mask] - cumulative_delta[rebase_positions[sample_group]]
+        )
+
+        return pd.DataFrame({
+            'symbol_index': records['symbol_index'][sample_mask].astype(np.int64),
+            'exchange_ts_ms': exchange_timestamps,
+            'network_latency_ms': records['network_latency_ms'][sample_mask].astype(np.int64),
+            'processing_latency_ms': records['processing_latency_ms'][sample_mask].astype(np.int64),
+        })
+
     def load_latency_performance_data(self):
         """
-        Load and preprocess network and processing latency metrics from CSV file.
+        Load and preprocess network and processing latency metrics from the
+        binary (latency.bin) or CSV (latency.csv) log segments.
         
         Returns:
             pandas.DataFrame or None: DataFrame containing latency measurements with
                                     symbol mapping and datetime conversion, or None if file not found
         """
         try:
-            latency_file_path = self.data_directory / 'performance' / 'latency.csv'
-            if not latency_file_path.exists():
-                print(f"Warning: Latency data file not found at {latency_file_path}")
+            performance_directory = self.data_directory / 'performance'
+            latency_frames = [
+                self._read_binary_latency_segment(file_path)
+                for file_path in self._log_segment_files(performance_directory, 'latency', 'bin')
+            ]
+            latency_frames += [
+                pd.read_csv(file_path)
+                for file_path in self._log_segment_files(performance_directory, 'latency', 'csv')
+            ]
+            latency_frames = [frame for frame in latency_frames if frame is not None]
+            if not latency_frames:
+                print(f"Warning: Latency data file not found at {performance_directory / 'latency.bin'}")
                 return None
                 
-            latency_dataframe = pd.read_csv(latency_file_path)
+            latency_dataframe = pd.concat(latency_frames, ignore_index=True)
             
             # Convert exchange timestamp to datetime for time-series analysis
             latency_dataframe['exchange_datetime'] = pd.to_datetime(
@@ -266,9 +368,9 @@ class CryptocurrencyTradingSystemVisualizer:
         # Process JSONL files for each supported trading symbol
         for trading_symbol in self.supported_trading_symbols:
             try:
-                trade_log_file = trading_directory / f'{trading_symbol}.jsonl'
-                if trade_log_file.exists():
-                    with open(trade_log_file, 'r') as file_handle:
+                for trade_log_file in self._log_segment_files(trading_directory, trading_symbol, 'jsonl'):
+                    open_log = gzip.open if trade_log_file.suffix == '.gz' else open
+                    with open_log(trade_log_file, 'rt') as file_handle:
                         for line_content in file_handle:
                             try:
                                 trade_message = json.loads(line_content.strip())
@@ -413,35 +515,47 @@ class CryptocurrencyTradingSystemVisualizer:
         Data is aggregated by hour and outliers are filtered for cleaner visualization.
         Includes comprehensive performance statistics and trend analysis.
         """
-        latency_performance_data = self.load_latency_performance_data()
-        if latency_performance_data is None or len(latency_performance_data) == 0:
-            print("No latency performance data available for visualization")
-            return
-
-        # Calculate total latency for outlier detection and filtering
-        latency_performance_data['total_latency_ms'] = (
-            latency_performance_data['network_latency_ms'] +
-            latency_performance_data['processing_latency_ms']
-        )
-
-        # Remove extreme outliers (top 0.1%) to improve visualization clarity
-        outlier_exclusion_threshold = latency_performance_data['total_latency_ms'].quantile(0.999)
-        original_sample_count = len(latency_performance_data)
-        filtered_latency_data = latency_performance_data[
-            latency_performance_data['total_latency_ms'] <= outlier_exclusion_threshold
-        ]
-        filtered_sample_count = len(filtered_latency_data)
-
-        print(f"   Filtered {original_sample_count - filtered_sample_count} extreme outliers "
-              f"(top 0.1%) from {original_sample_count:,} data points")
+        hourly_latency_aggregation = self._load_report('latency_hourly.csv')
+        latency_summary_report = self._load_report('latency_summary.csv')
+
+        if hourly_latency_aggregation is not None and latency_summary_report is not None:
+            # Hourly means already filtered and aggregated by the report tool
+            original_sample_count = int(latency_summary_report['samples'].iloc[0])
+            print(f"   Filtered {int(latency_summary_report['filtered'].iloc[0])} extreme outliers "
+                  f"(top 0.1%) from {original_sample_count:,} data points (from report)")
+            hourly_latency_aggregation['hourly_timestamp'] = pd.to_datetime(
+                hourly_latency_aggregation['hour_ts_ms'], unit='ms'
+            )
+        else:
+            latency_performance_data = self.load_latency_performance_data()
+            if latency_performance_data is None or len(latency_performance_data) == 0:
+                print("No latency performance data available for visualization")
+                return
+
+            # Calculate total latency for outlier detection and filtering
+            latency_performance_data['total_latency_ms'] = (
+                latency_performance_data['network_latency_ms'] +
+                latency_performance_data['processing_latency_ms']
+            )
 
-        # Aggregate latency measurements by hour for trend analysis
-        filtered_latency_data = filtered_latency_data.copy()
-        filtered_latency_data['hourly_timestamp'] = filtered_latency_data['exchange_datetime'].dt.floor('H')
-        hourly_latency_aggregation = filtered_latency_data.groupby('hourly_timestamp').agg({
-            'network_latency_ms': 'mean',
-            'processing_latency_ms': 'mean'
-        }).reset_index()
+            # Remove extreme outliers (top 0.1%) to improve visualization clarity
+            outlier_exclusion_threshold = latency_performance_data['total_latency_ms'].quantile(0.999)
+            original_sample_count = len(latency_performance_data)
+            filtered_latency_data = latency_performance_data[
+                latency_performance_data['total_latency_ms'] <= outlier_exclusion_threshold
+            ]
+            filtered_sample_count = len(filtered_latency_data)
+
+            print(f"   Filtered {original_sample_count - filtered_sample_count} extreme outliers "
+                  f"(top 0.1%) from {original_sample_count:,} data points")
+
+            # Aggregate latency measurements by hour for trend analysis
+            filtered_latency_data = filtered_latency_data.copy()
+            filtered_latency_data['hourly_timestamp'] = filtered_latency_data['exchange_datetime'].dt.floor('H')
+            hourly_latency_aggregation = filtered_latency_data.groupby('hourly_timestamp').agg({
+                'network_latency_ms': 'mean',
+                'processing_latency_ms': 'mean'
+            }).reset_index()
 
         # Convert datetime to hours from monitoring start for consistent x-axis
         monitoring_start_time = hourly_latency_aggregation['hourly_timestamp'].min()
@@ -649,8 +763,13 @@ class CryptocurrencyTradingSystemVisualizer:
         """
         # Load required performance data sources
         system_resource_data = self.load_system_resource_data()
-        trading_message_data = self.load_trading_message_logs()
         scheduler_performance_data = self.load_scheduler_performance_data()
+
+        # Prefer the per-minute trade counts of the report tool over parsing every trade
+        minute_throughput_report = self._load_report('throughput_minute.csv')
+        trading_message_data = (
+            self.load_trading_message_logs() if minute_throughput_report is None else minute_throughput_report
+        )
         
         if (system_resource_data is None or len(system_resource_data) == 0 or
             trading_message_data is None or len(trading_message_data) == 0 or
@@ -662,8 +781,14 @@ class CryptocurrencyTradingSystemVisualizer:
         system_resource_data['time_interval'] = system_resource_data['timestamp_datetime'].dt.floor('15T')
         cpu_usage_aggregated = system_resource_data.groupby('time_interval')['cpu_percent'].mean().reset_index()
 
-        trading_message_data['time_interval'] = trading_message_data['timestamp_datetime'].dt.floor('15T')
-        message_throughput_aggregated = trading_message_data.groupby('time_interval').size().reset_index()
+        if minute_throughput_report is not None:
+            minute_throughput_report['time_interval'] = pd.to_datetime(
+                minute_throughput_report['minute_ts_ms'], unit='ms'
+            ).dt.floor('15T')
+            message_throughput_aggregated = minute_throughput_report.groupby('time_interval')['total'].sum().reset_index()
+        else:
+            trading_message_data['time_interval'] = trading_message_data['timestamp_datetime'].dt.floor('15T')
+            message_throughput_aggregated = trading_message_data.groupby('time_interval').size().reset_index()
         message_throughput_aggregated.columns = ['time_interval', 'messages_per_interval']
 
         # Merge datasets on time interval for synchronized analysis
@@ -764,11 +889,19 @@ class CryptocurrencyTradingSystemVisualizer:
         coefficients between different cryptocurrency trading pairs, providing insights
         into market interdependencies and price movement relationships.
         """
+        # Prefer the pair frequency table of the report tool over loading every correlation row
+        correlation_frequency_report = self._load_report('correlation_frequency.csv')
+
         # Load correlation data for all supported trading symbols
         cryptocurrency_correlation_data = {}
+        if correlation_frequency_report is not None:
+            for trading_symbol, symbol_pairs in correlation_frequency_report.groupby('symbol'):
+                cryptocurrency_correlation_data[trading_symbol] = symbol_pairs.rename(
+                    columns={'mean_correlation': 'correlation'}
+                )
         for trading_symbol in self.supported_trading_symbols:
             correlation_file_path = self.data_directory / 'metrics' / 'correlations' / f'{trading_symbol}.csv'
-            if correlation_file_path.exists():
+            if correlation_frequency_report is None and correlation_file_path.exists():
                 correlation_dataframe = pd.read_csv(correlation_file_path)
                 correlation_dataframe['trading_symbol'] = trading_symbol
                 cryptocurrency_correlation_data[trading_symbol] = correlation_dataframe
@@ -796,8 +929,12 @@ class CryptocurrencyTradingSystemVisualizer:
                         correlated_symbol_index = self.supported_trading_symbols.index(correlation_record['correlated_with'])
                         
                         if not np.isnan(correlation_record['correlation']):
-                            correlation_matrix[base_symbol_index, correlated_symbol_index] += correlation_record['correlation']
-                            correlation_count_matrix[base_symbol_index, correlated_symbol_index] += 1
+                            # Report rows carry a pair's mean over `count` rows; raw rows count once
+                            record_weight = correlation_record.get('count', 1)
+                            correlation_matrix[base_symbol_index, correlated_symbol_index] += (
+                                correlation_record['correlation'] * record_weight
+                            )
+                            correlation_count_matrix[base_symbol_index, correlated_symbol_index] += record_weight
 
         # Calculate average correlations where data exists
         valid_correlation_mask = correlation_count_matrix > 0
@@ -0,0 +1,469 @@
+/**
+ * @file alert_engine.c
+ * @brief Threshold alert engine implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "alert_engine.h"
+#include "../utils/mem_budget.h"
+#include "../utils/time_utils.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* Rule states (alert_instr.active) */
+#define ALERT_IDLE 0       /**< below the threshold */
+#define ALERT_FIRED 1      /**< fired, waiting to clear */
+#define ALERT_SUPPRESSED 2 /**< crossed within the cooldown, waiting to clear silently */
+
+/** Rule-file names of the alert metrics, indexed by alert_metric. */
+static const char *ALERT_METRIC_NAMES[NUM_ALERT_METRICS] = {
+    "vwap", "vwap_change_bp", "correlation", "imbalance", "realized_vol", "range_bps"};
+
+/* Compiled program and outputs (owned by the scheduler thread after init) */
+static alert_instr *program = NULL;
+static int program_len = 0;
+static alert_rule *rules = NULL;
+static int num_rules = 0;
+static int64_t reserved_bytes = 0; /**< program and rules as counted in MEM_ALERTS */
+static int alert_fd = -1;
+static int alert_sock = -1;
+static struct sockaddr_un alert_addr;
+static double prev_vwap[NUM_SYMBOLS];
+
+/* Rule file and the slot layout it was compiled against, for alert_engine_reload */
+static char rules_path[256];
+static int rules_required;
+static char compiled_symbols[NUM_SYMBOLS][SYMBOL_NAME_MAX];
+
+/**
+ * @brief Orders instructions by metric slot (so evaluation walks the metric table forward),
+ * then by test, so identical tests become adjacent.
+ * @param a First instruction.
+ * @param b Second instruction.
+ * @return Comparison result for qsort.
+ */
+static int instr_cmp(const void *a, const void *b)
+{
+  const alert_instr *x = a, *y = b;
+  if (x->slot != y->slot)
+    return x->slot < y->slot ? -1 : 1;
+  if (x->use_abs != y->use_abs)
+    return x->use_abs < y->use_abs ? -1 : 1;
+  if (x->sign != y->sign)
+    return x->sign < y->sign ? -1 : 1;
+  if (x->fire_above != y->fire_above)
+    return x->fire_above < y->fire_above ? -1 : 1;
+  if (x->clear_below != y->clear_below)
+    return x->clear_below < y->clear_below ? -1 : 1;
+  if (x->cooldown_min != y->cooldown_min)
+    return x->cooldown_min < y->cooldown_min ? -1 : 1;
+  return x->rule < y->rule ? -1 : (x->rule > y->rule);
+}
+
+/**
+ * @brief Tells whether two instructions perform the same test.
+ * @param x First instruction.
+ * @param y Second instruction.
+ * @return 1 if slot, comparison, levels and cooldown are equal.
+ */
+static int instr_same_test(const alert_instr *x, const alert_instr *y)
+{
+  return x->slot == y->slot && x->use_abs == y->use_abs && x->sign == y->sign &&
+         x->fire_above == y->fire_above && x->clear_below == y->clear_below && x->cooldown_min == y->cooldown_min;
+}
+
+/**
+ * @brief Looks up a metric by its rule-file name.
+ * @param name Metric name.
+ * @return The metric, or -1 if unknown.
+ */
+static int metric_from_name(const char *name)
+{
+  for (int m = 0; m < NUM_ALERT_METRICS; ++m)
+    if (strcmp(name, ALERT_METRIC_NAMES[m]) == 0)
+      return m;
+  return -1;
+}
+
+/**
+ * @brief Compiles a rule file into the flat evaluation program and opens the alert outputs.
+ * @details Each non-comment line is `name metric symbol op threshold [clear [cooldown_min]]`,
+ * where metric is one of vwap, vwap_change_bp, correlation, imbalance, realized_vol,
+ * range_bps; symbol is a monitored instrument or `*` (expanded to every symbol); op is `>`, `<` or
+ * `abs>`. Invalid lines are skipped with a warning. A test is identified by slot, comparison,
+ * levels and cooldown, not by the rule's name: a rule repeating a test of an earlier line is
+ * merged into it with a warning naming both, and its alerts carry the earlier rule's name.
+ * @param path Rule file path.
+ * @param required Nonzero if a missing file is an error (explicit --alerts).
+ * @return Number of compiled rules, or -1 on error.
+ */
+int alert_engine_init(const char *path, int required)
+{
+  snprintf(rules_path, sizeof(rules_path), "%s", path);
+  rules_required = required;
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    prev_vwap[i] = NAN;
+    memcpy(compiled_symbols[i], symbols[i].symbol, SYMBOL_NAME_MAX);
+  }
+
+  FILE *fp = fopen(path, "r");
+  if (!fp)
+  {
+    if (required)
+    {
+      fprintf(stderr, "ERROR: Failed to open alert rules %s: %s\n", path, strerror(errno));
+      return -1;
+    }
+    printf("INFO: No alert rules (%s not found), alerting disabled\n", path);
+    return 0;
+  }
+
+  program = calloc(ALERT_MAX_RULES, sizeof(alert_instr));
+  rules = calloc(ALERT_MAX_RULES, sizeof(alert_rule));
+  if (!program || !rules)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate alert program for %d rules\n", ALERT_MAX_RULES);
+    fclose(fp);
+    return -1;
+  }
+  reserved_bytes = (int64_t)ALERT_MAX_RULES * (sizeof(alert_instr) + sizeof(alert_rule));
+  mem_budget_add(MEM_ALERTS, reserved_bytes);
+
+  char line[512];
+  int line_no = 0, duplicates = 0;
+  while (fgets(line, sizeof(line), fp))
+  {
+    line_no++;
+    char *hash = strchr(line, '#');
+    if (hash)
+      *hash = '\0';
+
+    char name[48], metric_name[32], symbol[32], op[8];
+    double threshold, clear;
+    int cooldown = 0;
+    int n = sscanf(line, "%47s %31s %31s %7s %lf %lf %d", name, metric_name, symbol, op, &threshold, &clear, &cooldown);
+    if (n <= 0)
+      continue; // blank or comment
+    if (n < 5)
+    {
+      fprintf(stderr, "WARNING: %s:%d: expected 'name metric symbol op threshold [clear [cooldown]]'\n", path, line_no);
+      continue;
+    }
+    if (n < 6)
+      clear = threshold;
+
+    int metric = metric_from_name(metric_name);
+    if (metric < 0)
+    {
+      fprintf(stderr, "WARNING: %s:%d: unknown metric '%s'\n", path, line_no, metric_name);
+      continue;
+    }
+
+    alert_instr in;
+    memset(&in, 0, sizeof(in));
+    if (strcmp(op, ">") == 0)
+      in.sign = 1.0;
+    else if (strcmp(op, "<") == 0)
+      in.sign = -1.0;
+    else if (strcmp(op, "abs>") == 0)
+    {
+      in.sign = 1.0;
+      in.use_abs = 1;
+    }
+    else
+    {
+      fprintf(stderr, "WARNING: %s:%d: unknown operator '%s' (use >, < or abs>)\n", path, line_no, op);
+      continue;
+    }
+
+    in.fire_above = in.sign * threshold;
+    in.clear_below = in.sign * clear;
+    if (in.clear_below > in.fire_above)
+    {
+      fprintf(stderr, "WARNING: %s:%d: clear level %g is past the threshold %g\n", path, line_no, clear, threshold);
+      continue;
+    }
+    in.cooldown_min = (uint16_t)(cooldown < 0 ? 0 : cooldown > UINT16_MAX ? UINT16_MAX : cooldown);
+    in.last_fired_ms = INT64_MIN / 2;
+
+    int symbol_idx = -1; // -1: every symbol
+    int expanded = 0;
+    if (strcmp(symbol, "*") != 0)
+    {
+      for (int i = 0; i < NUM_SYMBOLS; ++i)
+        if (symbols[i].symbol[0] && strcmp(symbol, symbols[i].symbol) == 0)
+          symbol_idx = i;
+      if (symbol_idx < 0)
+      {
+        fprintf(stderr, "WARNING: %s:%d: unknown symbol '%s'\n", path, line_no, symbol);
+        continue;
+      }
+      expanded = 1;
+    }
+    else
+      for (int i = 0; i < NUM_SYMBOLS; ++i)
+        expanded += symbols[i].symbol[0] != '\0';
+
+    if (num_rules == ALERT_MAX_RULES || program_len + expanded > ALERT_MAX_RULES)
+    {
+      fprintf(stderr, "WARNING: %s:%d: more than %d tests, ignoring the rest\n", path, line_no, ALERT_MAX_RULES);
+      break;
+    }
+
+    alert_rule *r = &rules[num_rules];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    snprintf(r->op, sizeof(r->op), "%s", op);
+    r->metric = (alert_metric)metric;
+    r->threshold = threshold;
+    r->line_no = line_no;
+    r->merged_tests = 0;
+    in.rule = num_rules;
+
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+    {
+      if ((symbol_idx >= 0 && i != symbol_idx) || !symbols[i].symbol[0])
+        continue;
+      in.slot = i * NUM_ALERT_METRICS + metric;
+      program[program_len++] = in;
+    }
+    num_rules++;
+  }
+  fclose(fp);
+
+  /* sort by slot and drop tests that an earlier rule already performs (names are not compared) */
+  qsort(program, program_len, sizeof(alert_instr), instr_cmp);
+  int kept = 0;
+  for (int k = 0; k < program_len; ++k)
+  {
+    if (kept > 0 && instr_same_test(&program[kept - 1], &program[k]))
+    {
+      const alert_rule *first = &rules[program[kept - 1].rule];
+      alert_rule *dup = &rules[program[k].rule];
+      if (dup->merged_tests++ == 0) // once per rule, at its first merged test
+      {
+        if (strcmp(dup->name, first->name) == 0)
+          fprintf(stderr, "WARNING: %s:%d: rule '%s' repeats line %d, skipped\n", path, dup->line_no, dup->name,
+                  first->line_no);
+        else
+          fprintf(stderr, "WARNING: %s:%d: rule '%s' repeats the test of rule '%s' (line %d), merged: its alerts are named '%s'\n",
+                  path, dup->line_no, dup->name, first->name, first->line_no, first->name);
+      }
+      duplicates++;
+      continue;
+    }
+    program[kept++] = program[k];
+  }
+  program_len = kept;
+
+  /* outputs: append-only JSONL file and an optional local datagram socket */
+  mkdir(ALERTS_DIR, 0755);
+  alert_fd = open(ALERTS_DIR "/alerts.jsonl", O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (alert_fd < 0)
+    fprintf(stderr, "WARNING: Failed to open %s/alerts.jsonl: %s\n", ALERTS_DIR, strerror(errno));
+
+  alert_sock = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  memset(&alert_addr, 0, sizeof(alert_addr));
+  alert_addr.sun_family = AF_UNIX;
+  snprintf(alert_addr.sun_path, sizeof(alert_addr.sun_path), "%s", ALERT_SOCKET_PATH);
+
+  printf("INFO: Compiled %d alert rules into %d tests from %s (%d duplicates skipped)\n",
+         num_rules, program_len, path, duplicates);
+  return num_rules;
+}
+
+/**
+ * @brief Formats one alert and sends it to the socket; the line is also appended to `buf`.
+ * @param in The instruction that changed state.
+ * @param value The metric value.
+ * @param state "fired" or "cleared".
+ * @param iso Tick timestamp (ISO).
+ * @param buf Output buffer for the file write.
+ * @param len Current length of `buf` (updated).
+ * @param cap Capacity of `buf`.
+ */
+static void emit_alert(const alert_instr *in, double value, const char *state, const char *iso,
+                       char *buf, size_t *len, size_t cap)
+{
+  const alert_rule *r = &rules[in->rule];
+  char line[256];
+  int n = snprintf(line, sizeof(line),
+                   "{\"ts\":\"%s\",\"rule\":\"%s\",\"symbol\":\"%s\",\"metric\":\"%s\",\"op\":\"%s\","
+                   "\"threshold\":%.10g,\"value\":%.10g,\"state\":\"%s\"}\n",
+                   iso, r->name, compiled_symbols[in->slot / NUM_ALERT_METRICS], ALERT_METRIC_NAMES[r->metric], r->op,
+                   r->threshold, value, state);
+  if (n <= 0 || (size_t)n >= sizeof(line))
+    return;
+
+  if (alert_sock >= 0) // no listener (ENOENT/ECONNREFUSED) or a full queue (EAGAIN) just drops it
+    sendto(alert_sock, line, n, MSG_DONTWAIT, (const struct sockaddr *)&alert_addr, sizeof(alert_addr));
+
+  if (alert_fd >= 0 && *len + n > cap)
+  {
+    ssize_t result = write(alert_fd, buf, *len);
+    (void)result;
+    *len = 0;
+  }
+  if (*len + n <= cap)
+  {
+    memcpy(buf + *len, line, n);
+    *len += n;
+  }
+}
+
+/**
+ * @brief Evaluates every compiled rule against this tick's `minute_metrics`.
+ * @details Runs on the scheduler thread after the workers' done barrier. A rule emits
+ * one "fired" alert when it crosses its threshold and one "cleared" alert when it falls
+ * back past its clear level; alerts go to data/alerts/alerts.jsonl and, if a consumer
+ * has bound it, to ALERT_SOCKET_PATH.
+ * @param minute_ts_ms The tick's minute timestamp.
+ * @return Number of alerts emitted.
+ */
+int alert_engine_evaluate(int64_t minute_ts_ms)
+{
+  if (program_len == 0)
+    return 0;
+
+  /* derived metrics */
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    double vwap = minute_metrics[i][ALERT_METRIC_VWAP];
+    minute_metrics[i][ALERT_METRIC_VWAP_CHANGE_BP] = 1e4 * (vwap - prev_vwap[i]) / prev_vwap[i]; // NAN until two ticks
+    if (!isnan(vwap))
+      prev_vwap[i] = vwap;
+  }
+
+  const double *values = &minute_metrics[0][0];
+  static char buf[16384];
+  size_t len = 0;
+  int emitted = 0;
+  char iso[64];
+  iso[0] = '\0';
+
+  for (int k = 0; k < program_len; ++k)
+  {
+    alert_instr *in = &program[k];
+    double x = values[in->slot];
+    if (isnan(x))
+      continue;
+
+    double v = in->sign * (in->use_abs ? fabs(x) : x);
+    if (in->active == ALERT_IDLE)
+    {
+      if (v <= in->fire_above)
+        continue;
+
+      // armed again only after clearing (hysteresis); a fire within the cooldown stays silent
+      if (minute_ts_ms - in->last_fired_ms < (int64_t)in->cooldown_min * MS_PER_MINUTE)
+      {
+        in->active = ALERT_SUPPRESSED;
+        continue;
+      }
+      in->active = ALERT_FIRED;
+      in->last_fired_ms = minute_ts_ms;
+
+      if (!iso[0])
+        format_minute_iso(minute_ts_ms, iso, sizeof(iso));
+      emit_alert(in, x, "fired", iso, buf, &len, sizeof(buf));
+      emitted++;
+    }
+    else if (v <= in->clear_below)
+    {
+      int was_fired = in->active == ALERT_FIRED;
+      in->active = ALERT_IDLE;
+      if (!was_fired)
+        continue;
+      if (!iso[0])
+        format_minute_iso(minute_ts_ms, iso, sizeof(iso));
+      emit_alert(in, x, "cleared", iso, buf, &len, sizeof(buf));
+      emitted++;
+    }
+  }
+
+  if (len > 0 && alert_fd >= 0)
+  {
+    ssize_t result = write(alert_fd, buf, len);
+    if (result < 0)
+      fprintf(stderr, "WARNING: Failed to write alerts: %s\n", strerror(errno));
+  }
+
+  return emitted;
+}
+
+/**
+ * @brief Recompiles the rule file after the symbol set changed (scheduler idle).
+ * @details Tests on slots that keep their symbol carry over their state (fired,
+ * suppressed, last fire), so a reload neither repeats nor loses alerts; tests on a
+ * reassigned slot start idle.
+ * @return Number of compiled rules, or -1 on error (alerting is then disabled).
+ */
+int alert_engine_reload(void)
+{
+  alert_instr *old_program = program;
+  int old_len = program_len;
+  char old_symbols[NUM_SYMBOLS][SYMBOL_NAME_MAX];
+  double old_prev_vwap[NUM_SYMBOLS];
+  memcpy(old_symbols, compiled_symbols, sizeof(old_symbols));
+  memcpy(old_prev_vwap, prev_vwap, sizeof(old_prev_vwap));
+
+  char path[sizeof(rules_path)];
+  memcpy(path, rules_path, sizeof(path)); // alert_engine_init overwrites rules_path
+
+  program = NULL; // kept until the states are carried over
+  alert_engine_cleanup();
+  int result = alert_engine_init(path, rules_required);
+
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+    if (compiled_symbols[i][0] && strcmp(compiled_symbols[i], old_symbols[i]) == 0)
+      prev_vwap[i] = old_prev_vwap[i];
+
+  /* both programs are sorted by slot and test: merge them */
+  int j = 0;
+  for (int k = 0; k < program_len && j < old_len; ++k)
+  {
+    alert_instr *in = &program[k];
+    while (j < old_len && instr_cmp(&old_program[j], in) < 0 && !instr_same_test(&old_program[j], in))
+      j++;
+    if (j < old_len && instr_same_test(&old_program[j], in))
+    {
+      int i = in->slot / NUM_ALERT_METRICS;
+      if (strcmp(compiled_symbols[i], old_symbols[i]) == 0)
+      {
+        in->active = old_program[j].active;
+        in->last_fired_ms = old_program[j].last_fired_ms;
+      }
+    }
+  }
+  free(old_program);
+
+  if (result < 0)
+    fprintf(stderr, "WARNING: Alert rules could not be recompiled, alerting disabled\n");
+  return result;
+}
+
+/**
+ * @brief Releases the program and closes the alert outputs.
+ */
+void alert_engine_cleanup(void)
+{
+  if (alert_fd >= 0)
+  {
+    fdatasync(alert_fd);
+    close(alert_fd);
+  }
+  if (alert_sock >= 0)
+    close(alert_sock);
+  alert_fd = alert_sock = -1;
+
+  mem_budget_add(MEM_ALERTS, -reserved_bytes); // also when a reload has taken the program over
+  reserved_bytes = 0;
+  free(program);
+  free(rules);
+  program = NULL;
+  rules = NULL;
+  program_len = num_rules = 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file alert_engine.h
+ * @brief Threshold alert engine declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Compiles a rule file into the flat evaluation program and opens the alert outputs.
+ * @details Each non-comment line is `name metric symbol op threshold [clear [cooldown_min]]`,
+ * where metric is one of vwap, vwap_change_bp, correlation, imbalance, realized_vol,
+ * range_bps; symbol is a monitored instrument or `*` (expanded to every symbol); op is `>`, `<` or
+ * `abs>`. Invalid lines are skipped with a warning. A test is identified by slot, comparison,
+ * levels and cooldown, not by the rule's name: a rule repeating a test of an earlier line is
+ * merged into it with a warning naming both, and its alerts carry the earlier rule's name.
+ * @param path Rule file path.
+ * @param required Nonzero if a missing file is an error (explicit --alerts).
+ * @return Number of compiled rules, or -1 on error.
+ */
+int alert_engine_init(const char *path, int required);
+
+/**
+ * @brief Evaluates every compiled rule against this tick's `minute_metrics`.
+ * @details Runs on the scheduler thread after the workers' done barrier. A rule emits
+ * one "fired" alert when it crosses its threshold and one "cleared" alert when it falls
+ * back past its clear level; alerts go to data/alerts/alerts.jsonl and, if a consumer
+ * has bound it, to ALERT_SOCKET_PATH.
+ * @param minute_ts_ms The tick's minute timestamp.
+ * @return Number of alerts emitted.
+ */
+int alert_engine_evaluate(int64_t minute_ts_ms);
+
+/**
+ * @brief Recompiles the rule file after the symbol set changed (scheduler idle).
+ * @details Tests on slots that keep their symbol carry over their state (fired,
+ * suppressed, last fire), so a reload neither repeats nor loses alerts; tests on a
+ * reassigned slot start idle.
+ * @return Number of compiled rules, or -1 on error (alerting is then disabled).
+ */
+int alert_engine_reload(void);
+
+/**
+ * @brief Releases the program and closes the alert outputs.
+ */
+void alert_engine_cleanup(void);
+
+#endif /* ALERT_ENGINE_H */
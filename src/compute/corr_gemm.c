@@ -0,0 +1,127 @@
+/**
+ * @file corr_gemm.c
+ * @brief Blocked matrix product for the batched correlation search implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "corr_gemm.h"
+
+#include <stddef.h>
+
+#ifdef USE_BLAS
+#include <cblas.h>
+#endif
+
+/** Two doubles as a gcc generic vector (see corr_search.c). */
+typedef double corr_v2d __attribute__((vector_size(16), aligned(8), may_alias));
+
+#define GEMM_MR 4 /**< rows of C per register block (sources) */
+#define GEMM_NR 4 /**< columns of C per register block (targets): two vectors */
+
+/**
+ * @brief Computes one GEMM_MR x GEMM_NR block of C in eight vector registers.
+ * @param depth Rows of A and B.
+ * @param a First column of the block in A.
+ * @param lda Distance between rows of A.
+ * @param b First column of the block in B.
+ * @param ldb Distance between rows of B.
+ * @param c First element of the block in C.
+ * @param ldc Distance between rows of C.
+ */
+static inline void gemm_block_4x4(int depth, const double *a, int lda, const double *b, int ldb, double *c, int ldc)
+{
+  corr_v2d c00 = {0.0, 0.0}, c01 = c00, c10 = c00, c11 = c00, c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+  for (int k = 0; k < depth; ++k)
+  {
+    const double *ak = &a[(size_t)k * lda];
+    const corr_v2d *bk = (const corr_v2d *)&b[(size_t)k * ldb];
+    corr_v2d b0 = bk[0], b1 = bk[1];
+    c00 += ak[0] * b0;
+    c01 += ak[0] * b1;
+    c10 += ak[1] * b0;
+    c11 += ak[1] * b1;
+    c20 += ak[2] * b0;
+    c21 += ak[2] * b1;
+    c30 += ak[3] * b0;
+    c31 += ak[3] * b1;
+  }
+  corr_v2d *row;
+  row = (corr_v2d *)&c[0];
+  row[0] = c00;
+  row[1] = c01;
+  row = (corr_v2d *)&c[(size_t)ldc];
+  row[0] = c10;
+  row[1] = c11;
+  row = (corr_v2d *)&c[(size_t)2 * ldc];
+  row[0] = c20;
+  row[1] = c21;
+  row = (corr_v2d *)&c[(size_t)3 * ldc];
+  row[0] = c30;
+  row[1] = c31;
+}
+
+/**
+ * @brief Computes one element of C with a plain in-order dot product (block edges).
+ * @param depth Rows of A and B.
+ * @param a Column of A.
+ * @param lda Distance between rows of A.
+ * @param b Column of B.
+ * @param ldb Distance between rows of B.
+ * @return The element.
+ */
+static inline double gemm_element(int depth, const double *a, int lda, const double *b, int ldb)
+{
+  double sum = 0.0;
+  for (int k = 0; k < depth; ++k)
+    sum += a[(size_t)k * lda] * b[(size_t)k * ldb];
+  return sum;
+}
+
+/**
+ * @brief Computes C = A^T B, accumulating each element over k in order.
+ * @details Without BLAS every element is summed over k = 0..depth-1 in order, so it is
+ * bit-identical to the plain dot product of the two windows. BLAS libraries may reorder.
+ * @param m Columns of A (rows of C).
+ * @param ncols Columns of B and C.
+ * @param depth Rows of A and B (the window length).
+ * @param a A, depth x m, row-major.
+ * @param lda Distance between rows of A.
+ * @param b B, depth x ncols, row-major.
+ * @param ldb Distance between rows of B.
+ * @param c C, m x ncols, row-major.
+ * @param ldc Distance between rows of C.
+ */
+void corr_gemm_tn(int m, int ncols, int depth, const double *a, int lda, const double *b, int ldb, double *c, int ldc)
+{
+#ifdef USE_BLAS
+  cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, m, ncols, depth, 1.0, a, lda, b, ldb, 0.0, c, ldc);
+#else
+  int m_full = m - m % GEMM_MR, n_full = ncols - ncols % GEMM_NR;
+  for (int i = 0; i < m_full; i += GEMM_MR)
+  {
+    for (int j = 0; j < n_full; j += GEMM_NR)
+      gemm_block_4x4(depth, &a[i], lda, &b[j], ldb, &c[(size_t)i * ldc + j], ldc);
+    for (int r = i; r < i + GEMM_MR; ++r)
+      for (int j = n_full; j < ncols; ++j)
+        c[(size_t)r * ldc + j] = gemm_element(depth, &a[r], lda, &b[j], ldb);
+  }
+  for (int r = m_full; r < m; ++r)
+    for (int j = 0; j < ncols; ++j)
+      c[(size_t)r * ldc + j] = gemm_element(depth, &a[r], lda, &b[j], ldb);
+#endif
+}
+
+/**
+ * @brief Tells which implementation corr_gemm_tn uses.
+ * @return "blocked" or "cblas".
+ */
+const char *corr_gemm_backend(void)
+{
+#ifdef USE_BLAS
+  return "cblas";
+#else
+  return "blocked";
+#endif
+}
@@ -0,0 +1,42 @@
+/**
+ * @file corr_gemm.h
+ * @brief Blocked matrix product for the batched correlation search declarations
+ *
+ * Computes C = A^T B for the short, wide operands of the correlation search: A holds the
+ * newest window of every source symbol and B the same-lag windows of every target, both as
+ * window-length rows of the time-major VWAP matrix, so C holds the cross sums of every
+ * (source, target) pair of that lag. Consecutive lags are overlapping row ranges of the same
+ * matrix (a lag-Toeplitz target matrix that never needs to be copied). Hand-written with
+ * register blocking; built with -DUSE_BLAS the product is delegated to cblas_dgemm instead.
+ * Kept free of libwebsockets/common.h so offline tools can include it.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef CORR_GEMM_H
+#define CORR_GEMM_H
+
+/**
+ * @brief Computes C = A^T B, accumulating each element over k in order.
+ * @details Without BLAS every element is summed over k = 0..depth-1 in order, so it is
+ * bit-identical to the plain dot product of the two windows. BLAS libraries may reorder.
+ * @param m Columns of A (rows of C).
+ * @param ncols Columns of B and C.
+ * @param depth Rows of A and B (the window length).
+ * @param a A, depth x m, row-major.
+ * @param lda Distance between rows of A.
+ * @param b B, depth x ncols, row-major.
+ * @param ldb Distance between rows of B.
+ * @param c C, m x ncols, row-major.
+ * @param ldc Distance between rows of C.
+ */
+void corr_gemm_tn(int m, int ncols, int depth, const double *a, int lda, const double *b, int ldb, double *c, int ldc);
+
+/**
+ * @brief Tells which implementation corr_gemm_tn uses.
+ * @return "blocked" or "cblas".
+ */
+const char *corr_gemm_backend(void);
+
+#endif /* CORR_GEMM_H */
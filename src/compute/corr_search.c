@@ -0,0 +1,702 @@
+/**
+ * @file corr_search.c
+ * @brief Lagged correlation search over a time-major VWAP matrix implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "corr_search.h"
+#include "corr_gemm.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Added to every bound: covers the float signatures and the rounding of the exact formula. */
+#define CORR_BOUND_SLACK 1e-5
+
+/** Windows flatter than this (variance relative to mean squared) are never pruned: the
+ * exact formula loses too many digits there for the bound to be trusted against it. */
+#define CORR_SCREEN_MIN_REL_VAR 1e-9
+
+/**
+ * @brief Computes the Pearson correlation coefficient between two data series.
+ * @param x Pointer to the first data array.
+ * @param y Pointer to the second data array.
+ * @param n The number of points in each array.
+ * @return The correlation coefficient, or NAN if the denominator is zero.
+ */
+double pearson_correlation(const double *x, const double *y, int n)
+{
+  double sum_x = 0, sum_y = 0, sum_xx = 0, sum_yy = 0, sum_xy = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    sum_x += x[i];
+    sum_y += y[i];
+    sum_xx += x[i] * x[i];
+    sum_yy += y[i] * y[i];
+    sum_xy += x[i] * y[i];
+  }
+  double numerator = n * sum_xy - sum_x * sum_y;
+  double denominator = sqrt((n * sum_xx - sum_x * sum_x) * (n * sum_yy - sum_y * sum_y));
+  if (denominator == 0)
+    return NAN;
+  return numerator / denominator;
+}
+
+/** Two doubles as a gcc generic vector: SSE2/NEON registers where available, scalar pairs
+ * otherwise (ARMv6 VFP). Unaligned and allowed to alias double. */
+typedef double corr_v2d __attribute__((vector_size(16), aligned(8), may_alias));
+
+#define CORR_BLOCK 8 /**< targets per register block: four two-lane accumulators */
+
+/** Unrolls the loop over the window: completely when the specialized kernels inline a constant length. */
+#define CORR_UNROLL _Pragma("GCC unroll 32")
+
+/**
+ * @brief Cross sums of every target, CORR_BLOCK targets at a time with the sums kept in registers.
+ * @details Each target's sum is still accumulated over the window in order, so the result is
+ * bit-identical to the plain loop. Inlined with a constant `n` by the specialized kernels.
+ * @param x Source window.
+ * @param y First row of the target windows.
+ * @param n Window length.
+ * @param w Symbols per row.
+ * @param sum_xy Output, one cross sum per target.
+ */
+static inline __attribute__((always_inline)) void corr_cross_sums_body(const double *x, const double *y, int n,
+                                                                       int w, double *sum_xy)
+{
+  int j = 0;
+  for (; j + CORR_BLOCK <= w; j += CORR_BLOCK)
+  {
+    corr_v2d a0 = {0.0, 0.0}, a1 = a0, a2 = a0, a3 = a0;
+    CORR_UNROLL
+    for (int k = 0; k < n; ++k)
+    {
+      const corr_v2d *row = (const corr_v2d *)&y[(size_t)k * w + j];
+      a0 += x[k] * row[0];
+      a1 += x[k] * row[1];
+      a2 += x[k] * row[2];
+      a3 += x[k] * row[3];
+    }
+    corr_v2d *out = (corr_v2d *)&sum_xy[j];
+    out[0] = a0;
+    out[1] = a1;
+    out[2] = a2;
+    out[3] = a3;
+  }
+  for (; j < w; ++j)
+  {
+    double a = 0.0;
+    for (int k = 0; k < n; ++k)
+      a += x[k] * y[(size_t)k * w + j];
+    sum_xy[j] = a;
+  }
+}
+
+/**
+ * @brief Cross sum of one target window, in order.
+ * @param x Source window.
+ * @param y First point of the target window.
+ * @param n Window length.
+ * @param stride Distance between consecutive target points.
+ * @return The cross sum.
+ */
+static inline __attribute__((always_inline)) double corr_dot_body(const double *x, const double *y, int n, int stride)
+{
+  double sum_xy = 0.0;
+  CORR_UNROLL
+  for (int k = 0; k < n; ++k)
+    sum_xy += x[k] * y[(size_t)k * stride];
+  return sum_xy;
+}
+
+/** Generic kernels: any window length. */
+static void corr_cross_sums_generic(const double *x, const double *y, int n, int w, double *sum_xy)
+{
+  corr_cross_sums_body(x, y, n, w, sum_xy);
+}
+
+static double corr_dot_generic(const double *x, const double *y, int n, int stride)
+{
+  return corr_dot_body(x, y, n, stride);
+}
+
+/** Defines the kernels of window length N: the loops over the window are fully unrolled. */
+#define CORR_DEFINE_KERNELS(N)                                                                    \
+  static void corr_cross_sums_##N(const double *x, const double *y, int n, int w, double *sum_xy) \
+  {                                                                                               \
+    (void)n;                                                                                      \
+    corr_cross_sums_body(x, y, N, w, sum_xy);                                                     \
+  }                                                                                               \
+  static double corr_dot_##N(const double *x, const double *y, int n, int stride)                 \
+  {                                                                                               \
+    (void)n;                                                                                      \
+    return corr_dot_body(x, y, N, stride);                                                        \
+  }
+
+CORR_DEFINE_KERNELS(8)
+CORR_DEFINE_KERNELS(16)
+CORR_DEFINE_KERNELS(32)
+
+/** Four floats as a gcc generic vector, for the single-precision search. */
+typedef float corr_v4sf __attribute__((vector_size(16), aligned(4), may_alias));
+
+#define CORR_BLOCK_F32 16 /**< targets per register block in float: four four-lane accumulators */
+
+/**
+ * @brief Cross sums of every target in single precision, CORR_BLOCK_F32 targets at a time.
+ * @param x Source window.
+ * @param y First row of the target windows.
+ * @param n Window length.
+ * @param w Symbols per row.
+ * @param sum_xy Output, one cross sum per target.
+ */
+static void corr_cross_sums_f32(const float *x, const float *y, int n, int w, float *sum_xy)
+{
+  int j = 0;
+  for (; j + CORR_BLOCK_F32 <= w; j += CORR_BLOCK_F32)
+  {
+    corr_v4sf a0 = {0.0f, 0.0f, 0.0f, 0.0f}, a1 = a0, a2 = a0, a3 = a0;
+    CORR_UNROLL
+    for (int k = 0; k < n; ++k)
+    {
+      const corr_v4sf *row = (const corr_v4sf *)&y[(size_t)k * w + j];
+      a0 += x[k] * row[0];
+      a1 += x[k] * row[1];
+      a2 += x[k] * row[2];
+      a3 += x[k] * row[3];
+    }
+    corr_v4sf *out = (corr_v4sf *)&sum_xy[j];
+    out[0] = a0;
+    out[1] = a1;
+    out[2] = a2;
+    out[3] = a3;
+  }
+  for (; j + 4 <= w; j += 4) // small universes
+  {
+    corr_v4sf a = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int k = 0; k < n; ++k)
+      a += x[k] * *(const corr_v4sf *)&y[(size_t)k * w + j];
+    *(corr_v4sf *)&sum_xy[j] = a;
+  }
+  for (; j < w; ++j)
+  {
+    float a = 0.0f;
+    for (int k = 0; k < n; ++k)
+      a += x[k] * y[(size_t)k * w + j];
+    sum_xy[j] = a;
+  }
+}
+
+/**
+ * @brief Selects the kernels of a window length.
+ * @param k Pointer to store the kernels.
+ * @param window_len Points per correlation window.
+ * @param specialized Nonzero to use a specialized kernel when one exists for window_len.
+ * @return 1 if a specialized kernel was selected, 0 for the generic ones.
+ */
+int corr_kernels_select(corr_kernels *k, int window_len, int specialized)
+{
+  k->cross_sums = corr_cross_sums_generic;
+  k->dot = corr_dot_generic;
+  k->specialized = 0;
+  if (!specialized)
+    return 0;
+
+  switch (window_len)
+  {
+  case 8:
+    k->cross_sums = corr_cross_sums_8;
+    k->dot = corr_dot_8;
+    break;
+  case 16:
+    k->cross_sums = corr_cross_sums_16;
+    k->dot = corr_dot_16;
+    break;
+  case 32:
+    k->cross_sums = corr_cross_sums_32;
+    k->dot = corr_dot_32;
+    break;
+  default:
+    return 0;
+  }
+  k->specialized = window_len;
+  return 1;
+}
+
+/**
+ * @brief Initializes an empty corr_universe, with the specialized kernels of window_len if any.
+ * @param u Pointer to the corr_universe.
+ * @param window_len Points per correlation window.
+ * @param max_lag Largest lag searched.
+ * @param width Symbols per row.
+ * @return 0 on success, -1 if allocation failed.
+ */
+int corr_universe_init(corr_universe *u, int window_len, int max_lag, int width)
+{
+  memset(u, 0, sizeof(*u));
+  if (window_len < 2 || max_lag < 0 || width < 1)
+    return -1;
+
+  size_t cells = (size_t)(max_lag + 1) * width;
+  u->window_len = window_len;
+  u->max_lag = max_lag;
+  u->width = width;
+  corr_kernels_select(&u->kernels, window_len, 1);
+  u->sum_y = calloc(cells, sizeof(double));
+  u->sum_yy = calloc(cells, sizeof(double));
+  u->var = calloc(cells, sizeof(double));
+  u->segments = calloc(cells * CORR_SCREEN_SEGMENTS, sizeof(float));
+  u->residual = calloc(cells, sizeof(float));
+  u->bound = calloc(cells, sizeof(float));
+  u->scratch = calloc(3 * width + window_len, sizeof(double));
+  u->tile = calloc(CORR_TILE * CORR_TILE, sizeof(double));
+  u->best_lag = calloc(2 * width, sizeof(int));
+  u->normalized = calloc(cells * window_len, sizeof(float));
+  u->source_f = calloc((size_t)width * window_len, sizeof(float));
+  if (!u->sum_y || !u->sum_yy || !u->var || !u->segments || !u->residual || !u->bound || !u->scratch || !u->tile ||
+      !u->best_lag || !u->normalized || !u->source_f)
+  {
+    corr_universe_cleanup(u);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Computes the per-lag window sums and screening signatures after `rows`, `vwap` and
+ * `minute_ts_ms` were set.
+ * @param u Pointer to the corr_universe.
+ */
+void corr_universe_prepare(corr_universe *u)
+{
+  int n = u->window_len, w = u->width;
+  double *mean = u->scratch, *inv_norm = u->scratch + w, *scale = u->scratch + 2 * w;
+
+  for (int lag = 0; lag <= u->max_lag; ++lag)
+  {
+    double *sy = &u->sum_y[lag * w], *syy = &u->sum_yy[lag * w], *var = &u->var[lag * w];
+    float *seg = &u->segments[(size_t)lag * CORR_SCREEN_SEGMENTS * w], *res = &u->residual[lag * w];
+    int start = u->rows - n - lag;
+    if (start < 0)
+      break; // longer lags are not searched
+
+    /* exact sums, per symbol in row order: vectorized across symbols */
+    const double *y = &u->vwap[(size_t)start * w];
+    for (int j = 0; j < w; ++j)
+      sy[j] = syy[j] = 0.0;
+    for (int k = 0; k < n; ++k)
+    {
+      const double *row = &y[(size_t)k * w];
+      for (int j = 0; j < w; ++j)
+      {
+        sy[j] += row[j];
+        syy[j] += row[j] * row[j];
+      }
+    }
+
+    for (int j = 0; j < w; ++j)
+      var[j] = n * syy[j] - sy[j] * sy[j];
+
+    /* screening: centered (two-pass) norms, then segment means of the z-normalized window */
+    for (int j = 0; j < w; ++j)
+    {
+      mean[j] = sy[j] / n;
+      inv_norm[j] = 0.0;
+    }
+    for (int k = 0; k < n; ++k)
+    {
+      const double *row = &y[(size_t)k * w];
+      for (int j = 0; j < w; ++j)
+        inv_norm[j] += (row[j] - mean[j]) * (row[j] - mean[j]);
+    }
+    if (u->single_precision)
+    {
+      /* centered and scaled in double, so float only rounds the normalized shape */
+      float *z = &u->normalized[(size_t)lag * n * w];
+      for (int j = 0; j < w; ++j)
+        scale[j] = inv_norm[j] > 0.0 ? 1.0 / sqrt(inv_norm[j]) : NAN;
+      for (int k = 0; k < n; ++k)
+        for (int j = 0; j < w; ++j)
+          z[(size_t)k * w + j] = (float)((y[(size_t)k * w + j] - mean[j]) * scale[j]);
+    }
+    for (int j = 0; j < w; ++j)
+    {
+      double sum_sq = inv_norm[j];
+      int screened = sum_sq > CORR_SCREEN_MIN_REL_VAR * n * mean[j] * mean[j]; // false for flat or NAN
+      inv_norm[j] = screened ? 1.0 / sqrt(sum_sq) : 0.0;
+      res[j] = 1.0f; // energy left after the segments, finished below
+    }
+
+    for (int g = 0; g < CORR_SCREEN_SEGMENTS; ++g)
+    {
+      int lo = g * n / CORR_SCREEN_SEGMENTS, hi = (g + 1) * n / CORR_SCREEN_SEGMENTS;
+      double scale = hi > lo ? 1.0 / sqrt((double)(hi - lo)) : 0.0;
+      float *seg_g = &seg[g * w];
+      for (int j = 0; j < w; ++j)
+      {
+        double sum = 0.0;
+        for (int k = lo; k < hi; ++k)
+          sum += y[(size_t)k * w + j] - mean[j];
+        double a = sum * inv_norm[j] * scale;
+        seg_g[j] = (float)a;
+        res[j] -= (float)(a * a);
+      }
+    }
+    for (int j = 0; j < w; ++j)
+      res[j] = inv_norm[j] > 0.0 ? sqrtf(res[j] > 0.0f ? res[j] : 0.0f) : -1.0f;
+  }
+}
+
+/**
+ * @brief Keeps `c` if it beats the current match, breaking ties as the exhaustive order would.
+ * @param out Current match.
+ * @param found Whether `out` holds a match.
+ * @param best_lag Lag of the current match.
+ * @param c Candidate coefficient.
+ * @param target Candidate symbol.
+ * @param lag Candidate lag.
+ * @param end_ts_ms Candidate window end.
+ */
+static inline void corr_consider(corr_match *out, int *found, int *best_lag, double c, int target, int lag,
+                                 int64_t end_ts_ms)
+{
+  if (isnan(c))
+    return;
+  double a = fabs(c), b = fabs(out->corr);
+  if (!*found || a > b || (a == b && (target < out->target || (target == out->target && lag < *best_lag))))
+  {
+    out->corr = c;
+    out->target = target;
+    out->minute_ts_ms = end_ts_ms;
+    *best_lag = lag;
+    *found = 1;
+  }
+}
+
+/**
+ * @brief Finishes one exact coefficient from the window sums, with pearson_correlation's arithmetic.
+ * @param n Window length.
+ * @param sum_x Source sum.
+ * @param sum_xx Source sum of squares.
+ * @param sum_y Target sum.
+ * @param sum_yy Target sum of squares.
+ * @param sum_xy Cross sum.
+ * @return The coefficient, or NAN if the denominator is zero.
+ */
+static inline double corr_from_sums(int n, double sum_x, double sum_xx, double sum_y, double sum_yy, double sum_xy)
+{
+  double numerator = n * sum_xy - sum_x * sum_y;
+  double denominator = sqrt((n * sum_xx - sum_x * sum_x) * (n * sum_yy - sum_y * sum_y));
+  if (denominator == 0)
+    return NAN;
+  return numerator / denominator;
+}
+
+/**
+ * @brief Computes one candidate's coefficient from the source window and the shared target sums.
+ * @param u Pointer to the prepared corr_universe.
+ * @param x Source window.
+ * @param sum_x Source sum.
+ * @param sum_xx Source sum of squares.
+ * @param idx Candidate index, lag * width + target.
+ * @return The coefficient, or NAN if the denominator is zero.
+ */
+static inline double corr_exact(const corr_universe *u, const double *x, double sum_x, double sum_xx, int idx)
+{
+  int n = u->window_len, w = u->width;
+  const double *y = &u->vwap[(size_t)(u->rows - n - idx / w) * w + idx % w];
+  double sum_xy = u->kernels.dot(x, y, n, w);
+  return corr_from_sums(n, sum_x, sum_xx, u->sum_y[idx], u->sum_yy[idx], sum_xy);
+}
+
+/**
+ * @brief Finds the target window with the highest absolute correlation to a source's newest window.
+ * @details The match is the one an exhaustive search visiting targets, then lags, in order
+ * and keeping the first strictly better value would return, with coefficients bit-identical
+ * to pearson_correlation. Without pruning every lag is evaluated for all targets at once;
+ * with pruning, candidates whose screening bound is below the best known value are skipped.
+ * @param u Pointer to the prepared corr_universe.
+ * @param src Index of the source symbol (its own lags start after one full window).
+ * @param prune Nonzero to skip candidates by their bound.
+ * @param out Pointer to store the best match.
+ * @param stats Counters to add to (may be NULL).
+ */
+void corr_search_best(corr_universe *u, int src, int prune, corr_match *out, corr_search_stats *stats)
+{
+  int n = u->window_len, w = u->width;
+  out->corr = NAN;
+  out->minute_ts_ms = 0;
+  out->target = -1;
+  if (u->rows < n)
+    return;
+
+  int max_lag = u->rows - n < u->max_lag ? u->rows - n : u->max_lag;
+  double *sum_xy = u->scratch, *x = u->scratch + 3 * w;
+  double sum_x = 0, sum_xx = 0;
+  for (int k = 0; k < n; ++k)
+  {
+    x[k] = u->vwap[(size_t)(u->rows - n + k) * w + src];
+    sum_x += x[k];
+    sum_xx += x[k] * x[k];
+  }
+
+  float xr = u->residual[src];
+  prune = prune && xr >= 0.0f;
+
+  int found = 0, best_lag = 0;
+  uint64_t exact = 0;
+  uint64_t candidates = (uint64_t)(max_lag + 1) * w - (max_lag + 1 < n ? max_lag + 1 : n);
+
+  if (!prune)
+  {
+    /* exhaustive: cross sums of every target at once, one lag at a time */
+    for (int lag = 0; lag <= max_lag; ++lag)
+    {
+      u->kernels.cross_sums(x, &u->vwap[(size_t)(u->rows - n - lag) * w], n, w, sum_xy);
+
+      int64_t end_ts_ms = u->minute_ts_ms[u->rows - 1 - lag];
+      const double *sy = &u->sum_y[lag * w], *syy = &u->sum_yy[lag * w];
+      for (int j = 0; j < w; ++j)
+      {
+        if (j == src && lag < n)
+          continue; // overlaps the source window
+        corr_consider(out, &found, &best_lag, corr_from_sums(n, sum_x, sum_xx, sy[j], syy[j], sum_xy[j]), j, lag,
+                      end_ts_ms);
+      }
+    }
+    exact = candidates;
+  }
+  else
+  {
+    float xs[CORR_SCREEN_SEGMENTS];
+    for (int g = 0; g < CORR_SCREEN_SEGMENTS; ++g)
+      xs[g] = u->segments[g * w + src];
+
+    /* coarse pass: bound every candidate (branch-free, vectorized across targets) */
+    for (int lag = 0; lag <= max_lag; ++lag)
+    {
+      const float *seg = &u->segments[(size_t)lag * CORR_SCREEN_SEGMENTS * w];
+      const float *res = &u->residual[lag * w];
+      float *bound = &u->bound[lag * w];
+      for (int j = 0; j < w; ++j)
+        bound[j] = 0.0f;
+      for (int g = 0; g < CORR_SCREEN_SEGMENTS; ++g)
+        for (int j = 0; j < w; ++j)
+          bound[j] += xs[g] * seg[g * w + j];
+      for (int j = 0; j < w; ++j)
+      {
+        float b = fabsf(bound[j]) + xr * res[j] + (float)CORR_BOUND_SLACK;
+        bound[j] = res[j] < 0.0f ? INFINITY : b; // unscreened: always exact
+      }
+      if (lag < n)
+        bound[src] = -1.0f; // overlaps the source window
+    }
+
+    /* fine pass: exact Pearson only where the bound can still beat the best so far */
+    float threshold = 0.0f;
+    for (int lag = 0; lag <= max_lag; ++lag)
+    {
+      const float *bound = &u->bound[lag * w];
+      for (int j = 0; j < w; ++j)
+      {
+        if (bound[j] < threshold)
+          continue;
+        corr_consider(out, &found, &best_lag, corr_exact(u, x, sum_x, sum_xx, lag * w + j), j, lag,
+                      u->minute_ts_ms[u->rows - 1 - lag]);
+        exact++;
+        if (found)
+          threshold = (float)fabs(out->corr) * (1.0f - 1e-6f); // rounded down: never above the true best
+      }
+    }
+  }
+
+  if (!found)
+    out->corr = NAN;
+  if (stats)
+  {
+    stats->candidates += candidates;
+    stats->exact += exact;
+  }
+}
+
+/**
+ * @brief The single-precision search of every source (see corr_search_all).
+ * @details Lag by lag, so the normalized windows of a lag stay in cache for all sources.
+ * @param u Pointer to the prepared corr_universe.
+ * @param out Array of `width` matches, one per source.
+ * @param stats Counters to add to (may be NULL).
+ */
+static void corr_search_all_f32(corr_universe *u, corr_match *out, corr_search_stats *stats)
+{
+  int n = u->window_len, w = u->width;
+  int max_lag = u->rows - n < u->max_lag ? u->rows - n : u->max_lag;
+  int *best_lag = u->best_lag, *found = u->best_lag + w;
+  float *c = u->bound; // one source and lag at a time
+
+  for (int i = 0; i < w; ++i)
+  {
+    out[i].corr = NAN;
+    out[i].minute_ts_ms = 0;
+    out[i].target = -1;
+    found[i] = 0;
+    for (int k = 0; k < n; ++k)
+      u->source_f[(size_t)i * n + k] = u->normalized[(size_t)k * w + i]; // lag 0
+  }
+
+  for (int lag = 0; lag <= max_lag; ++lag)
+  {
+    const float *z = &u->normalized[(size_t)lag * n * w];
+    int64_t end_ts_ms = u->minute_ts_ms[u->rows - 1 - lag];
+    for (int i = 0; i < w; ++i)
+    {
+      const float *x = &u->source_f[(size_t)i * n];
+      if (isnan(x[0]))
+        continue; // flat source: every coefficient is NAN
+      corr_cross_sums_f32(x, z, n, w, c);
+
+      float best_abs = found[i] ? (float)fabs(out[i].corr) : 0.0f;
+      for (int j = 0; j < w; ++j)
+      {
+        if (!(fabsf(c[j]) >= best_abs) || (j == i && lag < n))
+          continue; // cannot win (or NAN), or overlaps the source window
+        corr_consider(&out[i], &found[i], &best_lag[i], c[j], j, lag, end_ts_ms);
+        best_abs = (float)fabs(out[i].corr);
+      }
+    }
+  }
+
+  if (stats)
+  {
+    uint64_t candidates = (uint64_t)(max_lag + 1) * w - (max_lag + 1 < n ? max_lag + 1 : n);
+    stats->candidates += candidates * w;
+    stats->exact += candidates * w;
+  }
+}
+
+/**
+ * @brief Finds the best match of every source at once.
+ * @details Same matches as corr_search_best for each source. In single precision, every
+ * candidate is evaluated in float and `prune` is ignored. Otherwise, without pruning, the cross sums
+ * of all sources and targets of a lag are one matrix product, computed tile by tile and
+ * turned into coefficients while the tile is in cache; with pruning each source is searched
+ * on its own, since only a few candidates are evaluated.
+ * @param u Pointer to the prepared corr_universe.
+ * @param prune Nonzero to skip candidates by their bound.
+ * @param out Array of `width` matches, one per source.
+ * @param stats Counters to add to (may be NULL).
+ */
+void corr_search_all(corr_universe *u, int prune, corr_match *out, corr_search_stats *stats)
+{
+  int n = u->window_len, w = u->width;
+  if (u->single_precision && u->rows >= n)
+  {
+    corr_search_all_f32(u, out, stats);
+    return;
+  }
+  if (prune || u->rows < n)
+  {
+    for (int i = 0; i < w; ++i)
+      corr_search_best(u, i, prune, &out[i], stats);
+    return;
+  }
+
+  int max_lag = u->rows - n < u->max_lag ? u->rows - n : u->max_lag;
+  int *best_lag = u->best_lag, *found = u->best_lag + w;
+  for (int i = 0; i < w; ++i)
+  {
+    out[i].corr = NAN;
+    out[i].minute_ts_ms = 0;
+    out[i].target = -1;
+    found[i] = 0;
+  }
+
+  /* A: the newest window of every source; B: every target's window at this lag, an
+   * overlapping row range of the same matrix */
+  const double *a = &u->vwap[(size_t)(u->rows - n) * w];
+  for (int lag = 0; lag <= max_lag; ++lag)
+  {
+    const double *b = &u->vwap[(size_t)(u->rows - n - lag) * w];
+    const double *sy = &u->sum_y[lag * w], *var_y = &u->var[lag * w];
+    int64_t end_ts_ms = u->minute_ts_ms[u->rows - 1 - lag];
+
+    for (int ib = 0; ib < w; ib += CORR_TILE)
+    {
+      int mb = w - ib < CORR_TILE ? w - ib : CORR_TILE;
+      for (int jb = 0; jb < w; jb += CORR_TILE)
+      {
+        int nb = w - jb < CORR_TILE ? w - jb : CORR_TILE;
+        corr_gemm_tn(mb, nb, n, &a[ib], w, &b[jb], w, u->tile, CORR_TILE);
+
+        for (int r = 0; r < mb; ++r)
+        {
+          int i = ib + r;
+          double *c = &u->tile[r * CORR_TILE];
+          double sum_x = u->sum_y[i], var_x = u->var[i]; // lag 0 of the source itself
+
+          /* pearson_correlation's arithmetic, branch-free so it vectorizes */
+          for (int j = 0; j < nb; ++j)
+          {
+            double numerator = n * c[j] - sum_x * sy[jb + j];
+            double denominator = sqrt(var_x * var_y[jb + j]);
+            c[j] = numerator / (denominator == 0 ? NAN : denominator); // NAN like pearson_correlation
+          }
+
+          double best_abs = found[i] ? fabs(out[i].corr) : 0.0;
+          for (int j = 0; j < nb; ++j)
+          {
+            if (!(fabs(c[j]) >= best_abs) || (jb + j == i && lag < n))
+              continue; // cannot win (or NAN), or overlaps the source window
+            corr_consider(&out[i], &found[i], &best_lag[i], c[j], jb + j, lag, end_ts_ms);
+            best_abs = fabs(out[i].corr);
+          }
+        }
+      }
+    }
+  }
+
+  if (stats)
+  {
+    uint64_t candidates = (uint64_t)(max_lag + 1) * w - (max_lag + 1 < n ? max_lag + 1 : n);
+    stats->candidates += candidates * w;
+    stats->exact += candidates * w;
+  }
+}
+
+/**
+ * @brief Memory allocated by corr_universe_init, in bytes.
+ * @param u Pointer to an initialized corr_universe.
+ * @return Bytes.
+ */
+size_t corr_universe_memory(const corr_universe *u)
+{
+  size_t cells = (size_t)(u->max_lag + 1) * u->width;
+  return cells * (3 * sizeof(double) + (CORR_SCREEN_SEGMENTS + 2 + (size_t)u->window_len) * sizeof(float)) +
+         (size_t)(3 * u->width + u->window_len + CORR_TILE * CORR_TILE) * sizeof(double) +
+         (size_t)2 * u->width * sizeof(int) + (size_t)u->width * u->window_len * sizeof(float);
+}
+
+/**
+ * @brief Releases a corr_universe.
+ * @param u Pointer to the corr_universe.
+ */
+void corr_universe_cleanup(corr_universe *u)
+{
+  free(u->sum_y);
+  free(u->sum_yy);
+  free(u->var);
+  free(u->segments);
+  free(u->residual);
+  free(u->bound);
+  free(u->scratch);
+  free(u->tile);
+  free(u->best_lag);
+  free(u->normalized);
+  free(u->source_f);
+  u->normalized = u->source_f = NULL;
+  u->sum_y = u->sum_yy = u->var = u->scratch = u->tile = NULL;
+  u->best_lag = NULL;
+  u->segments = u->residual = u->bound = NULL;
+}
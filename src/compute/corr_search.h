@@ -0,0 +1,190 @@
+/**
+ * @file corr_search.h
+ * @brief Lagged correlation search over a time-major VWAP matrix declarations
+ *
+ * The universe is a block of rows, one per minute, each holding every symbol's VWAP side
+ * by side, so the values of all symbols at a given lag are one contiguous vector. Once per
+ * tick the per-lag window sums of every symbol are computed (shared by all sources), along
+ * with screening signatures: the z-normalized window reduced to CORR_SCREEN_SEGMENTS segment
+ * means (a downsampled series) and the norm of what the segments leave out. For two windows
+ * the downsampled correlation plus the product of the residual norms bounds the exact
+ * Pearson coefficient, so a (target, lag) candidate whose bound cannot beat the best found
+ * so far is skipped without changing the result. The cross sums run through kernels chosen
+ * per window length: register-blocked across targets, and fully specialized for the window
+ * lengths in CORR_KERNEL_LENGTHS. corr_search_all batches the exhaustive search of every
+ * source as one blocked matrix product per lag (see corr_gemm.h). With `single_precision` set
+ * it runs in float instead: every lag window is centered and scaled to unit norm in double,
+ * then stored as float, so a coefficient is a single float dot product of two normalized
+ * windows (no pruning, sqrt or division per candidate).
+ * Kept free of libwebsockets/common.h so offline tools can include it.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef CORR_SEARCH_H
+#define CORR_SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CORR_SCREEN_SEGMENTS 4 /**< segment means per window used for screening */
+#define CORR_KERNEL_LENGTHS "8, 16, 32" /**< window lengths with specialized kernels */
+#define CORR_TILE 32                    /**< sources x targets per cache tile of the batched search */
+
+/**
+ * @brief Computes the cross sums of a source window with the same-lag windows of every target.
+ * @param x Source window (n points).
+ * @param y First row of the target windows (n rows of `width` values).
+ * @param n Window length (ignored by specialized kernels).
+ * @param width Symbols per row.
+ * @param sum_xy Output, one cross sum per target.
+ */
+typedef void (*corr_cross_sums_fn)(const double *x, const double *y, int n, int width, double *sum_xy);
+
+/**
+ * @brief Computes the cross sum of a source window with one target window.
+ * @param x Source window (n points).
+ * @param y First point of the target window.
+ * @param n Window length (ignored by specialized kernels).
+ * @param stride Distance between consecutive target points.
+ * @return The cross sum.
+ */
+typedef double (*corr_dot_fn)(const double *x, const double *y, int n, int stride);
+
+/**
+ * @brief The kernels of one window length.
+ */
+typedef struct
+{
+  corr_cross_sums_fn cross_sums; /**< all targets of one lag */
+  corr_dot_fn dot;               /**< one candidate */
+  int specialized;               /**< window length compiled in, 0 for the generic kernels */
+} corr_kernels;
+
+/**
+ * @brief A view of the newest VWAP rows of all symbols plus their per-lag sums and signatures.
+ */
+typedef struct
+{
+  int window_len;              /**< points per correlation window */
+  int max_lag;                 /**< largest lag searched */
+  int width;                   /**< symbols per row */
+  int rows;                    /**< rows in the view, oldest first (at most window_len + max_lag) */
+  const double *vwap;          /**< rows x width VWAPs (not owned: typically the matrix view) */
+  const int64_t *minute_ts_ms; /**< row timestamps (not owned) */
+  corr_kernels kernels;        /**< selected by corr_universe_init for window_len */
+  int single_precision;        /**< nonzero: corr_search_all in float (set before corr_universe_prepare) */
+
+  /* computed by corr_universe_prepare, indexed [lag * width + symbol] */
+  double *sum_y;    /**< window sums, accumulated in the order pearson_correlation uses */
+  double *sum_yy;   /**< window sums of squares, same order */
+  double *var;      /**< window_len * sum_yy - sum_y^2, the variance factor of the coefficient */
+  float *segments;  /**< [lag][segment][symbol] scaled segment means of the z-normalized window */
+  float *residual;  /**< norm of the z-normalized window minus its segment means, < 0 if unscreened */
+  float *bound;     /**< scratch: per-candidate bounds of the current source */
+  double *scratch;  /**< scratch: one row of per-symbol accumulators */
+  double *tile;     /**< scratch: CORR_TILE x CORR_TILE cross sums of the batched search */
+  int *best_lag;    /**< scratch: per-source lag and found flag of the batched search */
+
+  /* single precision only */
+  float *normalized; /**< [lag][point][symbol] z-normalized windows (unit norm), NAN if flat */
+  float *source_f;   /**< scratch: [symbol][point] the lag 0 windows, one source per row */
+} corr_universe;
+
+/**
+ * @brief The best lagged match of a source window.
+ */
+typedef struct
+{
+  double corr;          /**< Pearson coefficient (NAN if none) */
+  int64_t minute_ts_ms; /**< end of the matching target window */
+  int target;           /**< index of the matching symbol (-1 if none) */
+} corr_match;
+
+/**
+ * @brief Candidate counters of a search.
+ */
+typedef struct
+{
+  uint64_t candidates; /**< (target, lag) windows considered */
+  uint64_t exact;      /**< exact Pearson evaluations */
+} corr_search_stats;
+
+/**
+ * @brief Computes the Pearson correlation coefficient between two data series.
+ * @param x Pointer to the first data array.
+ * @param y Pointer to the second data array.
+ * @param n The number of points in each array.
+ * @return The correlation coefficient, or NAN if the denominator is zero.
+ */
+double pearson_correlation(const double *x, const double *y, int n);
+
+/**
+ * @brief Selects the kernels of a window length.
+ * @param k Pointer to store the kernels.
+ * @param window_len Points per correlation window.
+ * @param specialized Nonzero to use a specialized kernel when one exists for window_len.
+ * @return 1 if a specialized kernel was selected, 0 for the generic ones.
+ */
+int corr_kernels_select(corr_kernels *k, int window_len, int specialized);
+
+/**
+ * @brief Initializes an empty corr_universe, with the specialized kernels of window_len if any.
+ * @param u Pointer to the corr_universe.
+ * @param window_len Points per correlation window.
+ * @param max_lag Largest lag searched.
+ * @param width Symbols per row.
+ * @return 0 on success, -1 if allocation failed.
+ */
+int corr_universe_init(corr_universe *u, int window_len, int max_lag, int width);
+
+/**
+ * @brief Computes the per-lag window sums and screening signatures after `rows`, `vwap` and
+ * `minute_ts_ms` were set.
+ * @param u Pointer to the corr_universe.
+ */
+void corr_universe_prepare(corr_universe *u);
+
+/**
+ * @brief Finds the target window with the highest absolute correlation to a source's newest window.
+ * @details The match is the one an exhaustive search visiting targets, then lags, in order
+ * and keeping the first strictly better value would return, with coefficients bit-identical
+ * to pearson_correlation. Without pruning every lag is evaluated for all targets at once;
+ * with pruning, candidates whose screening bound is below the best known value are skipped.
+ * @param u Pointer to the prepared corr_universe.
+ * @param src Index of the source symbol (its own lags start after one full window).
+ * @param prune Nonzero to skip candidates by their bound.
+ * @param out Pointer to store the best match.
+ * @param stats Counters to add to (may be NULL).
+ */
+void corr_search_best(corr_universe *u, int src, int prune, corr_match *out, corr_search_stats *stats);
+
+/**
+ * @brief Finds the best match of every source at once.
+ * @details Same matches as corr_search_best for each source. In single precision, every
+ * candidate is evaluated in float and `prune` is ignored. Otherwise, without pruning, the cross sums
+ * of all sources and targets of a lag are one matrix product, computed tile by tile and
+ * turned into coefficients while the tile is in cache; with pruning each source is searched
+ * on its own, since only a few candidates are evaluated.
+ * @param u Pointer to the prepared corr_universe.
+ * @param prune Nonzero to skip candidates by their bound.
+ * @param out Array of `width` matches, one per source.
+ * @param stats Counters to add to (may be NULL).
+ */
+void corr_search_all(corr_universe *u, int prune, corr_match *out, corr_search_stats *stats);
+
+/**
+ * @brief Memory allocated by corr_universe_init, in bytes.
+ * @param u Pointer to an initialized corr_universe.
+ * @return Bytes.
+ */
+size_t corr_universe_memory(const corr_universe *u);
+
+/**
+ * @brief Releases a corr_universe.
+ * @param u Pointer to the corr_universe.
+ */
+void corr_universe_cleanup(corr_universe *u);
+
+#endif /* CORR_SEARCH_H */
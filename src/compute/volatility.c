@@ -0,0 +1,93 @@
+/**
+ * @file volatility.c
+ * @brief Volatility estimator implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "volatility.h"
+
+/**
+ * @brief Initializes a volatility_state structure.
+ * @param v Pointer to the volatility_state.
+ */
+void volatility_init(volatility_state *v)
+{
+  memset(v, 0, sizeof(*v));
+  v->ewma_var = NAN;
+  v->prev_close = NAN;
+}
+
+/**
+ * @brief Folds a closed 1-minute bar into the range estimators and the EWMA variance (O(1)).
+ * @details The bar's Parkinson and Garman-Klass variances replace the oldest slot of the
+ * WINDOW_MINUTES ring and its running sums; the log-return of its close against the previous
+ * close updates the EWMA variance with decay EWMA_VOL_LAMBDA.
+ * @param v Pointer to the volatility_state.
+ * @param bar Pointer to the closed 1-minute bar.
+ */
+void volatility_update_bar(volatility_state *v, const ohlcv_bar *bar)
+{
+  double parkinson = 0.0, garman_klass = 0.0;
+
+  if (bar->trade_count > 0 && bar->low > 0 && bar->open > 0)
+  {
+    double hl = log(bar->high / bar->low);
+    double co = log(bar->close / bar->open);
+    parkinson = hl * hl / (4.0 * M_LN2);
+    garman_klass = 0.5 * hl * hl - (2.0 * M_LN2 - 1.0) * co * co;
+  }
+
+  // Replace the oldest minute (a minute without trades contributes zero)
+  if (v->size == WINDOW_MINUTES)
+  {
+    v->sum_parkinson -= v->parkinson[v->next_idx];
+    v->sum_garman_klass -= v->garman_klass[v->next_idx];
+  }
+  else
+  {
+    v->size++;
+  }
+
+  v->parkinson[v->next_idx] = parkinson;
+  v->garman_klass[v->next_idx] = garman_klass;
+  v->sum_parkinson += parkinson;
+  v->sum_garman_klass += garman_klass;
+  v->next_idx = (v->next_idx + 1) % WINDOW_MINUTES;
+
+  // EWMA of squared 1-minute close-to-close returns
+  if (!isnan(bar->close) && bar->close > 0)
+  {
+    if (!isnan(v->prev_close))
+    {
+      double r = log(bar->close / v->prev_close);
+      if (isnan(v->ewma_var))
+        v->ewma_var = r * r; // seed with the first return
+      else
+        v->ewma_var = EWMA_VOL_LAMBDA * v->ewma_var + (1.0 - EWMA_VOL_LAMBDA) * r * r;
+    }
+    v->prev_close = bar->close;
+  }
+}
+
+/**
+ * @brief Takes a snapshot of the range and EWMA estimators over the WINDOW_MINUTES horizon.
+ * @param v Pointer to the volatility_state.
+ * @param out Pointer to store the estimates (`realized_var` is left untouched).
+ */
+void volatility_snapshot(const volatility_state *v, volatility_estimate *out)
+{
+  if (v->size == 0)
+  {
+    out->parkinson_var = out->garman_klass_var = NAN;
+  }
+  else
+  {
+    // Running sums may drift just below zero; Garman-Klass can be negative on a single bar
+    out->parkinson_var = v->sum_parkinson > 0 ? v->sum_parkinson : 0.0;
+    out->garman_klass_var = v->sum_garman_klass > 0 ? v->sum_garman_klass : 0.0;
+  }
+
+  out->ewma_var = v->ewma_var * WINDOW_MINUTES; // per-minute variance scaled to the window
+}
@@ -0,0 +1,37 @@
+/**
+ * @file volatility.h
+ * @brief Volatility estimator declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef VOLATILITY_H
+#define VOLATILITY_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Initializes a volatility_state structure.
+ * @param v Pointer to the volatility_state.
+ */
+void volatility_init(volatility_state *v);
+
+/**
+ * @brief Folds a closed 1-minute bar into the range estimators and the EWMA variance (O(1)).
+ * @details The bar's Parkinson and Garman-Klass variances replace the oldest slot of the
+ * WINDOW_MINUTES ring and its running sums; the log-return of its close against the previous
+ * close updates the EWMA variance with decay EWMA_VOL_LAMBDA.
+ * @param v Pointer to the volatility_state.
+ * @param bar Pointer to the closed 1-minute bar.
+ */
+void volatility_update_bar(volatility_state *v, const ohlcv_bar *bar);
+
+/**
+ * @brief Takes a snapshot of the range and EWMA estimators over the WINDOW_MINUTES horizon.
+ * @param v Pointer to the volatility_state.
+ * @param out Pointer to store the estimates (`realized_var` is left untouched).
+ */
+void volatility_snapshot(const volatility_state *v, volatility_estimate *out);
+
+#endif /* VOLATILITY_H */
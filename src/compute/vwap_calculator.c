@@ -8,8 +8,11 @@
 
 #include "vwap_calculator.h"
 #include "../data/sliding_window.h"
-#include "../data/vwap_history.h"
+#include "../data/vwap_matrix.h"
+#include "../data/bar_builder.h"
+#include "volatility.h"
 #include "../logging/logger.h"
+#include "../utils/alloc_audit.h"
 
 /**
  * @brief Worker thread for calculating and logging moving averages (Task 2).
@@ -19,24 +22,82 @@
 void *vwap_worker_fn(void *arg)
 {
   (void)arg;
+  alloc_audit_thread_start("vwap-worker", 0);
 
-  while (!shutdown_requested)
+  while (!__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
   {
     pthread_barrier_wait(&compute_start_barrier); // Wait for coordinator signal
 
-    if (shutdown_requested)
+    if (__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
     {
       // Ensure the coordinator's second barrier wait completes on shutdown
       pthread_barrier_wait(&compute_done_barrier);
       break;
     }
 
+    /* this minute's row of the VWAP matrix first, so the correlation worker can use it */
+    double vwap_row[NUM_SYMBOLS];
     for (int i = 0; i < NUM_SYMBOLS; ++i)
     {
-      double vwap;
-      sliding_window_snapshot_vwap(&symbols[i].trade_window, &vwap); // get current VWAP (volume unused)
-      vwap_history_append(&symbols[i].vwap_hist, current_minute_ms, vwap); // store in history
+      vwap_row[i] = NAN; // free slot
+      if (symbols[i].symbol[0])
+        sliding_window_snapshot_vwap(&symbols[i].trade_window, &vwap_row[i]); // get current VWAP (volume unused)
+    }
+    vwap_matrix_append(&vwap_hist, current_minute_ms, vwap_row);            // store in history
+    if (trade_channel)
+      shm_channel_publish_vwap(trade_channel, current_minute_ms, vwap_row); // survives an analytics restart
+
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+    {
+      if (!symbols[i].symbol[0])
+        continue; // free slot: no window, no files
+      double vwap = vwap_row[i];
       vwap_log_append_csv(i, current_minute_ms, vwap);        // append to file (without volume)
+      minute_metrics[i][ALERT_METRIC_VWAP] = vwap;
+
+      trade_flow flow;
+      sliding_window_snapshot_flow(&symbols[i].trade_window, &flow); // buy/sell split from the same window
+      flow_log_append_csv(i, current_minute_ms, &flow);
+      minute_metrics[i][ALERT_METRIC_IMBALANCE] = flow.imbalance;
+
+      window_quantiles wq;
+      sliding_window_snapshot_quantiles(&symbols[i].trade_window, &wq); // median price, size percentiles
+      quantiles_log_append_csv(i, current_minute_ms, &wq);
+
+      window_range range;
+      sliding_window_snapshot_range(&symbols[i].trade_window, &range); // O(1) from the min/max deques
+      range_log_append_csv(i, current_minute_ms, &range);
+      minute_metrics[i][ALERT_METRIC_RANGE_BPS] = 1e4 * (range.high - range.low) / range.low;
+
+      window_profile profile;
+      sliding_window_snapshot_profile(&symbols[i].trade_window, &profile); // TWAP, POC, value area
+      profile_log_append_csv(i, current_minute_ms, &profile);
+
+      window_occupancy occ;
+      sliding_window_snapshot_occupancy(&symbols[i].trade_window, &occ); // this minute's peak included
+      window_log_append_csv(i, current_minute_ms, &occ);
+      sliding_window_trim(&symbols[i].trade_window); // give back chunks beyond the recent peak
+
+      ohlcv_bar bar;
+      bar_builder_close_minute(&symbols[i].bars, current_minute_ms, &bar); // close the 1-minute bar
+      bar_log_append_csv(i, &bar);
+
+      volatility_estimate vol;
+      volatility_update_bar(&symbols[i].vol, &bar); // range estimators and EWMA from the closed bar
+      volatility_snapshot(&symbols[i].vol, &vol);
+      sliding_window_snapshot_realized_variance(&symbols[i].trade_window, &vol.realized_var);
+      volatility_log_append_csv(i, current_minute_ms, &vol);
+      minute_metrics[i][ALERT_METRIC_REALIZED_VOL] = sqrt(vol.realized_var);
+
+      for (int k = 1; k < NUM_BAR_INTERVALS; ++k) // longer bars close on their UTC boundary
+      {
+        int64_t interval_ms = BAR_INTERVALS_MINUTES[k] * MS_PER_MINUTE;
+        if (current_minute_ms % interval_ms == 0 &&
+            bar_builder_aggregate(&symbols[i].bars, BAR_INTERVALS_MINUTES[k], current_minute_ms, &bar))
+        {
+          bar_log_append_csv(i, &bar);
+        }
+      }
     }
 
     pthread_barrier_wait(&compute_done_barrier); // Signal completion
@@ -20,7 +20,13 @@ const char *SYMBOLS[NUM_SYMBOLS] = {
     "LTC-USDT", "BNB-USDT"
 };
 
+/**
+ * @brief Bar intervals in minutes (1 first; others are multiples aggregated from 1-minute bars).
+ */
+const int BAR_INTERVALS_MINUTES[NUM_BAR_INTERVALS] = {1, 5, 15};
+
 /* Global flags */
-int shutdown_requested = 0; /**< Flag to signal graceful shutdown on SIGINT */
+int ingest_stop_requested = 0; /**< Feed threads stop reading (set first on SIGINT/SIGTERM) */
+int shutdown_requested = 0;    /**< Every other thread stops (set once the queue is drained) */
 
 #endif /* CONFIG_H */
\ No newline at end of file
@@ -0,0 +1,202 @@
+/**
+ * @file bar_builder.c
+ * @brief OHLCV bar builder operations implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "bar_builder.h"
+#include "../utils/mem_budget.h"
+
+/**
+ * @brief Resets a bar to an empty 1-minute bar.
+ * @param bar Pointer to the bar.
+ */
+static void bar_reset(ohlcv_bar *bar)
+{
+  bar->start_ms = 0;
+  bar->interval_minutes = 1;
+  bar->open = bar->high = bar->low = bar->close = NAN;
+  bar->volume = 0.0;
+  bar->notional = 0.0;
+  bar->trade_count = 0;
+}
+
+/**
+ * @brief Initializes a bar_builder structure.
+ * @param b Pointer to the bar_builder.
+ * @param capacity The maximum number of closed 1-minute bars to keep.
+ */
+void bar_builder_init(bar_builder *b, int capacity)
+{
+  b->buffer = calloc(capacity, sizeof(ohlcv_bar));
+
+  if (!b->buffer)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate bar history buffer for %d bars (%.2f KB)\n",
+            capacity, (capacity * sizeof(ohlcv_bar)) / 1024.0);
+    exit(1);
+  }
+
+  mem_budget_add(MEM_HISTORY, (int64_t)capacity * sizeof(ohlcv_bar));
+
+  b->capacity = capacity;
+  b->head_idx = 0;
+  b->tail_idx = 0;
+  b->size = 0;
+  b->last_close = NAN;
+  bar_reset(&b->current);
+  pthread_mutex_init(&b->lock, NULL);
+}
+
+/**
+ * @brief Adds a trade to the bar being built (O(1)).
+ * @param b Pointer to the bar_builder.
+ * @param price Price of the trade.
+ * @param size Size of the trade.
+ */
+void bar_builder_add_trade(bar_builder *b, double price, double size)
+{
+  pthread_mutex_lock(&b->lock);
+
+  ohlcv_bar *bar = &b->current;
+  if (bar->trade_count == 0)
+  {
+    bar->open = bar->high = bar->low = price;
+  }
+  else
+  {
+    if (price > bar->high)
+      bar->high = price;
+    if (price < bar->low)
+      bar->low = price;
+  }
+
+  bar->close = price;
+  bar->volume += size;
+  bar->notional += price * size;
+  bar->trade_count++;
+
+  pthread_mutex_unlock(&b->lock);
+}
+
+/**
+ * @brief Closes the current bar as the 1-minute bar ending at `minute_end_ms` and starts a new one.
+ * @details A minute without trades yields a bar with zero volume whose prices repeat the last close.
+ * @param b Pointer to the bar_builder.
+ * @param minute_end_ms End of the minute (the per-minute tick).
+ * @param out Pointer to store the closed bar.
+ */
+void bar_builder_close_minute(bar_builder *b, int64_t minute_end_ms, ohlcv_bar *out)
+{
+  pthread_mutex_lock(&b->lock);
+
+  ohlcv_bar bar = b->current;
+  bar_reset(&b->current);
+
+  bar.start_ms = minute_end_ms - MS_PER_MINUTE;
+  if (bar.trade_count == 0)
+    bar.open = bar.high = bar.low = bar.close = b->last_close;
+  else
+    b->last_close = bar.close;
+
+  // Handle buffer full
+  if (b->size == b->capacity)
+  {
+    b->head_idx = (b->head_idx + 1) % b->capacity;
+    b->size--;
+  }
+
+  // Add new entry
+  b->buffer[b->tail_idx] = bar;
+  b->tail_idx = (b->tail_idx + 1) % b->capacity;
+  b->size++;
+
+  pthread_mutex_unlock(&b->lock);
+
+  *out = bar;
+}
+
+/**
+ * @brief Aggregates the closed 1-minute bars in [end_ms - interval, end_ms) into one bar.
+ * @param b Pointer to the bar_builder.
+ * @param interval_minutes Bar length in minutes (at most the ring capacity).
+ * @param end_ms End of the interval.
+ * @param out Pointer to store the aggregated bar.
+ * @return 1 if at least one 1-minute bar was found, 0 otherwise.
+ */
+int bar_builder_aggregate(bar_builder *b, int interval_minutes, int64_t end_ms, ohlcv_bar *out)
+{
+  int64_t start_ms = end_ms - interval_minutes * MS_PER_MINUTE;
+  int found = 0;
+
+  bar_reset(out);
+  out->start_ms = start_ms;
+  out->interval_minutes = interval_minutes;
+
+  pthread_mutex_lock(&b->lock);
+
+  // Walk back from the newest bar to the first one inside the interval
+  int n = 0;
+  while (n < b->size)
+  {
+    int ring_idx = (b->tail_idx - 1 - n + b->capacity) % b->capacity;
+    if (b->buffer[ring_idx].start_ms < start_ms)
+      break;
+    n++;
+  }
+
+  // Combine them in chronological order
+  for (int i = n - 1; i >= 0; --i)
+  {
+    const ohlcv_bar *bar = &b->buffer[(b->tail_idx - 1 - i + b->capacity) % b->capacity];
+    if (bar->start_ms >= end_ms)
+      continue;
+
+    if (bar->trade_count > 0)
+    {
+      if (out->trade_count == 0)
+      {
+        out->open = bar->open;
+        out->high = bar->high;
+        out->low = bar->low;
+      }
+      else
+      {
+        if (bar->high > out->high)
+          out->high = bar->high;
+        if (bar->low < out->low)
+          out->low = bar->low;
+      }
+    }
+
+    out->close = bar->close;
+    out->volume += bar->volume;
+    out->notional += bar->notional;
+    out->trade_count += bar->trade_count;
+    found = 1;
+  }
+
+  pthread_mutex_unlock(&b->lock);
+
+  if (found && out->trade_count == 0) // no trades at all: repeat the carried close
+    out->open = out->high = out->low = out->close;
+
+  return found;
+}
+
+/**
+ * @brief Cleans up resources used by a bar_builder.
+ * @param b Pointer to the bar_builder.
+ */
+void bar_builder_cleanup(bar_builder *b)
+{
+  if (b->buffer)
+  {
+    free(b->buffer);
+    b->buffer = NULL;
+    mem_budget_add(MEM_HISTORY, -(int64_t)b->capacity * sizeof(ohlcv_bar));
+  }
+  pthread_mutex_destroy(&b->lock);
+}
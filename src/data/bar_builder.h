@@ -0,0 +1,54 @@
+/**
+ * @file bar_builder.h
+ * @brief OHLCV bar builder operations declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef BAR_BUILDER_H
+#define BAR_BUILDER_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Initializes a bar_builder structure.
+ * @param b Pointer to the bar_builder.
+ * @param capacity The maximum number of closed 1-minute bars to keep.
+ */
+void bar_builder_init(bar_builder *b, int capacity);
+
+/**
+ * @brief Adds a trade to the bar being built (O(1)).
+ * @param b Pointer to the bar_builder.
+ * @param price Price of the trade.
+ * @param size Size of the trade.
+ */
+void bar_builder_add_trade(bar_builder *b, double price, double size);
+
+/**
+ * @brief Closes the current bar as the 1-minute bar ending at `minute_end_ms` and starts a new one.
+ * @details A minute without trades yields a bar with zero volume whose prices repeat the last close.
+ * @param b Pointer to the bar_builder.
+ * @param minute_end_ms End of the minute (the per-minute tick).
+ * @param out Pointer to store the closed bar.
+ */
+void bar_builder_close_minute(bar_builder *b, int64_t minute_end_ms, ohlcv_bar *out);
+
+/**
+ * @brief Aggregates the closed 1-minute bars in [end_ms - interval, end_ms) into one bar.
+ * @param b Pointer to the bar_builder.
+ * @param interval_minutes Bar length in minutes (at most the ring capacity).
+ * @param end_ms End of the interval.
+ * @param out Pointer to store the aggregated bar.
+ * @return 1 if at least one 1-minute bar was found, 0 otherwise.
+ */
+int bar_builder_aggregate(bar_builder *b, int interval_minutes, int64_t end_ms, ohlcv_bar *out);
+
+/**
+ * @brief Cleans up resources used by a bar_builder.
+ * @param b Pointer to the bar_builder.
+ */
+void bar_builder_cleanup(bar_builder *b);
+
+#endif /* BAR_BUILDER_H */
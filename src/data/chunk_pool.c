@@ -0,0 +1,135 @@
+/**
+ * @file chunk_pool.c
+ * @brief Lock-free pool of fixed-size chunks implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "chunk_pool.h"
+
+#include <stdlib.h>
+
+#define POOL_NONE UINT32_MAX /**< index of an empty stack */
+
+/**
+ * @brief Packs a chunk index and an update tag into a stack head.
+ * @param index Chunk index (POOL_NONE if empty).
+ * @param tag Update count.
+ * @return Head word.
+ */
+static inline uint64_t pool_head(uint32_t index, uint32_t tag)
+{
+  return ((uint64_t)tag << 32) | index;
+}
+
+/**
+ * @brief Allocates the pool's memory and puts every chunk on the free list.
+ * @param p Pointer to the chunk_pool.
+ * @param chunk_count Number of chunks.
+ * @param chunk_bytes Size of a chunk.
+ * @return 0 on success, -1 if allocation failed.
+ */
+int chunk_pool_init(chunk_pool *p, uint32_t chunk_count, size_t chunk_bytes)
+{
+  p->base = malloc((size_t)chunk_count * chunk_bytes);
+  p->next = malloc((size_t)chunk_count * sizeof(uint32_t));
+  if (!p->base || !p->next || chunk_count == 0 || chunk_count > INT32_MAX)
+  {
+    free(p->base);
+    free(p->next);
+    p->base = NULL;
+    p->next = NULL;
+    return -1;
+  }
+
+  p->chunk_bytes = chunk_bytes;
+  p->chunk_count = chunk_count;
+  for (uint32_t i = 0; i < chunk_count; ++i)
+    p->next[i] = i + 1 < chunk_count ? i + 1 : POOL_NONE;
+  p->available = (int32_t)chunk_count;
+  p->exhausted = 0;
+  __atomic_store_n(&p->head, pool_head(0, 0), __ATOMIC_RELEASE);
+  return 0;
+}
+
+/**
+ * @brief Takes a chunk from the pool (lock-free, any thread).
+ * @param p Pointer to the chunk_pool.
+ * @return The chunk, or NULL if the pool is empty.
+ */
+void *chunk_pool_alloc(chunk_pool *p)
+{
+  uint64_t head = __atomic_load_n(&p->head, __ATOMIC_ACQUIRE);
+  uint32_t index;
+  do
+  {
+    index = (uint32_t)head;
+    if (index == POOL_NONE)
+    {
+      __atomic_fetch_add(&p->exhausted, 1, __ATOMIC_RELAXED);
+      return NULL;
+    }
+    /* may read the link of a chunk another thread just took: the tag then differs and
+     * the swap fails */
+    uint32_t next = __atomic_load_n(&p->next[index], __ATOMIC_RELAXED);
+    if (__atomic_compare_exchange_n(&p->head, &head, pool_head(next, (uint32_t)(head >> 32) + 1), 1,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+      break;
+  } while (1);
+
+  __atomic_fetch_sub(&p->available, 1, __ATOMIC_RELAXED);
+  return p->base + (size_t)index * p->chunk_bytes;
+}
+
+/**
+ * @brief Returns a chunk to the pool (lock-free, any thread).
+ * @param p Pointer to the chunk_pool.
+ * @param chunk Chunk obtained from chunk_pool_alloc.
+ */
+void chunk_pool_free(chunk_pool *p, void *chunk)
+{
+  uint32_t index = (uint32_t)(((char *)chunk - p->base) / p->chunk_bytes);
+  uint64_t head = __atomic_load_n(&p->head, __ATOMIC_RELAXED);
+  do
+    __atomic_store_n(&p->next[index], (uint32_t)head, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(&p->head, &head, pool_head(index, (uint32_t)(head >> 32) + 1), 1,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED)); // publishes the chunk's contents too
+
+  __atomic_fetch_add(&p->available, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns the number of free chunks (a snapshot, may be stale under contention).
+ * @param p Pointer to the chunk_pool.
+ * @return Free chunks.
+ */
+uint32_t chunk_pool_available(const chunk_pool *p)
+{
+  int32_t available = __atomic_load_n(&p->available, __ATOMIC_RELAXED);
+  return available > 0 ? (uint32_t)available : 0;
+}
+
+/**
+ * @brief Returns the number of allocations that found the pool empty.
+ * @param p Pointer to the chunk_pool.
+ * @return Failed allocations since init.
+ */
+uint64_t chunk_pool_exhausted(const chunk_pool *p)
+{
+  return __atomic_load_n(&p->exhausted, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Releases the pool's memory (once no thread uses it).
+ * @param p Pointer to the chunk_pool.
+ */
+void chunk_pool_cleanup(chunk_pool *p)
+{
+  free(p->base);
+  free(p->next);
+  p->base = NULL;
+  p->next = NULL;
+  p->chunk_count = 0;
+  p->available = 0;
+}
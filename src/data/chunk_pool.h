@@ -0,0 +1,81 @@
+/**
+ * @file chunk_pool.h
+ * @brief Lock-free pool of fixed-size chunks declarations
+ *
+ * One allocation made at startup is carved into equal chunks whose free list is a Treiber
+ * stack. Its head packs the index of the top chunk with a tag that every successful update
+ * increments, so a thread whose view of the stack went stale (the top chunk was taken and
+ * returned in between, the ABA case) fails its compare-and-swap and retries. Chunks are
+ * linked by index rather than by pointer, which keeps the head within one 64-bit word
+ * (LDREXD/STREXD on ARMv6K and later). Allocation and release never block and never call
+ * malloc, and the pool bounds the memory of every user. Kept free of libwebsockets/common.h
+ * so offline tools can include it.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef CHUNK_POOL_H
+#define CHUNK_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A fixed set of equal chunks shared between threads.
+ */
+typedef struct chunk_pool
+{
+  char *base;            /**< chunk_count * chunk_bytes bytes (pages touched on first use) */
+  size_t chunk_bytes;    /**< size of a chunk */
+  uint32_t chunk_count;  /**< number of chunks */
+  uint32_t *next;        /**< free-list link of each chunk, by index */
+  uint64_t head;         /**< (tag << 32) | index of the top free chunk */
+  int32_t available;     /**< free chunks (statistics, updated after the stack: may lag or dip below 0) */
+  uint64_t exhausted;    /**< allocations that found the pool empty */
+} chunk_pool;
+
+/**
+ * @brief Allocates the pool's memory and puts every chunk on the free list.
+ * @param p Pointer to the chunk_pool.
+ * @param chunk_count Number of chunks.
+ * @param chunk_bytes Size of a chunk.
+ * @return 0 on success, -1 if allocation failed.
+ */
+int chunk_pool_init(chunk_pool *p, uint32_t chunk_count, size_t chunk_bytes);
+
+/**
+ * @brief Takes a chunk from the pool (lock-free, any thread).
+ * @param p Pointer to the chunk_pool.
+ * @return The chunk, or NULL if the pool is empty.
+ */
+void *chunk_pool_alloc(chunk_pool *p);
+
+/**
+ * @brief Returns a chunk to the pool (lock-free, any thread).
+ * @param p Pointer to the chunk_pool.
+ * @param chunk Chunk obtained from chunk_pool_alloc.
+ */
+void chunk_pool_free(chunk_pool *p, void *chunk);
+
+/**
+ * @brief Returns the number of free chunks (a snapshot, may be stale under contention).
+ * @param p Pointer to the chunk_pool.
+ * @return Free chunks.
+ */
+uint32_t chunk_pool_available(const chunk_pool *p);
+
+/**
+ * @brief Returns the number of allocations that found the pool empty.
+ * @param p Pointer to the chunk_pool.
+ * @return Failed allocations since init.
+ */
+uint64_t chunk_pool_exhausted(const chunk_pool *p);
+
+/**
+ * @brief Releases the pool's memory (once no thread uses it).
+ * @param p Pointer to the chunk_pool.
+ */
+void chunk_pool_cleanup(chunk_pool *p);
+
+#endif /* CHUNK_POOL_H */
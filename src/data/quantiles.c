@@ -0,0 +1,438 @@
+/**
+ * @file quantiles.c
+ * @brief Sliding-window quantile set implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include "quantiles.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+/* ----------------------------------------------------------------------------
+ * Exact mode: treap with subtree sizes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns the size of a subtree.
+ * @param q Pointer to the quantile_set.
+ * @param t Subtree root (-1 for empty).
+ * @return Number of nodes.
+ */
+static inline uint32_t node_size(const quantile_set *q, int32_t t)
+{
+  return t < 0 ? 0 : q->nodes[t].size;
+}
+
+/**
+ * @brief Recomputes a node's subtree size from its children.
+ * @param q Pointer to the quantile_set.
+ * @param t Node index.
+ */
+static inline void node_update(quantile_set *q, int32_t t)
+{
+  q->nodes[t].size = q->nodes[t].count + node_size(q, q->nodes[t].left) + node_size(q, q->nodes[t].right);
+}
+
+/**
+ * @brief Splits a treap into keys < x and keys >= x.
+ * @param q Pointer to the quantile_set.
+ * @param t Treap root.
+ * @param x Split key.
+ * @param l Output left root.
+ * @param r Output right root.
+ */
+static void treap_split(quantile_set *q, int32_t t, double x, int32_t *l, int32_t *r)
+{
+  if (t < 0)
+  {
+    *l = *r = -1;
+    return;
+  }
+
+  quantile_node *n = &q->nodes[t];
+  if (n->key < x)
+  {
+    treap_split(q, n->right, x, &n->right, r);
+    *l = t;
+  }
+  else
+  {
+    treap_split(q, n->left, x, l, &n->left);
+    *r = t;
+  }
+  node_update(q, t);
+}
+
+/**
+ * @brief Merges two treaps where every key of `l` is <= every key of `r`.
+ * @param q Pointer to the quantile_set.
+ * @param l Left root.
+ * @param r Right root.
+ * @return Merged root.
+ */
+static int32_t treap_merge(quantile_set *q, int32_t l, int32_t r)
+{
+  if (l < 0)
+    return r;
+  if (r < 0)
+    return l;
+
+  if (q->nodes[l].priority > q->nodes[r].priority)
+  {
+    q->nodes[l].right = treap_merge(q, q->nodes[l].right, r);
+    node_update(q, l);
+    return l;
+  }
+
+  q->nodes[r].left = treap_merge(q, l, q->nodes[r].left);
+  node_update(q, r);
+  return r;
+}
+
+/**
+ * @brief Finds the node holding a key.
+ * @param q Pointer to the quantile_set.
+ * @param x Key.
+ * @return Node index, or -1 if absent.
+ */
+static int32_t treap_find(const quantile_set *q, double x)
+{
+  int32_t t = q->root;
+  while (t >= 0 && q->nodes[t].key != x)
+    t = x < q->nodes[t].key ? q->nodes[t].left : q->nodes[t].right;
+  return t;
+}
+
+/**
+ * @brief Changes the multiplicity of a present key and the subtree sizes on its path.
+ * @param q Pointer to the quantile_set.
+ * @param x Key (must be present).
+ * @param delta +1 or -1.
+ */
+static void treap_adjust(quantile_set *q, double x, int delta)
+{
+  int32_t t = q->root;
+  for (;;)
+  {
+    quantile_node *n = &q->nodes[t];
+    n->size += delta;
+    if (n->key == x)
+    {
+      n->count += delta;
+      return;
+    }
+    t = x < n->key ? n->left : n->right;
+  }
+}
+
+/**
+ * @brief Returns the k-th smallest key (0-based).
+ * @param q Pointer to the quantile_set.
+ * @param k Rank, less than the set size.
+ * @return The key.
+ */
+static double treap_select(const quantile_set *q, uint32_t k)
+{
+  int32_t t = q->root;
+  for (;;)
+  {
+    uint32_t left_size = node_size(q, q->nodes[t].left);
+    if (k < left_size)
+      t = q->nodes[t].left;
+    else if (k < left_size + q->nodes[t].count)
+      return q->nodes[t].key;
+    else
+    {
+      k -= left_size + q->nodes[t].count;
+      t = q->nodes[t].right;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------------
+ * Approximate mode: log-bucketed histogram
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Maps a positive value to its bucket.
+ * @param q Pointer to the quantile_set.
+ * @param x Value (> 0).
+ * @return Bucket index in [0, QUANTILE_SKETCH_BUCKETS).
+ */
+static inline int sketch_bucket(const quantile_set *q, double x)
+{
+  int i = (int)ceil(log(x) / q->log_gamma) + QUANTILE_SKETCH_BUCKETS / 2;
+  if (i < 0)
+    return 0;
+  if (i >= QUANTILE_SKETCH_BUCKETS)
+    return QUANTILE_SKETCH_BUCKETS - 1;
+  return i;
+}
+
+/* ----------------------------------------------------------------------------
+ * Public interface
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Returns every node of a subtree to the pool.
+ * @param q Pointer to the quantile_set.
+ * @param t Subtree root.
+ */
+static void treap_release(quantile_set *q, int32_t t)
+{
+  if (t < 0)
+    return;
+  treap_release(q, q->nodes[t].left);
+  treap_release(q, q->nodes[t].right);
+  chunk_pool_free(q->pool, &q->nodes[t]);
+}
+
+/**
+ * @brief Initializes a quantile_set whose nodes come from a pool shared with other sets.
+ * @param q Pointer to the quantile_set.
+ * @param mode QUANTILE_EXACT or QUANTILE_APPROX.
+ * @param nodes Pool of sizeof(quantile_node) chunks.
+ * @return 0 on success, -1 if allocation failed.
+ */
+int quantile_set_init_shared(quantile_set *q, int mode, chunk_pool *nodes)
+{
+  q->mode = mode;
+  q->size = 0;
+  q->nodes = NULL;
+  q->pool = NULL;
+  q->owns_pool = 0;
+  q->nodes_used = 0;
+  q->root = -1;
+  q->rng = 0x9E3779B9u;
+  q->buckets = NULL;
+  q->low_count = 0;
+  q->log_gamma = log((1.0 + QUANTILE_SKETCH_ALPHA) / (1.0 - QUANTILE_SKETCH_ALPHA));
+
+  if (mode == QUANTILE_APPROX)
+  {
+    q->buckets = calloc(QUANTILE_SKETCH_BUCKETS, sizeof(uint32_t));
+    return q->buckets ? 0 : -1;
+  }
+
+  if (!nodes || nodes->chunk_bytes != sizeof(quantile_node))
+    return -1;
+  q->pool = nodes;
+  q->nodes = (quantile_node *)nodes->base;
+  return 0;
+}
+
+/**
+ * @brief Initializes a quantile_set with a node pool of its own.
+ * @param q Pointer to the quantile_set.
+ * @param mode QUANTILE_EXACT or QUANTILE_APPROX.
+ * @param capacity Maximum number of distinct values held at once (exact mode).
+ * @return 0 on success, -1 if allocation failed.
+ */
+int quantile_set_init(quantile_set *q, int mode, uint32_t capacity)
+{
+  if (mode == QUANTILE_APPROX)
+    return quantile_set_init_shared(q, mode, NULL);
+
+  chunk_pool *pool = malloc(sizeof(chunk_pool));
+  if (!pool || chunk_pool_init(pool, capacity, sizeof(quantile_node)) < 0)
+  {
+    free(pool);
+    return -1;
+  }
+  if (quantile_set_init_shared(q, mode, pool) < 0)
+  {
+    chunk_pool_cleanup(pool);
+    free(pool);
+    return -1;
+  }
+  q->owns_pool = 1;
+  return 0;
+}
+
+/**
+ * @brief Inserts a value.
+ * @param q Pointer to the quantile_set.
+ * @param x Value to insert.
+ * @return 1 on success, 0 if the set is full.
+ */
+int quantile_set_insert(quantile_set *q, double x)
+{
+  if (q->mode == QUANTILE_APPROX)
+  {
+    if (x > 0)
+      q->buckets[sketch_bucket(q, x)]++;
+    else
+      q->low_count++;
+    q->size++;
+    return 1;
+  }
+
+  // Repeated key: one descent
+  if (treap_find(q, x) >= 0)
+  {
+    treap_adjust(q, x, 1);
+    q->size++;
+    return 1;
+  }
+
+  quantile_node *n = chunk_pool_alloc(q->pool);
+  if (!n)
+    return 0;
+  int32_t t = (int32_t)(n - q->nodes);
+  q->nodes_used++;
+
+  // xorshift32 priority
+  q->rng ^= q->rng << 13;
+  q->rng ^= q->rng >> 17;
+  q->rng ^= q->rng << 5;
+
+  n->key = x;
+  n->priority = q->rng;
+  n->left = n->right = -1;
+  n->count = n->size = 1;
+
+  // Descend while the path outranks the new node, then split the subtree below it
+  int32_t *link = &q->root;
+  while (*link >= 0 && q->nodes[*link].priority > n->priority)
+  {
+    quantile_node *c = &q->nodes[*link];
+    c->size++;
+    link = x < c->key ? &c->left : &c->right;
+  }
+
+  treap_split(q, *link, x, &n->left, &n->right);
+  node_update(q, t);
+  *link = t;
+  q->size++;
+  return 1;
+}
+
+/**
+ * @brief Removes one occurrence of a value previously inserted.
+ * @param q Pointer to the quantile_set.
+ * @param x Value to remove.
+ * @return 1 if removed, 0 if not found.
+ */
+int quantile_set_remove(quantile_set *q, double x)
+{
+  if (q->mode == QUANTILE_APPROX)
+  {
+    uint32_t *count = x > 0 ? &q->buckets[sketch_bucket(q, x)] : &q->low_count;
+    if (*count == 0)
+      return 0;
+    (*count)--;
+    q->size--;
+    return 1;
+  }
+
+  int32_t t = treap_find(q, x);
+  if (t < 0)
+    return 0;
+
+  q->size--;
+  if (q->nodes[t].count > 1)
+  {
+    treap_adjust(q, x, -1);
+    return 1;
+  }
+
+  // Last occurrence: replace the node by the merge of its children and free it
+  int32_t *link = &q->root;
+  while (*link != t)
+  {
+    quantile_node *c = &q->nodes[*link];
+    c->size--;
+    link = x < c->key ? &c->left : &c->right;
+  }
+
+  *link = treap_merge(q, q->nodes[t].left, q->nodes[t].right);
+  chunk_pool_free(q->pool, &q->nodes[t]);
+  q->nodes_used--;
+  return 1;
+}
+
+/**
+ * @brief Returns the p-quantile of the values held.
+ * @details Exact mode interpolates linearly between the closest ranks (as numpy/pandas
+ * do); approximate mode returns the representative of the bucket holding rank p*(n-1).
+ * @param q Pointer to the quantile_set.
+ * @param p Quantile level in [0, 1].
+ * @return The quantile, or NAN if the set is empty.
+ */
+double quantile_set_query(const quantile_set *q, double p)
+{
+  if (q->size == 0)
+    return NAN;
+
+  if (p < 0)
+    p = 0;
+  if (p > 1)
+    p = 1;
+
+  double h = p * (q->size - 1);
+
+  if (q->mode == QUANTILE_APPROX)
+  {
+    uint64_t rank = (uint64_t)h;
+    uint64_t seen = q->low_count;
+    if (rank < seen)
+      return 0.0;
+
+    for (int i = 0; i < QUANTILE_SKETCH_BUCKETS; ++i)
+    {
+      seen += q->buckets[i];
+      if (seen > rank)
+        return 2.0 * exp((i - QUANTILE_SKETCH_BUCKETS / 2) * q->log_gamma) / (1.0 + exp(q->log_gamma));
+    }
+    return NAN; // unreachable while counts are consistent
+  }
+
+  uint32_t lo = (uint32_t)h;
+  double lo_val = treap_select(q, lo);
+  if (lo + 1 >= q->size || h == lo)
+    return lo_val;
+
+  return lo_val + (h - lo) * (treap_select(q, lo + 1) - lo_val);
+}
+
+/**
+ * @brief Approximate memory allocated by a quantile_set itself, in bytes.
+ * @param q Pointer to the quantile_set.
+ * @return Bytes allocated for an own node pool or buckets.
+ */
+size_t quantile_set_memory(const quantile_set *q)
+{
+  if (q->mode == QUANTILE_APPROX)
+    return QUANTILE_SKETCH_BUCKETS * sizeof(uint32_t);
+  if (!q->owns_pool)
+    return 0;
+  return (size_t)q->pool->chunk_count * sizeof(quantile_node);
+}
+
+/**
+ * @brief Releases the memory of a quantile_set, returning its nodes to a shared pool.
+ * @param q Pointer to the quantile_set.
+ */
+void quantile_set_cleanup(quantile_set *q)
+{
+  if (q->owns_pool)
+  {
+    chunk_pool_cleanup(q->pool);
+    free(q->pool);
+  }
+  else if (q->pool)
+    treap_release(q, q->root);
+  free(q->buckets);
+  q->nodes = NULL;
+  q->pool = NULL;
+  q->owns_pool = 0;
+  q->nodes_used = 0;
+  q->buckets = NULL;
+  q->size = 0;
+  q->root = -1;
+}
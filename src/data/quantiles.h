@@ -0,0 +1,129 @@
+/**
+ * @file quantiles.h
+ * @brief Sliding-window quantile set declarations
+ *
+ * A multiset of doubles supporting insert, delete and quantile queries. The exact mode is
+ * a treap of distinct keys with multiplicities and subtree sizes (O(log n) per operation,
+ * a plain descent when the key is already present) whose nodes come from a chunk_pool,
+ * either the set's own or one shared by several sets that it then bounds together; the
+ * approximate mode is a log-bucketed histogram with relative error QUANTILE_SKETCH_ALPHA
+ * (O(1) updates, fixed memory), intended for very high-rate symbols.
+ * Kept free of libwebsockets/common.h so offline tools can include it (with chunk_pool.c).
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef QUANTILES_H
+#define QUANTILES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "chunk_pool.h"
+
+/* Quantile set modes */
+#define QUANTILE_EXACT 0  /**< order-statistics treap, exact results */
+#define QUANTILE_APPROX 1 /**< log-bucketed sketch, bounded memory */
+
+#define QUANTILE_SKETCH_ALPHA 0.01  /**< relative accuracy of the approximate mode */
+#define QUANTILE_SKETCH_BUCKETS 4096 /**< buckets of the approximate mode (covers ~1e-18 .. 1e17) */
+
+/**
+ * @brief A treap node holding one distinct key (one chunk of the node pool).
+ */
+typedef struct
+{
+  double key;
+  uint32_t priority;
+  int32_t left;
+  int32_t right;
+  uint32_t count; /**< multiplicity of the key (tick-sized prices repeat a lot) */
+  uint32_t size;  /**< values in this subtree, multiplicities included */
+} quantile_node;
+
+/**
+ * @brief A multiset of doubles with quantile queries.
+ */
+struct quantile_set
+{
+  int mode;      /**< QUANTILE_EXACT or QUANTILE_APPROX */
+  uint32_t size; /**< number of values held */
+
+  /* exact mode */
+  quantile_node *nodes;     /**< node storage (the pool's base), addressed by index */
+  chunk_pool *pool;         /**< where nodes come from and return to */
+  int owns_pool;            /**< pool allocated by quantile_set_init, released with the set */
+  uint32_t nodes_used;      /**< nodes currently taken from the pool (distinct keys) */
+  int32_t root;             /**< treap root (-1 if empty) */
+  uint32_t rng;             /**< xorshift state for priorities */
+
+  /* approximate mode */
+  uint32_t *buckets;   /**< counts per log bucket */
+  uint32_t low_count;  /**< values <= 0 (not expected for prices or sizes) */
+  double log_gamma;    /**< log((1 + alpha) / (1 - alpha)) */
+};
+typedef struct quantile_set quantile_set;
+
+/**
+ * @brief Initializes a quantile_set with a node pool of its own.
+ * @param q Pointer to the quantile_set.
+ * @param mode QUANTILE_EXACT or QUANTILE_APPROX.
+ * @param capacity Maximum number of distinct values held at once (exact mode).
+ * @return 0 on success, -1 if allocation failed.
+ */
+int quantile_set_init(quantile_set *q, int mode, uint32_t capacity);
+
+/**
+ * @brief Initializes a quantile_set whose nodes come from a pool shared with other sets.
+ * @details Taking and returning a node is lock-free, so sets on different threads may
+ * share the pool. Approximate mode ignores the pool.
+ * @param q Pointer to the quantile_set.
+ * @param mode QUANTILE_EXACT or QUANTILE_APPROX.
+ * @param nodes Pool of sizeof(quantile_node) chunks.
+ * @return 0 on success, -1 if allocation failed.
+ */
+int quantile_set_init_shared(quantile_set *q, int mode, chunk_pool *nodes);
+
+/**
+ * @brief Inserts a value.
+ * @param q Pointer to the quantile_set.
+ * @param x Value to insert.
+ * @return 1 on success, 0 if the node pool is empty.
+ */
+int quantile_set_insert(quantile_set *q, double x);
+
+/**
+ * @brief Removes one occurrence of a value previously inserted.
+ * @param q Pointer to the quantile_set.
+ * @param x Value to remove.
+ * @return 1 if removed, 0 if not found.
+ */
+int quantile_set_remove(quantile_set *q, double x);
+
+/**
+ * @brief Returns the p-quantile of the values held.
+ * @details Exact mode interpolates linearly between the closest ranks (as numpy/pandas
+ * do); approximate mode returns the representative of the bucket holding rank p*(n-1).
+ * @param q Pointer to the quantile_set.
+ * @param p Quantile level in [0, 1].
+ * @return The quantile, or NAN if the set is empty.
+ */
+double quantile_set_query(const quantile_set *q, double p);
+
+/**
+ * @brief Approximate memory allocated by a quantile_set itself, in bytes.
+ * @details Nodes of a shared pool are not included: they are accounted with the pool
+ * (`nodes_used` tells how many the set holds).
+ * @param q Pointer to the quantile_set.
+ * @return Bytes allocated for an own node pool or buckets.
+ */
+size_t quantile_set_memory(const quantile_set *q);
+
+/**
+ * @brief Releases the memory of a quantile_set, returning its nodes to a shared pool.
+ * @param q Pointer to the quantile_set.
+ */
+void quantile_set_cleanup(quantile_set *q);
+
+#endif /* QUANTILES_H */
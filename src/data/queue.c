@@ -7,6 +7,7 @@
  */
 
 #include "queue.h"
+#include "../utils/mem_budget.h"
 
 /**
  * @brief Initializes a raw trade queue.
@@ -24,8 +25,11 @@ void raw_queue_init(raw_trade_queue *q, uint32_t capacity)
     exit(1);
   }
 
+  mem_budget_add(MEM_QUEUE, (int64_t)capacity * sizeof(raw_trade_message));
+
   q->capacity = capacity;
   q->head_idx = q->tail_idx = 0;
+  q->closed = 0;
   pthread_mutex_init(&q->lock, NULL);
   pthread_cond_init(&q->cond_not_empty, NULL);
 }
@@ -33,7 +37,8 @@ void raw_queue_init(raw_trade_queue *q, uint32_t capacity)
 /**
  * @brief Pushes a raw trade message to the queue.
  * @details If the queue is full, the oldest message is overwritten. This is a
- * non-blocking strategy suitable for high-throughput data streams.
+ * non-blocking strategy suitable for high-throughput data streams. Messages pushed
+ * after the queue was closed are discarded.
  * @param q Pointer to the raw_trade_queue structure.
  * @param msg Pointer to the raw_trade_message to push.
  */
@@ -41,6 +46,12 @@ void raw_queue_push(raw_trade_queue *queue, const raw_trade_message *msg_in)
 {
   pthread_mutex_lock(&queue->lock);
 
+  if (queue->closed)
+  {
+    pthread_mutex_unlock(&queue->lock);
+    return; // shutting down: nobody will drain it
+  }
+
   while (((queue->tail_idx + 1) % queue->capacity) == queue->head_idx)
   {
     // queue full: drop oldest trade
@@ -56,21 +67,23 @@ void raw_queue_push(raw_trade_queue *queue, const raw_trade_message *msg_in)
 
 /**
  * @brief Pops a message from the raw trade queue.
- * @details Blocks if the queue is empty until a message is available or shutdown is requested.
+ * @details Blocks if the queue is empty until a message is available, the queue is closed
+ * or shutdown is requested.
  * @param q Pointer to the raw_trade_queue structure.
  * @param out Pointer to a raw_trade_message to store the popped message.
- * @return 1 if a message was popped, 0 if the queue is empty and shutdown is initiated.
+ * @return 1 if a message was popped, 0 if the queue is empty and closed or shutdown is initiated.
  */
 int raw_queue_pop(raw_trade_queue *queue, raw_trade_message *msg_out)
 {
   pthread_mutex_lock(&queue->lock);
 
-  while (queue->head_idx == queue->tail_idx && !shutdown_requested)
+  while (queue->head_idx == queue->tail_idx && !queue->closed &&
+         !__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
   { // Check if queue is empty
     pthread_cond_wait(&queue->cond_not_empty, &queue->lock);
   }
 
-  if (shutdown_requested && queue->head_idx == queue->tail_idx)
+  if (queue->head_idx == queue->tail_idx)
   {
     pthread_mutex_unlock(&queue->lock);
     return 0; // Queue is empty and we are exiting
@@ -84,6 +97,36 @@ int raw_queue_pop(raw_trade_queue *queue, raw_trade_message *msg_out)
   return 1;
 }
 
+/**
+ * @brief Returns the number of messages currently queued.
+ * @param q Pointer to the raw_trade_queue structure.
+ * @return Number of queued messages.
+ */
+uint32_t raw_queue_size(raw_trade_queue *q)
+{
+  pthread_mutex_lock(&q->lock);
+  uint32_t size = (q->tail_idx + q->capacity - q->head_idx) % q->capacity;
+  pthread_mutex_unlock(&q->lock);
+
+  return size;
+}
+
+/**
+ * @brief Marks the queue closed: once it is empty, pops return 0 instead of waiting.
+ * @param q Pointer to the raw_trade_queue structure.
+ * @return Number of messages still queued.
+ */
+uint32_t raw_queue_close(raw_trade_queue *q)
+{
+  pthread_mutex_lock(&q->lock);
+  q->closed = 1;
+  uint32_t size = (q->tail_idx + q->capacity - q->head_idx) % q->capacity;
+  pthread_cond_broadcast(&q->cond_not_empty);
+  pthread_mutex_unlock(&q->lock);
+
+  return size;
+}
+
 /**
  * @brief Cleans up resources used by a raw_trade_queue.
  * @param q Pointer to the raw_trade_queue.
@@ -94,6 +137,7 @@ void trade_queue_cleanup(raw_trade_queue *q)
   {
     free(q->buffer);
     q->buffer = NULL;
+    mem_budget_add(MEM_QUEUE, -(int64_t)q->capacity * sizeof(raw_trade_message));
   }
   pthread_mutex_destroy(&q->lock);
   pthread_cond_destroy(&q->cond_not_empty);
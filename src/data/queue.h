@@ -21,7 +21,8 @@ void raw_queue_init(raw_trade_queue *q, uint32_t capacity);
 /**
  * @brief Pushes a raw trade message to the queue.
  * @details If the queue is full, the oldest message is overwritten. This is a
- * non-blocking strategy suitable for high-throughput data streams.
+ * non-blocking strategy suitable for high-throughput data streams. Messages pushed
+ * after the queue was closed are discarded.
  * @param q Pointer to the raw_trade_queue structure.
  * @param msg Pointer to the raw_trade_message to push.
  */
@@ -36,6 +37,20 @@ void raw_queue_push(raw_trade_queue *queue, const raw_trade_message *msg_in);
  */
 int raw_queue_pop(raw_trade_queue *queue, raw_trade_message *msg_out);
 
+/**
+ * @brief Returns the number of messages currently queued.
+ * @param q Pointer to the raw_trade_queue structure.
+ * @return Number of queued messages.
+ */
+uint32_t raw_queue_size(raw_trade_queue *q);
+
+/**
+ * @brief Marks the queue closed: once it is empty, pops return 0 instead of waiting.
+ * @param q Pointer to the raw_trade_queue structure.
+ * @return Number of messages still queued.
+ */
+uint32_t raw_queue_close(raw_trade_queue *q);
+
 /**
  * @brief Cleans up resources used by a raw_trade_queue.
  * @param q Pointer to the raw_trade_queue.
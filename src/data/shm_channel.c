@@ -0,0 +1,435 @@
+/**
+ * @file shm_channel.c
+ * @brief Shared-memory channel between the ingest and analytics processes implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include "shm_channel.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHM_CHANNEL_MAGIC 0x4f4b58434847ULL /**< "OKXCHG", written last by the creator */
+#define SHM_CHANNEL_VERSION 2
+#define SHM_CACHE_LINE 64
+#define SHM_READ_ATTEMPTS 1000 /**< seqlock retries before a snapshot read gives up */
+
+/**
+ * @brief Shared header. Producer and consumer indices live on separate cache lines.
+ */
+struct shm_channel_header
+{
+  uint64_t magic;       /**< SHM_CHANNEL_MAGIC once initialized */
+  uint32_t version;     /**< SHM_CHANNEL_VERSION */
+  uint32_t trade_size;  /**< sizeof(shm_trade) of the creator's build */
+  uint32_t capacity;    /**< ring slots (power of two) */
+  int32_t vwap_rows;    /**< snapshot rows */
+  int32_t vwap_width;   /**< VWAPs per snapshot row */
+  int32_t producer_pid; /**< ingest process */
+  sem_t wakeup;         /**< posted by the producer when the consumer sleeps */
+
+  /* producer cache line */
+  uint64_t head __attribute__((aligned(SHM_CACHE_LINE))); /**< trades ever appended */
+  uint64_t dropped;                                        /**< trades dropped on a full ring */
+
+  /* consumer cache line */
+  uint64_t tail __attribute__((aligned(SHM_CACHE_LINE))); /**< trades ever taken */
+  uint32_t consumer_waiting;                               /**< nonzero while the consumer sleeps */
+  int32_t consumer_pid;                                    /**< analytics process (informational) */
+
+  /* VWAP snapshot, written by the consumer side */
+  uint32_t vwap_seq __attribute__((aligned(SHM_CACHE_LINE))); /**< seqlock: odd while a row is written */
+  uint32_t vwap_count;                                         /**< valid rows */
+  uint32_t vwap_next;                                          /**< slot of the next row */
+};
+
+/**
+ * @brief Computes the offsets of the ring and snapshot arrays in the mapping.
+ * @param capacity Ring slots.
+ * @param rows Snapshot rows.
+ * @param width Snapshot width.
+ * @param slots_off Pointer to store the ring offset.
+ * @param ts_off Pointer to store the snapshot timestamps offset.
+ * @param vwap_off Pointer to store the snapshot rows offset.
+ * @param names_off Pointer to store the snapshot names offset.
+ * @return Total size of the mapping.
+ */
+static size_t channel_layout(uint32_t capacity, int rows, int width, size_t *slots_off, size_t *ts_off,
+                             size_t *vwap_off, size_t *names_off)
+{
+  size_t off = (sizeof(struct shm_channel_header) + SHM_CACHE_LINE - 1) / SHM_CACHE_LINE * SHM_CACHE_LINE;
+  *slots_off = off;
+  off += (size_t)capacity * sizeof(shm_trade);
+  *ts_off = off;
+  off += (size_t)rows * sizeof(int64_t);
+  *vwap_off = off;
+  off += (size_t)rows * width * sizeof(double);
+  *names_off = off;
+  off += (size_t)width * SHM_SYMBOL_MAX;
+  return off;
+}
+
+/**
+ * @brief Points a mapping's array pointers into a mapped region.
+ * @param ch Pointer to the shm_channel.
+ * @param base Start of the mapping.
+ * @param capacity Ring slots.
+ * @param rows Snapshot rows.
+ * @param width Snapshot width.
+ */
+static void channel_bind(shm_channel *ch, void *base, uint32_t capacity, int rows, int width)
+{
+  size_t slots_off, ts_off, vwap_off, names_off;
+  ch->map_bytes = channel_layout(capacity, rows, width, &slots_off, &ts_off, &vwap_off, &names_off);
+  ch->hdr = (struct shm_channel_header *)base;
+  ch->slots = (shm_trade *)((char *)base + slots_off);
+  ch->vwap_ts = (int64_t *)((char *)base + ts_off);
+  ch->vwap = (double *)((char *)base + vwap_off);
+  ch->vwap_names = (char *)base + names_off;
+}
+
+/**
+ * @brief Creates (or replaces) the channel; called by the ingest process.
+ * @param ch Pointer to the shm_channel.
+ * @param name Shared memory object name (e.g. "/okx-trader").
+ * @param capacity Trades in the ring (power of two).
+ * @param vwap_rows Rows kept in the VWAP snapshot.
+ * @param vwap_width VWAPs per row (symbols).
+ * @return 0 on success, -1 on error.
+ */
+int shm_channel_create(shm_channel *ch, const char *name, uint32_t capacity, int vwap_rows, int vwap_width)
+{
+  memset(ch, 0, sizeof(*ch));
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0 || vwap_rows < 1 || vwap_width < 1)
+  {
+    fprintf(stderr, "ERROR: Invalid shared memory channel layout (ring capacity must be a power of two)\n");
+    return -1;
+  }
+
+  size_t slots_off, ts_off, vwap_off, names_off;
+  size_t bytes = channel_layout(capacity, vwap_rows, vwap_width, &slots_off, &ts_off, &vwap_off, &names_off);
+
+  shm_unlink(name); // a previous ingest's region: its consumer follows that process out
+  int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0 || ftruncate(fd, (off_t)bytes) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to create shared memory %s (%.2f MB): %s\n", name, bytes / (1024.0 * 1024.0),
+            strerror(errno));
+    if (fd >= 0)
+    {
+      close(fd);
+      shm_unlink(name);
+    }
+    return -1;
+  }
+
+  void *base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+  {
+    fprintf(stderr, "ERROR: Failed to map shared memory %s: %s\n", name, strerror(errno));
+    shm_unlink(name);
+    return -1;
+  }
+
+  channel_bind(ch, base, capacity, vwap_rows, vwap_width);
+  snprintf(ch->name, sizeof(ch->name), "%s", name);
+  ch->owner = 1;
+
+  /* the object starts zero-filled: indices, counters and the snapshot are empty */
+  struct shm_channel_header *hdr = ch->hdr;
+  hdr->version = SHM_CHANNEL_VERSION;
+  hdr->trade_size = sizeof(shm_trade);
+  hdr->capacity = capacity;
+  hdr->vwap_rows = vwap_rows;
+  hdr->vwap_width = vwap_width;
+  hdr->producer_pid = (int32_t)getpid();
+  if (sem_init(&hdr->wakeup, 1, 0) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to initialize shared semaphore: %s\n", strerror(errno));
+    shm_channel_close(ch);
+    return -1;
+  }
+  __atomic_store_n(&hdr->magic, SHM_CHANNEL_MAGIC, __ATOMIC_RELEASE); // attachable from here on
+  return 0;
+}
+
+/**
+ * @brief Attaches to an existing channel as its consumer; called by the analytics process.
+ * @param ch Pointer to the shm_channel.
+ * @param name Shared memory object name.
+ * @param capacity Expected ring capacity.
+ * @param vwap_rows Expected snapshot rows.
+ * @param vwap_width Expected snapshot width.
+ * @return 0 on success, -1 if the channel does not exist yet, -2 if it has another layout.
+ */
+int shm_channel_attach(shm_channel *ch, const char *name, uint32_t capacity, int vwap_rows, int vwap_width)
+{
+  memset(ch, 0, sizeof(*ch));
+  size_t slots_off, ts_off, vwap_off, names_off;
+  size_t bytes = channel_layout(capacity, vwap_rows, vwap_width, &slots_off, &ts_off, &vwap_off, &names_off);
+
+  int fd = shm_open(name, O_RDWR, 0);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(struct shm_channel_header))
+  {
+    close(fd);
+    return -1; // still being created
+  }
+
+  void *base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    return -1;
+
+  struct shm_channel_header *hdr = (struct shm_channel_header *)base;
+  if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_CHANNEL_MAGIC)
+  {
+    munmap(base, (size_t)st.st_size);
+    return -1;
+  }
+  if (hdr->version != SHM_CHANNEL_VERSION || hdr->trade_size != sizeof(shm_trade) || hdr->capacity != capacity ||
+      hdr->vwap_rows != vwap_rows || hdr->vwap_width != vwap_width || (size_t)st.st_size != bytes)
+  {
+    munmap(base, (size_t)st.st_size);
+    return -2;
+  }
+
+  channel_bind(ch, base, capacity, vwap_rows, vwap_width);
+  snprintf(ch->name, sizeof(ch->name), "%s", name);
+  hdr->consumer_pid = (int32_t)getpid();
+
+  /* a previous analytics process died while writing a row: drop the snapshot */
+  uint32_t seq = __atomic_load_n(&hdr->vwap_seq, __ATOMIC_ACQUIRE);
+  if (seq & 1)
+  {
+    hdr->vwap_count = hdr->vwap_next = 0;
+    __atomic_store_n(&hdr->vwap_seq, seq + 1, __ATOMIC_RELEASE);
+  }
+  return 0;
+}
+
+/**
+ * @brief Appends a trade to the ring (producer only), waking the consumer if it sleeps.
+ * @param ch Pointer to the shm_channel.
+ * @param trade Trade to append.
+ * @return 1 if appended, 0 if the ring was full and the trade was dropped.
+ */
+int shm_channel_push(shm_channel *ch, const shm_trade *trade)
+{
+  struct shm_channel_header *hdr = ch->hdr;
+  uint64_t head = hdr->head; // only this process writes it
+  uint64_t tail = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+  if (head - tail >= hdr->capacity)
+  {
+    __atomic_store_n(&hdr->dropped, hdr->dropped + 1, __ATOMIC_RELAXED);
+    return 0;
+  }
+
+  ch->slots[head & (hdr->capacity - 1)] = *trade;
+  __atomic_store_n(&hdr->head, head + 1, __ATOMIC_RELEASE);
+
+  /* pairs with the fence in shm_channel_wait: either the consumer sees the new head, or we see it waiting */
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&hdr->consumer_waiting, __ATOMIC_RELAXED))
+  {
+    __atomic_store_n(&hdr->consumer_waiting, 0, __ATOMIC_RELAXED);
+    sem_post(&hdr->wakeup);
+  }
+  return 1;
+}
+
+/**
+ * @brief Returns the number of free ring slots (exact for the producer, a lower bound otherwise).
+ * @param ch Pointer to the shm_channel.
+ * @return Free slots.
+ */
+uint32_t shm_channel_space(const shm_channel *ch)
+{
+  const struct shm_channel_header *hdr = ch->hdr;
+  uint64_t used = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+  return hdr->capacity - (uint32_t)used;
+}
+
+/**
+ * @brief Takes the oldest trade from the ring (consumer only).
+ * @param ch Pointer to the shm_channel.
+ * @param trade Pointer to store the trade.
+ * @return 1 if a trade was taken, 0 if the ring is empty.
+ */
+int shm_channel_pop(shm_channel *ch, shm_trade *trade)
+{
+  struct shm_channel_header *hdr = ch->hdr;
+  uint64_t tail = hdr->tail; // only this process writes it
+  if (tail == __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE))
+    return 0;
+
+  *trade = ch->slots[tail & (hdr->capacity - 1)];
+  __atomic_store_n(&hdr->tail, tail + 1, __ATOMIC_RELEASE); // the slot may be reused from here on
+  return 1;
+}
+
+/**
+ * @brief Sleeps until the producer appends a trade or the timeout expires (consumer only).
+ * @param ch Pointer to the shm_channel.
+ * @param timeout_ms Maximum wait.
+ * @return 1 if trades are available, 0 on timeout.
+ */
+int shm_channel_wait(shm_channel *ch, int timeout_ms)
+{
+  struct shm_channel_header *hdr = ch->hdr;
+  if (__atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE) != hdr->tail)
+    return 1;
+
+  __atomic_store_n(&hdr->consumer_waiting, 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE) == hdr->tail)
+  {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    while (sem_timedwait(&hdr->wakeup, &deadline) < 0 && errno == EINTR)
+      ;
+  }
+  __atomic_store_n(&hdr->consumer_waiting, 0, __ATOMIC_RELAXED);
+
+  return __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE) != hdr->tail;
+}
+
+/**
+ * @brief Tells whether the process that created the channel is still running.
+ * @param ch Pointer to the shm_channel.
+ * @return 1 if alive, 0 otherwise.
+ */
+int shm_channel_producer_alive(const shm_channel *ch)
+{
+  return kill((pid_t)ch->hdr->producer_pid, 0) == 0 || errno == EPERM;
+}
+
+/**
+ * @brief Returns the number of trades dropped because the ring was full.
+ * @param ch Pointer to the shm_channel.
+ * @return Dropped trades since the channel was created.
+ */
+uint64_t shm_channel_dropped(const shm_channel *ch)
+{
+  return __atomic_load_n(&ch->hdr->dropped, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Appends a VWAP row to the snapshot (single writer: the analytics process).
+ * @param ch Pointer to the shm_channel.
+ * @param minute_ts_ms Minute of the row.
+ * @param row `vwap_width` VWAPs.
+ */
+void shm_channel_publish_vwap(shm_channel *ch, int64_t minute_ts_ms, const double *row)
+{
+  struct shm_channel_header *hdr = ch->hdr;
+  uint32_t seq = hdr->vwap_seq;
+  __atomic_store_n(&hdr->vwap_seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE); // readers that see the row also see the odd sequence
+
+  uint32_t slot = hdr->vwap_next;
+  ch->vwap_ts[slot] = minute_ts_ms;
+  memcpy(&ch->vwap[(size_t)slot * hdr->vwap_width], row, (size_t)hdr->vwap_width * sizeof(double));
+  hdr->vwap_next = (slot + 1) % (uint32_t)hdr->vwap_rows;
+  if (hdr->vwap_count < (uint32_t)hdr->vwap_rows)
+    hdr->vwap_count++;
+
+  __atomic_store_n(&hdr->vwap_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Labels the snapshot columns (single writer: the analytics process).
+ * @param ch Pointer to the shm_channel.
+ * @param names `vwap_width` names, `stride` bytes apart ("" for an unused column).
+ * @param stride Distance between names.
+ */
+void shm_channel_publish_names(shm_channel *ch, const char *names, size_t stride)
+{
+  struct shm_channel_header *hdr = ch->hdr;
+  uint32_t seq = hdr->vwap_seq;
+  __atomic_store_n(&hdr->vwap_seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  for (int c = 0; c < hdr->vwap_width; ++c)
+    snprintf(&ch->vwap_names[(size_t)c * SHM_SYMBOL_MAX], SHM_SYMBOL_MAX, "%s", names + (size_t)c * stride);
+
+  __atomic_store_n(&hdr->vwap_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copies the newest VWAP rows of the snapshot, oldest first, and the column names.
+ * @param ch Pointer to the shm_channel.
+ * @param max_rows Maximum rows to copy.
+ * @param minute_ts_ms Output, one timestamp per row.
+ * @param vwap Output, `vwap_width` VWAPs per row.
+ * @param names Output, `vwap_width` names of SHM_SYMBOL_MAX bytes.
+ * @return Number of rows copied, or -1 if no consistent copy could be taken.
+ */
+int shm_channel_read_vwap(const shm_channel *ch, int max_rows, int64_t *minute_ts_ms, double *vwap, char *names)
+{
+  const struct shm_channel_header *hdr = ch->hdr;
+  int rows = hdr->vwap_rows, width = hdr->vwap_width;
+
+  for (int attempt = 0; attempt < SHM_READ_ATTEMPTS; ++attempt)
+  {
+    uint32_t seq = __atomic_load_n(&hdr->vwap_seq, __ATOMIC_ACQUIRE);
+    if (seq & 1)
+    {
+      sched_yield(); // a row is being written
+      continue;
+    }
+
+    int count = (int)hdr->vwap_count, next = (int)hdr->vwap_next;
+    int n = count < max_rows ? count : max_rows;
+    for (int r = 0; r < n; ++r)
+    {
+      int slot = (next - n + r + rows) % rows;
+      minute_ts_ms[r] = ch->vwap_ts[slot];
+      memcpy(&vwap[(size_t)r * width], &ch->vwap[(size_t)slot * width], (size_t)width * sizeof(double));
+    }
+    memcpy(names, ch->vwap_names, (size_t)width * SHM_SYMBOL_MAX);
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE); // the copy is complete before the sequence is checked
+    if (__atomic_load_n(&hdr->vwap_seq, __ATOMIC_RELAXED) == seq)
+      return n;
+  }
+  return -1;
+}
+
+/**
+ * @brief Unmaps the channel; the creating process also removes it.
+ * @param ch Pointer to the shm_channel.
+ */
+void shm_channel_close(shm_channel *ch)
+{
+  if (!ch->hdr)
+    return;
+  munmap(ch->hdr, ch->map_bytes);
+  if (ch->owner)
+    shm_unlink(ch->name);
+  ch->hdr = NULL;
+}
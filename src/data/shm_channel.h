@@ -0,0 +1,156 @@
+/**
+ * @file shm_channel.h
+ * @brief Shared-memory channel between the ingest and analytics processes declarations
+ *
+ * One POSIX shared memory object holds a single-producer/single-consumer ring of normalized
+ * trades (written by the ingest process, read by the analytics process) and a snapshot of the
+ * newest VWAP rows (written by analytics under a seqlock, readable by anyone). The ring never
+ * blocks the producer: when analytics is slow or down, new trades are dropped and counted.
+ * Indices survive the consumer, so a restarted analytics process resumes where the previous
+ * one stopped and reloads its VWAP history from the snapshot. Trades and snapshot columns are
+ * labelled with instrument names, since each process maps names to slots from its own config.
+ * Kept free of libwebsockets/common.h so offline tools can include it.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef SHM_CHANNEL_H
+#define SHM_CHANNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHM_SYMBOL_MAX 28 /**< instrument name bytes in a trade (>= SYMBOL_NAME_MAX) */
+
+/**
+ * @brief A parsed trade as passed between processes (no raw JSON).
+ */
+typedef struct
+{
+  int64_t exchange_ts_ms; /**< exchange trade timestamp */
+  int64_t receive_ts_ms;  /**< local receive timestamp */
+  double price;           /**< trade price */
+  double size;            /**< trade size */
+  int32_t side;           /**< TRADE_SIDE_* */
+  char symbol[SHM_SYMBOL_MAX]; /**< instrument id, NUL-terminated */
+} shm_trade;
+
+struct shm_channel_header;
+
+/**
+ * @brief A process's mapping of the channel.
+ */
+typedef struct
+{
+  struct shm_channel_header *hdr; /**< shared header (indices, counters, seqlock) */
+  shm_trade *slots;               /**< trade ring */
+  int64_t *vwap_ts;               /**< snapshot row timestamps */
+  double *vwap;                   /**< snapshot rows */
+  char *vwap_names;               /**< snapshot column names, SHM_SYMBOL_MAX bytes each */
+  size_t map_bytes;               /**< size of the mapping */
+  char name[64];                  /**< shared memory object name */
+  int owner;                      /**< nonzero in the creating (ingest) process */
+} shm_channel;
+
+/**
+ * @brief Creates (or replaces) the channel; called by the ingest process.
+ * @param ch Pointer to the shm_channel.
+ * @param name Shared memory object name (e.g. "/okx-trader").
+ * @param capacity Trades in the ring (power of two).
+ * @param vwap_rows Rows kept in the VWAP snapshot.
+ * @param vwap_width VWAPs per row (symbols).
+ * @return 0 on success, -1 on error.
+ */
+int shm_channel_create(shm_channel *ch, const char *name, uint32_t capacity, int vwap_rows, int vwap_width);
+
+/**
+ * @brief Attaches to an existing channel as its consumer; called by the analytics process.
+ * @param ch Pointer to the shm_channel.
+ * @param name Shared memory object name.
+ * @param capacity Expected ring capacity.
+ * @param vwap_rows Expected snapshot rows.
+ * @param vwap_width Expected snapshot width.
+ * @return 0 on success, -1 if the channel does not exist yet, -2 if it has another layout.
+ */
+int shm_channel_attach(shm_channel *ch, const char *name, uint32_t capacity, int vwap_rows, int vwap_width);
+
+/**
+ * @brief Appends a trade to the ring (producer only), waking the consumer if it sleeps.
+ * @param ch Pointer to the shm_channel.
+ * @param trade Trade to append.
+ * @return 1 if appended, 0 if the ring was full and the trade was dropped.
+ */
+int shm_channel_push(shm_channel *ch, const shm_trade *trade);
+
+/**
+ * @brief Returns the number of free ring slots (exact for the producer, a lower bound otherwise).
+ * @param ch Pointer to the shm_channel.
+ * @return Free slots.
+ */
+uint32_t shm_channel_space(const shm_channel *ch);
+
+/**
+ * @brief Takes the oldest trade from the ring (consumer only).
+ * @param ch Pointer to the shm_channel.
+ * @param trade Pointer to store the trade.
+ * @return 1 if a trade was taken, 0 if the ring is empty.
+ */
+int shm_channel_pop(shm_channel *ch, shm_trade *trade);
+
+/**
+ * @brief Sleeps until the producer appends a trade or the timeout expires (consumer only).
+ * @param ch Pointer to the shm_channel.
+ * @param timeout_ms Maximum wait.
+ * @return 1 if trades are available, 0 on timeout.
+ */
+int shm_channel_wait(shm_channel *ch, int timeout_ms);
+
+/**
+ * @brief Tells whether the process that created the channel is still running.
+ * @param ch Pointer to the shm_channel.
+ * @return 1 if alive, 0 otherwise.
+ */
+int shm_channel_producer_alive(const shm_channel *ch);
+
+/**
+ * @brief Returns the number of trades dropped because the ring was full.
+ * @param ch Pointer to the shm_channel.
+ * @return Dropped trades since the channel was created.
+ */
+uint64_t shm_channel_dropped(const shm_channel *ch);
+
+/**
+ * @brief Appends a VWAP row to the snapshot (single writer: the analytics process).
+ * @param ch Pointer to the shm_channel.
+ * @param minute_ts_ms Minute of the row.
+ * @param row `vwap_width` VWAPs.
+ */
+void shm_channel_publish_vwap(shm_channel *ch, int64_t minute_ts_ms, const double *row);
+
+/**
+ * @brief Labels the snapshot columns (single writer: the analytics process).
+ * @param ch Pointer to the shm_channel.
+ * @param names `vwap_width` names, `stride` bytes apart ("" for an unused column).
+ * @param stride Distance between names.
+ */
+void shm_channel_publish_names(shm_channel *ch, const char *names, size_t stride);
+
+/**
+ * @brief Copies the newest VWAP rows of the snapshot, oldest first, and the column names.
+ * @param ch Pointer to the shm_channel.
+ * @param max_rows Maximum rows to copy.
+ * @param minute_ts_ms Output, one timestamp per row.
+ * @param vwap Output, `vwap_width` VWAPs per row.
+ * @param names Output, `vwap_width` names of SHM_SYMBOL_MAX bytes.
+ * @return Number of rows copied, or -1 if no consistent copy could be taken.
+ */
+int shm_channel_read_vwap(const shm_channel *ch, int max_rows, int64_t *minute_ts_ms, double *vwap, char *names);
+
+/**
+ * @brief Unmaps the channel; the creating process also removes it.
+ * @param ch Pointer to the shm_channel.
+ */
+void shm_channel_close(shm_channel *ch);
+
+#endif /* SHM_CHANNEL_H */
@@ -2,77 +2,345 @@
  * @file sliding_window.c
  * @brief Sliding window operations implementation
  *
+ * Trades are numbered by a wrapping 32-bit sequence; trade `seq` lives in chunk
+ * `(seq mod WINDOW_CAPACITY) / WINDOW_CHUNK_TRADES` of a sparse ring. A chunk is taken
+ * from the chunk pool shared by all symbols when the newest trade enters it and given back
+ * when the oldest trade leaves it, so the memory follows the occupancy, growing never moves
+ * a trade and a busy symbol borrows what quiet ones do not use. The min/max deques are
+ * linked through the trades themselves and the quantile sets take their nodes from a
+ * second pool shared by all symbols, so both pools together bound a window's memory.
+ *
  * @author Fraidakis Ioannis
  * @date September 2025
  */
 
 #include "sliding_window.h"
+#include "chunk_pool.h"
+#include "quantiles.h"
+#include "volume_profile.h"
+#include "../utils/mem_budget.h"
+
+#define WINDOW_SEQ_MASK (WINDOW_CAPACITY - 1u)       /**< sequence number to ring position */
+#define WINDOW_SLOT_MASK (WINDOW_CHUNK_TRADES - 1u)   /**< ring position to slot in its chunk */
 
 /**
- * @brief Initializes a sliding_window structure.
+ * @brief Chunk of the ring that holds a sequence number.
+ * @param seq Sequence number.
+ * @return Index into `chunks`.
+ */
+static inline uint32_t chunk_of(uint32_t seq)
+{
+  return (seq & WINDOW_SEQ_MASK) >> WINDOW_CHUNK_SHIFT;
+}
+
+/**
+ * @brief Returns the trade stored under a sequence number.
  * @param w Pointer to the sliding_window.
+ * @param seq Sequence number of a trade in the window.
+ * @return Pointer to the trade.
  */
-void sliding_window_init(sliding_window *w)
+static inline processed_trade *window_entry(const sliding_window *w, uint32_t seq)
 {
-  w->buffer = calloc(WINDOW_CAPACITY, sizeof(processed_trade));
+  return &w->chunks[chunk_of(seq)][seq & WINDOW_SLOT_MASK];
+}
 
-  if (!w->buffer)
+/**
+ * @brief Puts a chunk into the ring position of a sequence number, from the spare stack if possible.
+ * @param w Pointer to the sliding_window.
+ * @param seq Sequence number about to be written.
+ * @return 1 on success, 0 if the spare stack and the pool are both empty.
+ */
+static int window_acquire_chunk(sliding_window *w, uint32_t seq)
+{
+  processed_trade *chunk;
+  if (w->num_spare > 0)
+    chunk = w->spare[--w->num_spare];
+  else
   {
-    fprintf(stderr, "ERROR: Failed to allocate trade window buffer for %d trades (%.2f MB)\n", 
-            WINDOW_CAPACITY, (WINDOW_CAPACITY * sizeof(processed_trade)) / (1024.0 * 1024.0));
-    exit(1);
+    chunk = chunk_pool_alloc(w->pool);
+    if (!chunk)
+      return 0;
+    w->chunk_allocs++;
+  }
+  w->chunks[chunk_of(seq)] = chunk;
+  w->num_chunks++;
+  return 1;
+}
+
+/**
+ * @brief Moves the chunk at the ring position of a sequence number to the spare stack, or
+ * back to the pool once the stack is full.
+ * @param w Pointer to the sliding_window.
+ * @param seq Sequence number in the chunk.
+ */
+static void window_release_chunk(sliding_window *w, uint32_t seq)
+{
+  processed_trade *chunk = w->chunks[chunk_of(seq)];
+  if (w->num_spare < WINDOW_SPARE_CHUNKS)
+    w->spare[w->num_spare++] = chunk;
+  else
+    chunk_pool_free(w->pool, chunk);
+  w->chunks[chunk_of(seq)] = NULL;
+  w->num_chunks--;
+}
+
+/**
+ * @brief Initializes an empty monotonic deque.
+ * @param d Pointer to the deque.
+ * @param link Which prev/next pair of the trades it uses (0 max, 1 min).
+ */
+static void deque_init(monotonic_deque *d, int link)
+{
+  d->front = d->back = d->size = 0;
+  d->link = link;
+}
+
+/**
+ * @brief Returns the sequence number at the front (oldest) of a deque.
+ * @param d Pointer to the deque (size > 0).
+ * @return Window sequence number.
+ */
+static inline uint32_t deque_front(const monotonic_deque *d)
+{
+  return d->front;
+}
+
+/**
+ * @brief Appends a window trade after dropping the entries it dominates (amortized O(1)).
+ * @details For the max deque (`sign` = 1) entries priced <= price are dropped; for the min
+ * deque (`sign` = -1) entries priced >= price.
+ * @param d Pointer to the deque.
+ * @param w Window holding the trades.
+ * @param seq Sequence number of the new trade.
+ * @param sign 1 for max, -1 for min.
+ */
+static inline void deque_push(monotonic_deque *d, const sliding_window *w, uint32_t seq, int sign)
+{
+  processed_trade *t = window_entry(w, seq);
+  while (d->size > 0 && sign * (window_entry(w, d->back)->price - t->price) <= 0)
+  {
+    d->back = window_entry(w, d->back)->prev[d->link];
+    d->size--;
+  }
+
+  t->prev[d->link] = d->back;
+  if (d->size > 0)
+    window_entry(w, d->back)->next[d->link] = seq;
+  else
+    d->front = seq;
+  d->back = seq;
+  d->size++;
+}
+
+/**
+ * @brief Drops the front of a deque if it is the window entry being evicted.
+ * @param d Pointer to the deque.
+ * @param w Window holding the trades (the evicted one still readable).
+ * @param seq Sequence number of the evicted trade (the window head).
+ */
+static inline void deque_evict(monotonic_deque *d, const sliding_window *w, uint32_t seq)
+{
+  if (d->size > 0 && d->front == seq)
+  {
+    if (--d->size > 0)
+      d->front = window_entry(w, seq)->next[d->link];
   }
+}
+
+/**
+ * @brief Initializes a sliding_window structure.
+ * @details Holds no trade storage until the first trade: chunks come from the pool as the
+ * occupancy grows, up to WINDOW_CAPACITY trades, without moving the trades it holds.
+ * The min/max deques are linked through the trades and the quantile sets take a node
+ * from `nodes` per distinct key, so adding a trade never calls the allocator.
+ * @param w Pointer to the sliding_window.
+ * @param pool Chunk pool of WINDOW_CHUNK_TRADES-trade chunks, shared with other windows.
+ * @param nodes Pool of quantile nodes shared with other windows (exact mode).
+ */
+void sliding_window_init(sliding_window *w, struct chunk_pool *pool, struct chunk_pool *nodes)
+{
+  memset(w->chunks, 0, sizeof(w->chunks));
+  w->num_chunks = 0;
+  w->num_spare = 0;
+  w->pool = pool;
+  w->chunk_allocs = 0;
 
-  w->capacity = WINDOW_CAPACITY;
-  w->head_idx = w->tail_idx = w->size = 0;
+  w->head_seq = w->size = 0;
+  w->peak_size = 0;
+  memset(w->minute_peaks, 0, sizeof(w->minute_peaks));
+  w->minute_cursor = 0;
+  w->forced_evictions = 0;
   w->sum_price_volume = 0.0;
   w->sum_volume = 0.0;
+  w->sum_buy_notional = w->sum_buy_volume = 0.0;
+  w->sum_sell_notional = w->sum_sell_volume = 0.0;
+  w->sum_sq_log_return = 0.0;
+  w->last_price = NAN;
+
+  w->price_quantiles = malloc(sizeof(quantile_set));
+  w->size_quantiles = malloc(sizeof(quantile_set));
+  if (!w->price_quantiles || !w->size_quantiles ||
+      quantile_set_init_shared(w->price_quantiles, WINDOW_QUANTILE_MODE, nodes) < 0 ||
+      quantile_set_init_shared(w->size_quantiles, WINDOW_QUANTILE_MODE, nodes) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate window quantile sets\n");
+    exit(1);
+  }
+  mem_budget_add(MEM_WINDOWS, (int64_t)(quantile_set_memory(w->price_quantiles) + quantile_set_memory(w->size_quantiles)));
+
+  deque_init(&w->max_deque, 0);
+  deque_init(&w->min_deque, 1);
+  volume_profile_init(&w->profile, VOLUME_PROFILE_SLOTS);
+  w->sum_price_time = 0.0;
+  w->sum_time = 0.0;
+
   pthread_mutex_init(&w->lock, NULL);
 }
 
+/**
+ * @brief Adds (sign = 1) or removes (sign = -1) a trade from the running sums.
+ * @param w Pointer to the sliding_window.
+ * @param t Pointer to the trade.
+ * @param sign +1.0 to add, -1.0 to remove.
+ */
+static void window_update_sums(sliding_window *w, const processed_trade *t, double sign)
+{
+  double notional = sign * t->price * t->size;
+  double volume = sign * t->size;
+
+  w->sum_price_volume += notional;
+  w->sum_volume += volume;
+  w->sum_sq_log_return += sign * t->sq_log_return;
+
+  if (t->side == TRADE_SIDE_BUY)
+  {
+    w->sum_buy_notional += notional;
+    w->sum_buy_volume += volume;
+  }
+  else if (t->side == TRADE_SIDE_SELL)
+  {
+    w->sum_sell_notional += notional;
+    w->sum_sell_volume += volume;
+  }
+}
+
+/**
+ * @brief Length of the time a trade's price stands until the next trade.
+ * @param ts_ms Trade timestamp.
+ * @param next_ts_ms Next trade's timestamp.
+ * @return Duration in ms (0 if timestamps run backwards).
+ */
+static inline double price_segment_ms(int64_t ts_ms, int64_t next_ts_ms)
+{
+  return next_ts_ms > ts_ms ? (double)(next_ts_ms - ts_ms) : 0.0;
+}
+
+/**
+ * @brief Evicts the oldest trade from the window, its running sums and quantile sets.
+ * @param w Pointer to the sliding_window (lock held, size > 0).
+ * @param incoming_ts_ms Timestamp of the trade being added (successor of the newest entry).
+ */
+static void window_evict_head(sliding_window *w, int64_t incoming_ts_ms)
+{
+  uint32_t seq = w->head_seq;
+  const processed_trade *t = window_entry(w, seq);
+
+  // Its price segment runs to the next entry (or to the incoming trade if it is the last)
+  int64_t next_ts_ms = w->size > 1 ? window_entry(w, seq + 1)->trade_ts_ms : incoming_ts_ms;
+  double dt = price_segment_ms(t->trade_ts_ms, next_ts_ms);
+  w->sum_price_time -= t->price * dt;
+  w->sum_time -= dt;
+
+  window_update_sums(w, t, -1.0);
+  volume_profile_remove(&w->profile, t->price, t->size);
+  quantile_set_remove(w->price_quantiles, t->price);
+  quantile_set_remove(w->size_quantiles, t->size);
+  deque_evict(&w->max_deque, w, seq); // shares the window's expiry cursor
+  deque_evict(&w->min_deque, w, seq);
+  w->head_seq = seq + 1;
+  w->size--;
+
+  /* leaving a chunk: release it unless the newest trades wrapped around into it */
+  if ((w->head_seq & WINDOW_SLOT_MASK) == 0 &&
+      (w->size == 0 || chunk_of(w->head_seq + w->size - 1) != chunk_of(seq)))
+    window_release_chunk(w, seq);
+}
+
 /**
  * @brief Pushes a new trade to the sliding window.
  * @details Prunes old trades that fall outside the `WINDOW_MS` duration and updates
- * the running sums for price-volume and total volume.
+ * the running sums for price-volume and total volume, overall and per taker side,
+ * and for the squared log-return against the previous trade. Price and size also enter
+ * the window's quantile sets (O(log n) in exact mode), the min/max deques, the volume
+ * profile and the time integral of the last price (TWAP).
  * @param w Pointer to the sliding_window.
  * @param ts_ms Timestamp of the new trade.
  * @param price Price of the new trade.
  * @param size Size of the new trade.
+ * @param side Taker side of the new trade (TRADE_SIDE_*).
  */
-void sliding_window_add_trade(sliding_window *w, int64_t ts_ms, double price, double size)
+void sliding_window_add_trade(sliding_window *w, int64_t ts_ms, double price, double size, int side)
 {
   pthread_mutex_lock(&w->lock);
 
+  // 0. Close the time segment of the previous price at this trade (TWAP integral)
+  if (w->size > 0)
+  {
+    const processed_trade *prev = window_entry(w, w->head_seq + w->size - 1);
+    double dt = price_segment_ms(prev->trade_ts_ms, ts_ms);
+    w->sum_price_time += prev->price * dt;
+    w->sum_time += dt;
+  }
+
   // 1. Prune old entries from head (O(k) where k = expired entries, typically small)
   int64_t expiry_cutoff_ms = ts_ms - WINDOW_MS;
-  while (w->size > 0 && w->buffer[w->head_idx].trade_ts_ms < expiry_cutoff_ms)
+  while (w->size > 0 && window_entry(w, w->head_seq)->trade_ts_ms < expiry_cutoff_ms)
+    window_evict_head(w, ts_ms);
+
+  // 2. Handle window full (overwrite oldest if necessary)
+  if (w->size == WINDOW_CAPACITY)
   {
-    w->sum_price_volume -= w->buffer[w->head_idx].price * w->buffer[w->head_idx].size;
-    w->sum_volume -= w->buffer[w->head_idx].size;
-    w->head_idx = (w->head_idx + 1) % w->capacity;
-    w->size--;
+    window_evict_head(w, ts_ms); // Remove oldest entry
+    w->forced_evictions++;
   }
 
-  // 2. Handle buffer full (overwrite oldest if necessary)
-  if (w->size == w->capacity)
+  // 3. Add new entry, entering a new chunk every WINDOW_CHUNK_TRADES trades
+  uint32_t seq = w->head_seq + w->size;
+  while (!w->chunks[chunk_of(seq)] && !window_acquire_chunk(w, seq))
   {
-    // Remove oldest entry
-    w->sum_price_volume -= w->buffer[w->head_idx].price * w->buffer[w->head_idx].size;
-    w->sum_volume -= w->buffer[w->head_idx].size;
-    w->head_idx = (w->head_idx + 1) % w->capacity;
-    w->size--;
+    // Pool empty: make room from this window's own oldest trades, or drop the trade
+    w->forced_evictions++;
+    if (w->size == 0)
+    {
+      pthread_mutex_unlock(&w->lock);
+      return;
+    }
+    window_evict_head(w, ts_ms);
   }
-
-  // 3. Add new entry
-  w->buffer[w->tail_idx].trade_ts_ms = ts_ms;
-  w->buffer[w->tail_idx].price = price;
-  w->buffer[w->tail_idx].size = size;
-  w->tail_idx = (w->tail_idx + 1) % w->capacity;
+  processed_trade *t = window_entry(w, seq);
+  t->trade_ts_ms = ts_ms;
+  t->price = price;
+  t->size = size;
+  t->side = side;
+  if (isnan(w->last_price)) // first trade: no return yet
+    t->sq_log_return = 0.0f;
+  else
+  {
+    double r = log(price / w->last_price);
+    t->sq_log_return = (float)(r * r);
+  }
+  w->last_price = price;
+  deque_push(&w->max_deque, w, seq, 1);
+  deque_push(&w->min_deque, w, seq, -1);
   w->size++;
+  if (w->size > w->peak_size)
+    w->peak_size = w->size;
 
-  // 4. Update running sums
-  w->sum_price_volume += price * size;
-  w->sum_volume += size;
+  // 4. Update running sums and order statistics
+  window_update_sums(w, t, 1.0);
+  quantile_set_insert(w->price_quantiles, price);
+  quantile_set_insert(w->size_quantiles, size);
+  volume_profile_add(&w->profile, price, size);
 
   pthread_mutex_unlock(&w->lock);
 }
@@ -94,16 +362,189 @@ void sliding_window_snapshot_vwap(sliding_window *w, double *out_vwap)
   pthread_mutex_unlock(&w->lock);
 }
 
+/**
+ * @brief Takes a snapshot of the buy/sell order flow from the window's running sums.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the order-flow snapshot.
+ */
+void sliding_window_snapshot_flow(sliding_window *w, trade_flow *out)
+{
+  pthread_mutex_lock(&w->lock);
+
+  double buy_notional = w->sum_buy_notional, buy_volume = w->sum_buy_volume;
+  double sell_notional = w->sum_sell_notional, sell_volume = w->sum_sell_volume;
+
+  pthread_mutex_unlock(&w->lock);
+
+  /* running sums may drift slightly below zero once a side has fully expired */
+  if (buy_volume < 1e-12)
+    buy_volume = 0.0;
+  if (sell_volume < 1e-12)
+    sell_volume = 0.0;
+
+  out->buy_volume = buy_volume;
+  out->sell_volume = sell_volume;
+  out->imbalance = (buy_volume + sell_volume > 0) ? (buy_volume - sell_volume) / (buy_volume + sell_volume) : NAN;
+  out->buy_vwap = buy_volume > 0 ? buy_notional / buy_volume : NAN;
+  out->sell_vwap = sell_volume > 0 ? sell_notional / sell_volume : NAN;
+}
+
+/**
+ * @brief Takes a snapshot of the realized variance (sum of squared trade log-returns) of the window.
+ * @param w Pointer to the sliding_window.
+ * @param out_var Pointer to store the realized variance (NAN if the window is empty).
+ */
+void sliding_window_snapshot_realized_variance(sliding_window *w, double *out_var)
+{
+  pthread_mutex_lock(&w->lock);
+
+  if (w->size > 0)
+    *out_var = w->sum_sq_log_return > 0 ? w->sum_sq_log_return : 0.0; // clamp rounding drift
+  else
+    *out_var = NAN;
+
+  pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * @brief Takes a snapshot of the median trade price and trade-size percentiles of the window.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the quantiles (NAN if the window is empty).
+ */
+void sliding_window_snapshot_quantiles(sliding_window *w, window_quantiles *out)
+{
+  pthread_mutex_lock(&w->lock);
+
+  out->price_p50 = quantile_set_query(w->price_quantiles, 0.50);
+  out->size_p50 = quantile_set_query(w->size_quantiles, 0.50);
+  out->size_p90 = quantile_set_query(w->size_quantiles, 0.90);
+  out->size_p99 = quantile_set_query(w->size_quantiles, 0.99);
+
+  pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * @brief Takes a snapshot of the window's high, low and last price (O(1)).
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the range (NAN if the window is empty).
+ */
+void sliding_window_snapshot_range(sliding_window *w, window_range *out)
+{
+  pthread_mutex_lock(&w->lock);
+
+  if (w->size > 0)
+  {
+    out->high = window_entry(w, deque_front(&w->max_deque))->price;
+    out->low = window_entry(w, deque_front(&w->min_deque))->price;
+    out->last_price = w->last_price;
+  }
+  else
+  {
+    out->high = out->low = out->last_price = NAN;
+  }
+
+  pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * @brief Takes a snapshot of the window's TWAP, point of control and value area.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the profile (NAN if the window is empty).
+ */
+void sliding_window_snapshot_profile(sliding_window *w, window_profile *out)
+{
+  pthread_mutex_lock(&w->lock);
+
+  if (w->size == 0)
+  {
+    out->twap = out->poc = out->value_area_low = out->value_area_high = NAN;
+    pthread_mutex_unlock(&w->lock);
+    return;
+  }
+
+  out->twap = w->sum_time > 0 ? w->sum_price_time / w->sum_time : w->last_price; // single instant: last price
+  volume_profile_snapshot(&w->profile, window_entry(w, deque_front(&w->min_deque))->price,
+                          window_entry(w, deque_front(&w->max_deque))->price, out);
+
+  pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * @brief Closes a minute of occupancy history and returns the window's spare chunks to the pool.
+ * @details The spare stack only saves pool operations while the window's tail and head
+ * cross chunk boundaries; a quiet symbol must not sit on chunks a busy one could borrow.
+ * Chunks holding trades stay with the window. Called once per minute, off the trade path.
+ * @param w Pointer to the sliding_window.
+ */
+void sliding_window_trim(sliding_window *w)
+{
+  pthread_mutex_lock(&w->lock);
+
+  w->minute_peaks[w->minute_cursor] = w->peak_size;
+  w->minute_cursor = (w->minute_cursor + 1) % WINDOW_MINUTES;
+  w->peak_size = w->size;
+
+  while (w->num_spare > 0)
+    chunk_pool_free(w->pool, w->spare[--w->num_spare]);
+
+  pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * @brief Takes a snapshot of the window's occupancy, allocated capacity and eviction counters.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the occupancy.
+ */
+void sliding_window_snapshot_occupancy(sliding_window *w, window_occupancy *out)
+{
+  pthread_mutex_lock(&w->lock);
+
+  out->trades = w->size;
+  out->peak_trades = w->peak_size;
+  for (int m = 0; m < WINDOW_MINUTES; ++m)
+    if (w->minute_peaks[m] > out->peak_trades)
+      out->peak_trades = w->minute_peaks[m];
+  out->capacity_trades = (w->num_chunks + w->num_spare) * WINDOW_CHUNK_TRADES;
+  out->memory_bytes = (size_t)out->capacity_trades * sizeof(processed_trade) +
+                      (size_t)(w->price_quantiles->nodes_used + w->size_quantiles->nodes_used) * sizeof(quantile_node) +
+                      quantile_set_memory(w->price_quantiles) + quantile_set_memory(w->size_quantiles);
+  out->forced_evictions = w->forced_evictions;
+  out->chunk_allocs = w->chunk_allocs;
+  out->pool_free_chunks = chunk_pool_available(w->pool);
+
+  pthread_mutex_unlock(&w->lock);
+}
+
 /**
  * @brief Cleans up resources used by a sliding_window.
  * @param w Pointer to the sliding_window.
  */
 void sliding_window_cleanup(sliding_window *w)
 {
-  if (w->buffer)
+  for (uint32_t c = 0; c < WINDOW_MAX_CHUNKS; ++c)
+  {
+    if (w->chunks[c])
+      chunk_pool_free(w->pool, w->chunks[c]);
+    w->chunks[c] = NULL;
+  }
+  while (w->num_spare > 0)
+    chunk_pool_free(w->pool, w->spare[--w->num_spare]);
+  w->num_chunks = 0;
+  w->max_deque.size = w->min_deque.size = 0;
+  volume_profile_cleanup(&w->profile);
+  if (w->price_quantiles)
+  {
+    mem_budget_add(MEM_WINDOWS, -(int64_t)quantile_set_memory(w->price_quantiles));
+    quantile_set_cleanup(w->price_quantiles);
+    free(w->price_quantiles);
+    w->price_quantiles = NULL;
+  }
+  if (w->size_quantiles)
   {
-    free(w->buffer);
-    w->buffer = NULL;
+    mem_budget_add(MEM_WINDOWS, -(int64_t)quantile_set_memory(w->size_quantiles));
+    quantile_set_cleanup(w->size_quantiles);
+    free(w->size_quantiles);
+    w->size_quantiles = NULL;
   }
   pthread_mutex_destroy(&w->lock);
 }
\ No newline at end of file
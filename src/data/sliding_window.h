@@ -2,6 +2,13 @@
  * @file sliding_window.h
  * @brief Sliding window operations declarations
  *
+ * Each symbol's window stores its trades in chunks of WINDOW_CHUNK_TRADES taken from a
+ * chunk pool shared by all symbols as the occupancy grows (up to WINDOW_CAPACITY) and
+ * returned as trades expire. The min/max deques are linked through those trades, and the
+ * quantile sets take their nodes from a node pool also shared by all symbols, sized at
+ * one node per pooled trade and set. The two pools bound the memory of every window
+ * together: growing a window only moves chunks and nodes between symbols.
+ *
  * @author Fraidakis Ioannis
  * @date September 2025
  */
@@ -13,20 +20,31 @@
 
 /**
  * @brief Initializes a sliding_window structure.
+ * @details Holds no trade storage until the first trade: chunks come from the pool as the
+ * occupancy grows, up to WINDOW_CAPACITY trades, without moving the trades it holds.
+ * The min/max deques are linked through the trades and the quantile sets take a node
+ * from `nodes` per distinct key, so adding a trade never calls the allocator.
  * @param w Pointer to the sliding_window.
+ * @param pool Chunk pool of WINDOW_CHUNK_TRADES-trade chunks, shared with other windows.
+ * @param nodes Pool of WINDOW_QUANTILE_NODES quantile nodes shared with other windows
+ *        (exact mode; unused in approximate mode).
  */
-void sliding_window_init(sliding_window *w);
+void sliding_window_init(sliding_window *w, struct chunk_pool *pool, struct chunk_pool *nodes);
 
 /**
  * @brief Pushes a new trade to the sliding window.
  * @details Prunes old trades that fall outside the `WINDOW_MS` duration and updates
- * the running sums for price-volume and total volume.
+ * the running sums for price-volume and total volume, overall and per taker side,
+ * and for the squared log-return against the previous trade. Price and size also enter
+ * the window's quantile sets (O(log n) in exact mode), the min/max deques, the volume
+ * profile and the time integral of the last price (TWAP).
  * @param w Pointer to the sliding_window.
  * @param ts_ms Timestamp of the new trade.
  * @param price Price of the new trade.
  * @param size Size of the new trade.
+ * @param side Taker side of the new trade (TRADE_SIDE_*).
  */
-void sliding_window_add_trade(sliding_window *w, int64_t ts_ms, double price, double size);
+void sliding_window_add_trade(sliding_window *w, int64_t ts_ms, double price, double size, int side);
 
 /**
  * @brief Takes a snapshot of the current VWAP and total volume from the window.
@@ -35,6 +53,57 @@ void sliding_window_add_trade(sliding_window *w, int64_t ts_ms, double price, do
  */
 void sliding_window_snapshot_vwap(sliding_window *w, double *out_vwap);
 
+/**
+ * @brief Takes a snapshot of the buy/sell order flow from the window's running sums.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the order-flow snapshot.
+ */
+void sliding_window_snapshot_flow(sliding_window *w, trade_flow *out);
+
+/**
+ * @brief Takes a snapshot of the realized variance (sum of squared trade log-returns) of the window.
+ * @param w Pointer to the sliding_window.
+ * @param out_var Pointer to store the realized variance (NAN if the window is empty).
+ */
+void sliding_window_snapshot_realized_variance(sliding_window *w, double *out_var);
+
+/**
+ * @brief Takes a snapshot of the median trade price and trade-size percentiles of the window.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the quantiles (NAN if the window is empty).
+ */
+void sliding_window_snapshot_quantiles(sliding_window *w, window_quantiles *out);
+
+/**
+ * @brief Takes a snapshot of the window's high, low and last price (O(1)).
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the range (NAN if the window is empty).
+ */
+void sliding_window_snapshot_range(sliding_window *w, window_range *out);
+
+/**
+ * @brief Takes a snapshot of the window's TWAP, point of control and value area.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the profile (NAN if the window is empty).
+ */
+void sliding_window_snapshot_profile(sliding_window *w, window_profile *out);
+
+/**
+ * @brief Closes a minute of occupancy history and returns the window's spare chunks to the pool.
+ * @details The spare stack only saves pool operations while the window's tail and head
+ * cross chunk boundaries; a quiet symbol must not sit on chunks a busy one could borrow.
+ * Chunks holding trades stay with the window. Called once per minute, off the trade path.
+ * @param w Pointer to the sliding_window.
+ */
+void sliding_window_trim(sliding_window *w);
+
+/**
+ * @brief Takes a snapshot of the window's occupancy, allocated capacity and eviction counters.
+ * @param w Pointer to the sliding_window.
+ * @param out Pointer to store the occupancy.
+ */
+void sliding_window_snapshot_occupancy(sliding_window *w, window_occupancy *out);
+
 /**
  * @brief Cleans up resources used by a sliding_window.
  * @param w Pointer to the sliding_window.
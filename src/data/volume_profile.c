@@ -0,0 +1,187 @@
+/**
+ * @file volume_profile.c
+ * @brief Volume-by-price profile implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "volume_profile.h"
+#include "../utils/mem_budget.h"
+
+/**
+ * @brief Rounds a width down to 1, 2 or 5 times a power of ten.
+ * @param w Raw width (> 0).
+ * @return The rounded width.
+ */
+static double nice_width(double w)
+{
+  double scale = pow(10.0, floor(log10(w)));
+  double m = w / scale;
+  return (m >= 5.0 ? 5.0 : m >= 2.0 ? 2.0 : 1.0) * scale;
+}
+
+/**
+ * @brief Maps a bucket id to its slot.
+ * @param p Pointer to the volume_profile.
+ * @param id Bucket id.
+ * @return Slot index.
+ */
+static inline uint32_t profile_slot(const volume_profile *p, int64_t id)
+{
+  int64_t m = id % (int64_t)p->num_slots;
+  return (uint32_t)(m < 0 ? m + p->num_slots : m);
+}
+
+/**
+ * @brief Initializes a volume_profile structure.
+ * @param p Pointer to the volume_profile.
+ * @param num_slots Number of direct-mapped slots.
+ */
+void volume_profile_init(volume_profile *p, uint32_t num_slots)
+{
+  p->volume = calloc(num_slots, sizeof(double));
+  p->bucket_id = calloc(num_slots, sizeof(int64_t));
+  p->trades = calloc(num_slots, sizeof(uint32_t));
+
+  if (!p->volume || !p->bucket_id || !p->trades)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate volume profile for %u buckets (%.2f KB)\n", num_slots,
+            num_slots * (sizeof(double) + sizeof(int64_t) + sizeof(uint32_t)) / 1024.0);
+    exit(1);
+  }
+
+  mem_budget_add(MEM_WINDOWS, (int64_t)num_slots * (sizeof(double) + sizeof(int64_t) + sizeof(uint32_t)));
+
+  p->num_slots = num_slots;
+  p->bucket_width = 0.0;
+  p->collisions = 0;
+}
+
+/**
+ * @brief Adds a trade's volume to its price bucket (O(1)).
+ * @details The first trade fixes the bucket width at VOLUME_PROFILE_BUCKET_BPS of its price.
+ * @param p Pointer to the volume_profile.
+ * @param price Trade price.
+ * @param size Trade size.
+ */
+void volume_profile_add(volume_profile *p, double price, double size)
+{
+  if (p->bucket_width == 0.0)
+    p->bucket_width = nice_width(price * VOLUME_PROFILE_BUCKET_BPS / 1e4);
+
+  int64_t id = (int64_t)floor(price / p->bucket_width);
+  uint32_t slot = profile_slot(p, id);
+
+  if (p->trades[slot] == 0)
+    p->bucket_id[slot] = id;
+  else if (p->bucket_id[slot] != id)
+    p->collisions++; // shared with a bucket SLOTS away: the volume is merged
+
+  p->volume[slot] += size;
+  p->trades[slot]++;
+}
+
+/**
+ * @brief Removes an expired trade's volume from its price bucket (O(1)).
+ * @param p Pointer to the volume_profile.
+ * @param price Trade price.
+ * @param size Trade size.
+ */
+void volume_profile_remove(volume_profile *p, double price, double size)
+{
+  uint32_t slot = profile_slot(p, (int64_t)floor(price / p->bucket_width));
+
+  if (p->trades[slot] == 0)
+    return;
+
+  if (--p->trades[slot] == 0)
+    p->volume[slot] = 0.0; // drop rounding residue
+  else
+    p->volume[slot] -= size;
+}
+
+/**
+ * @brief Returns the volume held for a bucket id.
+ * @param p Pointer to the volume_profile.
+ * @param id Bucket id.
+ * @return Volume, 0 if the slot holds no trades or another bucket.
+ */
+static inline double bucket_volume(const volume_profile *p, int64_t id)
+{
+  uint32_t slot = profile_slot(p, id);
+  return (p->trades[slot] > 0 && p->bucket_id[slot] == id) ? p->volume[slot] : 0.0;
+}
+
+/**
+ * @brief Finds the point of control and the value area between two prices.
+ * @details Scans the buckets covering [low, high] (the window range), takes the one with
+ * the most volume as the point of control and grows the value area from it towards the
+ * heavier neighbour until it holds VOLUME_PROFILE_VALUE_AREA of the volume.
+ * @param p Pointer to the volume_profile.
+ * @param low Lowest price in the window.
+ * @param high Highest price in the window.
+ * @param out Pointer to store poc/value_area_low/value_area_high (`twap` is left untouched).
+ */
+void volume_profile_snapshot(const volume_profile *p, double low, double high, window_profile *out)
+{
+  out->poc = out->value_area_low = out->value_area_high = NAN;
+
+  if (p->bucket_width == 0.0 || isnan(low) || isnan(high))
+    return;
+
+  int64_t lo_id = (int64_t)floor(low / p->bucket_width);
+  int64_t hi_id = (int64_t)floor(high / p->bucket_width);
+  if (hi_id - lo_id >= (int64_t)p->num_slots)
+    lo_id = hi_id - p->num_slots + 1; // span wider than the slots: keep the top
+
+  // Point of control and total volume
+  int64_t poc_id = lo_id;
+  double poc_volume = -1.0, total = 0.0;
+  for (int64_t id = lo_id; id <= hi_id; ++id)
+  {
+    double v = bucket_volume(p, id);
+    total += v;
+    if (v > poc_volume)
+    {
+      poc_volume = v;
+      poc_id = id;
+    }
+  }
+
+  if (total <= 0.0)
+    return;
+
+  // Value area: grow from the POC towards the heavier side
+  int64_t va_lo = poc_id, va_hi = poc_id;
+  double covered = poc_volume;
+  while (covered < VOLUME_PROFILE_VALUE_AREA * total && (va_lo > lo_id || va_hi < hi_id))
+  {
+    double below = va_lo > lo_id ? bucket_volume(p, va_lo - 1) : -1.0;
+    double above = va_hi < hi_id ? bucket_volume(p, va_hi + 1) : -1.0;
+    if (above >= below)
+      covered += bucket_volume(p, ++va_hi);
+    else
+      covered += bucket_volume(p, --va_lo);
+  }
+
+  out->poc = (poc_id + 0.5) * p->bucket_width;
+  out->value_area_low = va_lo * p->bucket_width;
+  out->value_area_high = (va_hi + 1) * p->bucket_width;
+}
+
+/**
+ * @brief Cleans up resources used by a volume_profile.
+ * @param p Pointer to the volume_profile.
+ */
+void volume_profile_cleanup(volume_profile *p)
+{
+  if (p->volume)
+    mem_budget_add(MEM_WINDOWS, -(int64_t)p->num_slots * (sizeof(double) + sizeof(int64_t) + sizeof(uint32_t)));
+  free(p->volume);
+  free(p->bucket_id);
+  free(p->trades);
+  p->volume = NULL;
+  p->bucket_id = NULL;
+  p->trades = NULL;
+}
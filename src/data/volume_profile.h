@@ -0,0 +1,56 @@
+/**
+ * @file volume_profile.h
+ * @brief Volume-by-price profile declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef VOLUME_PROFILE_H
+#define VOLUME_PROFILE_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Initializes a volume_profile structure.
+ * @param p Pointer to the volume_profile.
+ * @param num_slots Number of direct-mapped slots.
+ */
+void volume_profile_init(volume_profile *p, uint32_t num_slots);
+
+/**
+ * @brief Adds a trade's volume to its price bucket (O(1)).
+ * @details The first trade fixes the bucket width at VOLUME_PROFILE_BUCKET_BPS of its price.
+ * @param p Pointer to the volume_profile.
+ * @param price Trade price.
+ * @param size Trade size.
+ */
+void volume_profile_add(volume_profile *p, double price, double size);
+
+/**
+ * @brief Removes an expired trade's volume from its price bucket (O(1)).
+ * @param p Pointer to the volume_profile.
+ * @param price Trade price.
+ * @param size Trade size.
+ */
+void volume_profile_remove(volume_profile *p, double price, double size);
+
+/**
+ * @brief Finds the point of control and the value area between two prices.
+ * @details Scans the buckets covering [low, high] (the window range), takes the one with
+ * the most volume as the point of control and grows the value area from it towards the
+ * heavier neighbour until it holds VOLUME_PROFILE_VALUE_AREA of the volume.
+ * @param p Pointer to the volume_profile.
+ * @param low Lowest price in the window.
+ * @param high Highest price in the window.
+ * @param out Pointer to store poc/value_area_low/value_area_high (`twap` is left untouched).
+ */
+void volume_profile_snapshot(const volume_profile *p, double low, double high, window_profile *out);
+
+/**
+ * @brief Cleans up resources used by a volume_profile.
+ * @param p Pointer to the volume_profile.
+ */
+void volume_profile_cleanup(volume_profile *p);
+
+#endif /* VOLUME_PROFILE_H */
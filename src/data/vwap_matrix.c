@@ -0,0 +1,128 @@
+/**
+ * @file vwap_matrix.c
+ * @brief All-symbol VWAP history matrix implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "vwap_matrix.h"
+#include "../utils/mem_budget.h"
+
+/**
+ * @brief Bytes allocated by a vwap_matrix (rows are stored twice, see vwap_matrix_view).
+ * @param capacity Minutes (rows).
+ * @param width Symbols per row.
+ * @return Bytes.
+ */
+static int64_t vwap_matrix_bytes(int capacity, int width)
+{
+  return (int64_t)2 * capacity * ((int64_t)width * sizeof(double) + sizeof(int64_t));
+}
+
+/**
+ * @brief Initializes a vwap_matrix.
+ * @param m Pointer to the vwap_matrix.
+ * @param capacity The maximum number of minutes (rows) to store.
+ * @param width The number of symbols per row.
+ */
+void vwap_matrix_init(vwap_matrix *m, int capacity, int width)
+{
+  m->vwap = calloc((size_t)2 * capacity * width, sizeof(double));
+  m->minute_ts_ms = calloc(2 * capacity, sizeof(int64_t));
+
+  if (!m->vwap || !m->minute_ts_ms)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate VWAP history matrix for %d minutes x %d symbols (%.2f KB)\n",
+            capacity, width, vwap_matrix_bytes(capacity, width) / 1024.0);
+    exit(1);
+  }
+  mem_budget_add(MEM_HISTORY, vwap_matrix_bytes(capacity, width));
+
+  m->width = width;
+  m->capacity = capacity;
+  m->head_idx = 0;
+  m->tail_idx = 0;
+  m->size = 0;
+  pthread_mutex_init(&m->lock, NULL);
+}
+
+/**
+ * @brief Appends one minute: its timestamp and every symbol's VWAP (overwrites the oldest row if full).
+ * @param m Pointer to the vwap_matrix.
+ * @param minute_ts_ms Minute timestamp.
+ * @param row `width` VWAPs, in symbol order.
+ */
+void vwap_matrix_append(vwap_matrix *m, int64_t minute_ts_ms, const double *row)
+{
+  pthread_mutex_lock(&m->lock);
+
+  // Handle buffer full
+  if (m->size == m->capacity)
+  {
+    m->head_idx = (m->head_idx + 1) % m->capacity;
+    m->size--;
+  }
+
+  // Add new row (and its mirror)
+  int mirror_idx = m->tail_idx + m->capacity;
+  memcpy(&m->vwap[(size_t)m->tail_idx * m->width], row, m->width * sizeof(double));
+  memcpy(&m->vwap[(size_t)mirror_idx * m->width], row, m->width * sizeof(double));
+  m->minute_ts_ms[m->tail_idx] = m->minute_ts_ms[mirror_idx] = minute_ts_ms;
+  m->tail_idx = (m->tail_idx + 1) % m->capacity;
+  m->size++;
+
+  pthread_mutex_unlock(&m->lock);
+}
+
+/**
+ * @brief Returns the newest rows (at most max_rows) as one contiguous block inside the matrix.
+ * @details No copy is made. The block stays unchanged while at most one more row is
+ * appended, as long as max_rows < capacity (the appended row lands outside the view).
+ * @param m Pointer to the vwap_matrix.
+ * @param max_rows Maximum number of rows.
+ * @param vwap Pointer to store the first (oldest) row; row r starts at `vwap + r * width`.
+ * @param minute_ts_ms Pointer to store the matching timestamps.
+ * @return Number of rows in the view.
+ */
+int vwap_matrix_view(vwap_matrix *m, int max_rows, const double **vwap, const int64_t **minute_ts_ms)
+{
+  pthread_mutex_lock(&m->lock);
+
+  int n = m->size < max_rows ? m->size : max_rows;
+  int start = m->tail_idx + m->capacity - n; // the last n rows end at the mirrored tail
+  *vwap = &m->vwap[(size_t)start * m->width];
+  *minute_ts_ms = &m->minute_ts_ms[start];
+
+  pthread_mutex_unlock(&m->lock);
+
+  return n;
+}
+
+/**
+ * @brief Sets one symbol's column to NaN in every stored row (the symbol was removed).
+ * @param m Pointer to the vwap_matrix.
+ * @param col Column to clear.
+ */
+void vwap_matrix_clear_column(vwap_matrix *m, int col)
+{
+  pthread_mutex_lock(&m->lock);
+  for (int r = 0; r < 2 * m->capacity; ++r) // both copies of the mirror
+    m->vwap[(size_t)r * m->width + col] = NAN;
+  pthread_mutex_unlock(&m->lock);
+}
+
+/**
+ * @brief Cleans up resources used by a vwap_matrix.
+ * @param m Pointer to the vwap_matrix.
+ */
+void vwap_matrix_cleanup(vwap_matrix *m)
+{
+  if (m->vwap)
+    mem_budget_add(MEM_HISTORY, -vwap_matrix_bytes(m->capacity, m->width));
+  free(m->vwap);
+  free(m->minute_ts_ms);
+  m->vwap = NULL;
+  m->minute_ts_ms = NULL;
+  pthread_mutex_destroy(&m->lock);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file vwap_matrix.h
+ * @brief All-symbol VWAP history matrix declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef VWAP_MATRIX_H
+#define VWAP_MATRIX_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Initializes a vwap_matrix.
+ * @param m Pointer to the vwap_matrix.
+ * @param capacity The maximum number of minutes (rows) to store.
+ * @param width The number of symbols per row.
+ */
+void vwap_matrix_init(vwap_matrix *m, int capacity, int width);
+
+/**
+ * @brief Appends one minute: its timestamp and every symbol's VWAP (overwrites the oldest row if full).
+ * @param m Pointer to the vwap_matrix.
+ * @param minute_ts_ms Minute timestamp.
+ * @param row `width` VWAPs, in symbol order.
+ */
+void vwap_matrix_append(vwap_matrix *m, int64_t minute_ts_ms, const double *row);
+
+/**
+ * @brief Returns the newest rows (at most max_rows) as one contiguous block inside the matrix.
+ * @details No copy is made. The block stays unchanged while at most one more row is
+ * appended, as long as max_rows < capacity (the appended row lands outside the view).
+ * @param m Pointer to the vwap_matrix.
+ * @param max_rows Maximum number of rows.
+ * @param vwap Pointer to store the first (oldest) row; row r starts at `vwap + r * width`.
+ * @param minute_ts_ms Pointer to store the matching timestamps.
+ * @return Number of rows in the view.
+ */
+int vwap_matrix_view(vwap_matrix *m, int max_rows, const double **vwap, const int64_t **minute_ts_ms);
+
+/**
+ * @brief Sets one symbol's column to NaN in every stored row (the symbol was removed).
+ * @param m Pointer to the vwap_matrix.
+ * @param col Column to clear.
+ */
+void vwap_matrix_clear_column(vwap_matrix *m, int col);
+
+/**
+ * @brief Cleans up resources used by a vwap_matrix.
+ * @param m Pointer to the vwap_matrix.
+ */
+void vwap_matrix_cleanup(vwap_matrix *m);
+
+#endif /* VWAP_MATRIX_H */
@@ -0,0 +1,239 @@
+/**
+ * @file compressor.c
+ * @brief Background compression of closed log segments implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "compressor.h"
+#include "trade_index.h"
+#include "../utils/mem_budget.h"
+#include "../utils/runtime_config.h"
+#include "../utils/time_utils.h"
+
+#include <glob.h>
+#include <sys/syscall.h>
+#include <zlib.h>
+
+#define COMPRESS_READ_BYTES (64 * 1024) /**< Segment bytes read per gzwrite */
+#define GZIP_STATE_BYTES (280 * 1024)   /**< zlib deflate state at the default window and memLevel, plus gzFile buffers */
+
+/* Pending segment paths (bounded ring, protected by lock) */
+static char pending_paths[COMPRESSOR_QUEUE_SIZE][256];
+static int pending_head, pending_count;
+static int compressor_stop_requested;
+static int64_t compressor_deadline_ns; /**< monotonic, 0 = compress everything before stopping */
+static int compressor_running;
+static pthread_t compressor_thread;
+static pthread_mutex_t compressor_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t compressor_cond = PTHREAD_COND_INITIALIZER;
+
+/**
+ * @brief Gzips a closed segment to `<path>.gz` and removes the original.
+ * @param path Path of the closed segment.
+ * @return 0 on success, -1 on error.
+ */
+static int compress_segment(const char *path)
+{
+  static char buf[COMPRESS_READ_BYTES];
+  char tmp_path[272], gz_path[264];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.gz.tmp", path);
+  snprintf(gz_path, sizeof(gz_path), "%s.gz", path);
+
+  int in_fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (in_fd < 0)
+  {
+    fprintf(stderr, "WARNING: Failed to open segment %s for compression: %s\n", path, strerror(errno));
+    return -1;
+  }
+
+  gzFile out = gzopen(tmp_path, "wb6");
+  if (!out)
+  {
+    fprintf(stderr, "WARNING: Failed to create %s\n", tmp_path);
+    close(in_fd);
+    return -1;
+  }
+
+  ssize_t n;
+  int ok = 1;
+  while ((n = read(in_fd, buf, sizeof(buf))) > 0)
+  {
+    if (gzwrite(out, buf, (unsigned)n) != (int)n)
+    {
+      ok = 0;
+      break;
+    }
+  }
+  if (n < 0)
+    ok = 0;
+
+  close(in_fd);
+  if (gzclose(out) != Z_OK)
+    ok = 0;
+
+  /* publish the compressed segment atomically, then drop the original */
+  if (!ok || rename(tmp_path, gz_path) < 0)
+  {
+    fprintf(stderr, "WARNING: Failed to compress segment %s\n", path);
+    unlink(tmp_path);
+    return -1;
+  }
+
+  unlink(path);
+  return 0;
+}
+
+/**
+ * @brief Deletes the oldest compressed segments of a stream beyond the configured retention.
+ * @param path Path of a segment of the stream (`<dir>/<name>.<stamp>.<ext>`).
+ */
+static void prune_old_segments(const char *path)
+{
+  int retain = runtime_config_current()->retain_segments;
+  if (retain <= 0)
+    return;
+
+  /* split <dir>/<name>.<stamp>.<ext> into a glob over the stream's segments */
+  char stream[256];
+  snprintf(stream, sizeof(stream), "%s", path);
+  char *ext = strrchr(stream, '.');
+  if (!ext)
+    return;
+  *ext++ = '\0';
+  char *stamp = strrchr(stream, '.');
+  if (!stamp)
+    return;
+  *stamp = '\0';
+
+  char pattern[300];
+  snprintf(pattern, sizeof(pattern), "%s.*.%s.gz", stream, ext);
+
+  glob_t g;
+  if (glob(pattern, 0, NULL, &g) != 0)
+    return;
+
+  /* glob output is sorted and stamps sort chronologically */
+  for (size_t i = 0; i + retain < g.gl_pathc; ++i)
+  {
+    if (unlink(g.gl_pathv[i]) < 0)
+      fprintf(stderr, "WARNING: Failed to remove old segment %s: %s\n", g.gl_pathv[i], strerror(errno));
+
+    /* drop the segment's sidecar index (<segment>.idx, named after the uncompressed file) */
+    char index_path[300];
+    size_t base_len = strlen(g.gl_pathv[i]) - strlen(".gz");
+    snprintf(index_path, sizeof(index_path), "%.*s%s", (int)base_len, g.gl_pathv[i], TRADE_INDEX_SUFFIX);
+    unlink(index_path);
+  }
+
+  globfree(&g);
+}
+
+/**
+ * @brief Compressor thread: runs at the lowest priority so it never competes with ingestion.
+ * @param arg Thread argument (unused).
+ * @return NULL.
+ */
+static void *segment_compressor_thread_fn(void *arg)
+{
+  (void)arg;
+  char path[256];
+
+  /* nice applies per thread on Linux when addressed by tid */
+  if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19) < 0)
+    fprintf(stderr, "WARNING: Failed to lower compressor thread priority: %s\n", strerror(errno));
+
+  pthread_mutex_lock(&compressor_lock);
+  while (1)
+  {
+    while (pending_count == 0 && !compressor_stop_requested)
+      pthread_cond_wait(&compressor_cond, &compressor_lock);
+
+    if (pending_count == 0) // stop requested and nothing left
+      break;
+    if (compressor_stop_requested && compressor_deadline_ns > 0 && now_monotonic_ns() >= compressor_deadline_ns)
+    {
+      fprintf(stderr, "WARNING: Shutdown budget spent, leaving %d segments uncompressed\n", pending_count);
+      break;
+    }
+
+    memcpy(path, pending_paths[pending_head], sizeof(path));
+    pending_head = (pending_head + 1) % COMPRESSOR_QUEUE_SIZE;
+    pending_count--;
+
+    pthread_mutex_unlock(&compressor_lock);
+    if (compress_segment(path) == 0)
+      prune_old_segments(path);
+    pthread_mutex_lock(&compressor_lock);
+  }
+  pthread_mutex_unlock(&compressor_lock);
+
+  return NULL;
+}
+
+/**
+ * @brief Starts the low-priority compressor thread.
+ * @return 0 on success, -1 on error.
+ */
+int segment_compressor_start(void)
+{
+  compressor_stop_requested = 0;
+
+  if (pthread_create(&compressor_thread, NULL, segment_compressor_thread_fn, NULL) != 0)
+  {
+    fprintf(stderr, "ERROR: Failed to create compressor thread: %s\n", strerror(errno));
+    return -1;
+  }
+
+  compressor_running = 1;
+  mem_budget_add(MEM_WRITERS, COMPRESS_READ_BYTES + GZIP_STATE_BYTES);
+  return 0;
+}
+
+/**
+ * @brief Queues a closed segment for compression and retention pruning.
+ * @details Non-blocking. If the queue is full the segment is left uncompressed
+ * on disk and picked up again on the next start.
+ * @param path Path of the closed segment.
+ */
+void segment_compressor_submit(const char *path)
+{
+  pthread_mutex_lock(&compressor_lock);
+
+  if (pending_count == COMPRESSOR_QUEUE_SIZE)
+  {
+    pthread_mutex_unlock(&compressor_lock);
+    fprintf(stderr, "WARNING: Compressor queue full, leaving %s uncompressed\n", path);
+    return;
+  }
+
+  int idx = (pending_head + pending_count) % COMPRESSOR_QUEUE_SIZE;
+  snprintf(pending_paths[idx], sizeof(pending_paths[idx]), "%s", path);
+  pending_count++;
+  pthread_cond_signal(&compressor_cond);
+
+  pthread_mutex_unlock(&compressor_lock);
+}
+
+/**
+ * @brief Compresses what is still queued until a deadline, then stops the compressor thread.
+ * @details Segments not started by the deadline stay uncompressed on disk and are picked
+ * up again on the next start.
+ * @param deadline_ns Monotonic deadline (now_monotonic_ns), or 0 for none.
+ */
+void segment_compressor_stop(int64_t deadline_ns)
+{
+  if (!compressor_running)
+    return;
+
+  pthread_mutex_lock(&compressor_lock);
+  compressor_stop_requested = 1;
+  compressor_deadline_ns = deadline_ns;
+  pthread_cond_signal(&compressor_cond);
+  pthread_mutex_unlock(&compressor_lock);
+
+  pthread_join(compressor_thread, NULL);
+  compressor_running = 0;
+  mem_budget_add(MEM_WRITERS, -(COMPRESS_READ_BYTES + GZIP_STATE_BYTES));
+}
@@ -0,0 +1,36 @@
+/**
+ * @file compressor.h
+ * @brief Background compression of closed log segments declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Starts the low-priority compressor thread.
+ * @return 0 on success, -1 on error.
+ */
+int segment_compressor_start(void);
+
+/**
+ * @brief Queues a closed segment for compression and retention pruning.
+ * @details Non-blocking. If the queue is full the segment is left uncompressed
+ * on disk and picked up again on the next start.
+ * @param path Path of the closed segment.
+ */
+void segment_compressor_submit(const char *path);
+
+/**
+ * @brief Compresses what is still queued until a deadline, then stops the compressor thread.
+ * @details Segments not started by the deadline stay uncompressed on disk and are picked
+ * up again on the next start.
+ * @param deadline_ns Monotonic deadline (now_monotonic_ns), or 0 for none.
+ */
+void segment_compressor_stop(int64_t deadline_ns);
+
+#endif /* COMPRESSOR_H */
@@ -0,0 +1,66 @@
+/**
+ * @file latency_record.h
+ * @brief On-disk format of the binary latency log
+ *
+ * A segment is the 8-byte magic followed by fixed-width 16-byte records. Exchange
+ * timestamps are delta-encoded against the previous record; a rebase record (first
+ * in every segment, and whenever a delta would overflow) carries an absolute value.
+ * Kept free of libwebsockets/common.h so offline tools can include it.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef LATENCY_RECORD_H
+#define LATENCY_RECORD_H
+
+#include <stdint.h>
+
+/** Magic at the start of every binary latency segment (no NUL, so it doubles as a text header). */
+#define LATENCY_LOG_MAGIC "OKXLAT1\n"
+#define LATENCY_LOG_MAGIC_LEN 8
+
+/** symbol_index value marking a rebase record. */
+#define LATENCY_REBASE_SYMBOL 0xFFFF
+
+/**
+ * @brief One trade's latency measurements (16 bytes, little-endian host order).
+ * @details For a rebase record, `symbol_index` is LATENCY_REBASE_SYMBOL and the absolute
+ * exchange timestamp is `((uint64_t)network_latency_ms << 32) | (uint32_t)processing_latency_ms`.
+ */
+typedef struct
+{
+  int32_t exchange_delta_ms;     /**< exchange_ts minus the previous record's exchange_ts */
+  int32_t network_latency_ms;    /**< recv_ts - exchange_ts (saturated to int32) */
+  int32_t processing_latency_ms; /**< process_ts - recv_ts (saturated to int32) */
+  uint16_t symbol_index;         /**< index in SYMBOLS, or LATENCY_REBASE_SYMBOL */
+  uint16_t reserved;
+} latency_record;
+
+/**
+ * @brief Builds a rebase record carrying an absolute exchange timestamp.
+ * @param exchange_ts_ms Absolute exchange timestamp.
+ * @return The rebase record.
+ */
+static inline latency_record latency_record_rebase(int64_t exchange_ts_ms)
+{
+  latency_record rec;
+  rec.exchange_delta_ms = 0;
+  rec.network_latency_ms = (int32_t)((uint64_t)exchange_ts_ms >> 32);
+  rec.processing_latency_ms = (int32_t)(uint32_t)exchange_ts_ms;
+  rec.symbol_index = LATENCY_REBASE_SYMBOL;
+  rec.reserved = 0;
+  return rec;
+}
+
+/**
+ * @brief Extracts the absolute exchange timestamp of a rebase record.
+ * @param rec Pointer to a rebase record.
+ * @return Absolute exchange timestamp.
+ */
+static inline int64_t latency_record_rebase_ts(const latency_record *rec)
+{
+  return (int64_t)(((uint64_t)(uint32_t)rec->network_latency_ms << 32) | (uint32_t)rec->processing_latency_ms);
+}
+
+#endif /* LATENCY_RECORD_H */
@@ -7,7 +7,12 @@
  */
 
 #include "logger.h"
+#include "rotation.h"
+#include "segment_log.h"
+#include "latency_record.h"
 #include "../utils/time_utils.h"
+#include "../utils/runtime_config.h"
+#include "../utils/mem_budget.h"
 
 /**
  * @brief Ensures all necessary data directories exist.
@@ -19,6 +24,12 @@ void ensure_BASE_DATA_DIRs(void)
   mkdir(METRICS_DIR, 0755);     // Create metrics directory
   mkdir(VWAP_DIR, 0755);        // Create VWAP directory
   mkdir(CORRELATION_DIR, 0755); // Create correlations directory
+  mkdir(BARS_DIR, 0755);        // Create OHLCV bars directory
+  mkdir(FLOW_DIR, 0755);        // Create order-flow directory
+  mkdir(VOLATILITY_DIR, 0755);  // Create volatility directory
+  mkdir(QUANTILES_DIR, 0755);   // Create window quantiles directory
+  mkdir(RANGE_DIR, 0755);       // Create window range directory
+  mkdir(PROFILE_DIR, 0755);     // Create TWAP / volume profile directory
   mkdir(PERFORMANCE_LOGS_DIR, 0755); // Create performance directory
 }
 
@@ -45,39 +56,29 @@ int open_log_fd_append(const char *dir, const char *name, const char *ext)
  */
 void trade_log_append(int symbol_index, const raw_trade_message *msg)
 {
-  int fd = symbols[symbol_index].trade_log_fd;
-  if (fd < 0)
+  segment_log *log = &symbols[symbol_index].trade_log;
+  if (!log->map)
   {
-    fprintf(stderr, "ERROR: Trade log file descriptor not opened for symbol %s\n", 
+    fprintf(stderr, "ERROR: Trade log segment not mapped for symbol %s\n", 
             symbols[symbol_index].symbol);
     return;
   }
 
-  /* CSV format: raw_json */
-  char line[2048];
-  int len = snprintf(line, sizeof(line), "%s\n", msg->raw_json);
-
-  ssize_t result = write(fd, line, len);
-  if (result < 0) {
-    fprintf(stderr, "ERROR: Failed to write trade log for symbol %s: %s\n", 
-            symbols[symbol_index].symbol, strerror(errno));
-    return;
-  }
-
-  if (FSYNC_PER_WRITE)
-  {
-    if (fsync(fd) < 0) {
-      fprintf(stderr, "WARNING: Failed to sync trade log for symbol %s: %s\n", 
-              symbols[symbol_index].symbol, strerror(errno));
-    }
+  /* JSONL format: raw_json, copied straight into the mapped segment */
+  if (segment_log_append_line(log, msg->raw_json, strlen(msg->raw_json),
+                              msg->exchange_ts_ms, msg->receive_ts_ms) < 0) {
+    fprintf(stderr, "ERROR: Failed to write trade log for symbol %s\n", 
+            symbols[symbol_index].symbol);
   }
 }
 
 /**
  * @brief Logs system performance metrics (CPU, memory) to a CSV file.
+ * @details Next to VmRSS, each row carries the accounted memory in total and per subsystem
+ * (see mem_budget.h).
  * @param timestamp_ms The timestamp of the measurement.
  * @param cpu_percent The CPU utilization percentage.
- * @param mem_mb The memory usage in megabytes.
+ * @param mem_mb The memory usage (VmRSS) in megabytes.
  */
 void log_system_metrics(int64_t timestamp_ms, double cpu_percent, double mem_mb)
 {
@@ -91,8 +92,12 @@ void log_system_metrics(int64_t timestamp_ms, double cpu_percent, double mem_mb)
     return;
   }
 
-  /* CSV format: timestamp_ms,cpu_percent,memory_mb */
-  if (fprintf(syslog, "%" PRId64 ",%.2f,%.2f\n", timestamp_ms, cpu_percent, mem_mb) < 0) {
+  /* CSV format: timestamp_ms,cpu_percent,memory_mb,accounted_mb,<subsystem>_mb... */
+  int rc = fprintf(syslog, "%" PRId64 ",%.2f,%.2f,%.2f", timestamp_ms, cpu_percent, mem_mb,
+                   mem_budget_total() / (1024.0 * 1024.0));
+  for (int s = 0; s < NUM_MEM_SUBSYSTEMS && rc >= 0; ++s)
+    rc = fprintf(syslog, ",%.2f", mem_budget_used((mem_subsystem)s) / (1024.0 * 1024.0));
+  if (rc < 0 || fputc('\n', syslog) == EOF) {
     fprintf(stderr, "WARNING: Failed to write system metrics\n");
   }
 
@@ -127,6 +132,61 @@ void log_scheduler_metrics(int64_t scheduled_ms, int64_t actual_ms, int64_t drif
   fclose(schedlog);
 }
 
+/**
+ * @brief Clamps a millisecond difference into a 32-bit record field.
+ * @param value_ms Difference in milliseconds.
+ * @return The clamped value.
+ */
+static int32_t clamp_i32(int64_t value_ms)
+{
+  if (value_ms > INT32_MAX)
+    return INT32_MAX;
+  if (value_ms < INT32_MIN)
+    return INT32_MIN;
+  return (int32_t)value_ms;
+}
+
+/**
+ * @brief Encodes latency metrics as a binary record (see latency_record.h).
+ * @details Exchange timestamps are delta-encoded; every segment opens with a rebase
+ * record so it can be decoded on its own. Trade processor thread only.
+ * @param symbol_index Index of the symbol.
+ * @param exchange_ts_ms Exchange timestamp.
+ * @param network_latency Network latency in ms.
+ * @param processing_latency Processing latency in ms.
+ * @param process_ts_ms Processing timestamp (drives rotation).
+ * @return Number of bytes written, or -1 on error.
+ */
+static ssize_t write_latency_record(int symbol_index, int64_t exchange_ts_ms, int64_t network_latency,
+                                    int64_t processing_latency, int64_t process_ts_ms)
+{
+  static int64_t prev_exchange_ts_ms = 0;
+  static int based = 0; // a rebase record has been written since this process opened the log
+
+  latency_record recs[2];
+  int n = 0;
+
+  int fresh_segment = rotating_log_rotate_if_due(&latency_log, sizeof(recs), process_ts_ms);
+  int64_t delta = exchange_ts_ms - prev_exchange_ts_ms;
+
+  if (fresh_segment || !based || delta > INT32_MAX || delta < INT32_MIN)
+  {
+    recs[n++] = latency_record_rebase(exchange_ts_ms);
+    based = 1;
+    delta = 0;
+  }
+
+  recs[n].exchange_delta_ms = (int32_t)delta;
+  recs[n].network_latency_ms = clamp_i32(network_latency);
+  recs[n].processing_latency_ms = clamp_i32(processing_latency);
+  recs[n].symbol_index = (uint16_t)symbol_index;
+  recs[n].reserved = 0;
+  n++;
+
+  prev_exchange_ts_ms = exchange_ts_ms;
+  return rotating_log_write(&latency_log, recs, n * sizeof(latency_record), process_ts_ms);
+}
+
 /**
  * @brief Log latency metrics for a trade.
  * @param symbol_index Index of the symbol.
@@ -136,7 +196,7 @@ void log_scheduler_metrics(int64_t scheduled_ms, int64_t actual_ms, int64_t drif
  */
 void log_latency_metrics(int symbol_index, int64_t exchange_ts_ms, int64_t recv_ts_ms, int64_t process_ts_ms)
 {
-  if (latency_log_fd < 0)
+  if (latency_log.fd < 0)
   {
     fprintf(stderr, "ERROR: Latency log file descriptor not opened\n");
     return;
@@ -145,23 +205,32 @@ void log_latency_metrics(int symbol_index, int64_t exchange_ts_ms, int64_t recv_
   int64_t network_latency = recv_ts_ms - exchange_ts_ms;
   int64_t processing_latency = process_ts_ms - recv_ts_ms;
   int64_t total_latency = process_ts_ms - exchange_ts_ms;
+  ssize_t result;
 
-  /* CSV format: symbol_index,exchange_ts,recv_ts,process_ts,network_lat,process_lat,total_lat */
-  char line[256];
-  int len = snprintf(line, sizeof(line),
-                     "%d,%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 "\n",
-                     symbol_index, exchange_ts_ms, recv_ts_ms, process_ts_ms,
-                     network_latency, processing_latency, total_latency);
+  if (LATENCY_LOG_BINARY)
+  {
+    result = write_latency_record(symbol_index, exchange_ts_ms, network_latency, processing_latency, process_ts_ms);
+  }
+  else
+  {
+    /* CSV format: symbol_index,exchange_ts,recv_ts,process_ts,network_lat,process_lat,total_lat */
+    char line[256];
+    int len = snprintf(line, sizeof(line),
+                       "%d,%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 "\n",
+                       symbol_index, exchange_ts_ms, recv_ts_ms, process_ts_ms,
+                       network_latency, processing_latency, total_latency);
+
+    result = rotating_log_write(&latency_log, line, len, process_ts_ms);
+  }
 
-  ssize_t result = write(latency_log_fd, line, len);
   if (result < 0) {
     fprintf(stderr, "ERROR: Failed to write latency metrics: %s\n", strerror(errno));
     return;
   }
 
-  if (FSYNC_PER_WRITE)
+  if (runtime_config_current()->fsync_per_write)
   {
-    if (fsync(latency_log_fd) < 0) {
+    if (fsync(latency_log.fd) < 0) {
       fprintf(stderr, "WARNING: Failed to sync latency log: %s\n", strerror(errno));
     }
   }
@@ -234,62 +303,421 @@ void correlation_log_append_csv(int symbol_idx, int64_t minute_ts_ms, const char
 }
 
 /**
- * @brief Initializes all log files and writes headers if they are new.
+ * @brief Appends an OHLCV bar to the symbol's bar CSV.
+ * @param symbol_idx The index of the symbol.
+ * @param bar Pointer to the closed bar.
  */
-void init_output_files(void)
+void bar_log_append_csv(int symbol_idx, const ohlcv_bar *bar)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.csv", BARS_DIR, symbols[symbol_idx].symbol);
+  FILE *fp = fopen(path, "a");
+
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open bar log file for %s: %s\n",
+            symbols[symbol_idx].symbol, strerror(errno));
+    return;
+  }
+
+  char iso[64];
+  format_minute_iso(bar->start_ms, iso, sizeof(iso));
+  double vwap = bar->volume > 0 ? bar->notional / bar->volume : NAN;
+
+  /* CSV format: timestamp,interval,open,high,low,close,volume,trades,vwap */
+  if (fprintf(fp, "%s,%d,%.12g,%.12g,%.12g,%.12g,%.12g,%" PRIu32 ",%.12g\n", iso, bar->interval_minutes,
+              bar->open, bar->high, bar->low, bar->close, bar->volume, bar->trade_count, vwap) < 0) {
+    fprintf(stderr, "WARNING: Failed to write bar data for %s\n", symbols[symbol_idx].symbol);
+  }
+
+  fclose(fp);
+}
+
+/**
+ * @brief Appends the window's buy/sell order flow to the symbol's flow CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param flow Pointer to the order-flow snapshot.
+ */
+void flow_log_append_csv(int idx, int64_t minute_ts_ms, const trade_flow *flow)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.csv", FLOW_DIR, symbols[idx].symbol);
+  FILE *fp = fopen(path, "a");
+
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open flow log file for %s: %s\n",
+            symbols[idx].symbol, strerror(errno));
+    return;
+  }
+
+  char iso[64];
+  format_minute_iso(minute_ts_ms, iso, sizeof(iso));
+
+  if (fprintf(fp, "%s,%.12g,%.12g,%.6f,%.12g,%.12g\n", iso, flow->buy_volume, flow->sell_volume,
+              flow->imbalance, flow->buy_vwap, flow->sell_vwap) < 0) {
+    fprintf(stderr, "WARNING: Failed to write flow data for %s\n", symbols[idx].symbol);
+  }
+
+  fclose(fp);
+}
+
+/**
+ * @brief Appends volatility estimates (as volatilities over the window) to the symbol's CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param est Pointer to the variance estimates.
+ */
+void volatility_log_append_csv(int idx, int64_t minute_ts_ms, const volatility_estimate *est)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.csv", VOLATILITY_DIR, symbols[idx].symbol);
+  FILE *fp = fopen(path, "a");
+
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open volatility log file for %s: %s\n",
+            symbols[idx].symbol, strerror(errno));
+    return;
+  }
+
+  char iso[64];
+  format_minute_iso(minute_ts_ms, iso, sizeof(iso));
+
+  if (fprintf(fp, "%s,%.6g,%.6g,%.6g,%.6g\n", iso, sqrt(est->realized_var), sqrt(est->parkinson_var),
+              sqrt(est->garman_klass_var), sqrt(est->ewma_var)) < 0) {
+    fprintf(stderr, "WARNING: Failed to write volatility data for %s\n", symbols[idx].symbol);
+  }
+
+  fclose(fp);
+}
+
+/**
+ * @brief Appends the window's price/size quantiles to the symbol's quantiles CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param wq Pointer to the quantile snapshot.
+ */
+void quantiles_log_append_csv(int idx, int64_t minute_ts_ms, const window_quantiles *wq)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.csv", QUANTILES_DIR, symbols[idx].symbol);
+  FILE *fp = fopen(path, "a");
+
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open quantiles log file for %s: %s\n",
+            symbols[idx].symbol, strerror(errno));
+    return;
+  }
+
+  char iso[64];
+  format_minute_iso(minute_ts_ms, iso, sizeof(iso));
+
+  if (fprintf(fp, "%s,%.12g,%.12g,%.12g,%.12g\n", iso, wq->price_p50, wq->size_p50, wq->size_p90,
+              wq->size_p99) < 0) {
+    fprintf(stderr, "WARNING: Failed to write quantiles data for %s\n", symbols[idx].symbol);
+  }
+
+  fclose(fp);
+}
+
+/**
+ * @brief Appends the window's high/low range to the symbol's range CSV.
+ * @details `range_bps` is (high - low) / low in basis points; `position` places the last
+ * price within the range (0 = at the low, 1 = at the high, i.e. a breakout of that side).
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param range Pointer to the range snapshot.
+ */
+void range_log_append_csv(int idx, int64_t minute_ts_ms, const window_range *range)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.csv", RANGE_DIR, symbols[idx].symbol);
+  FILE *fp = fopen(path, "a");
+
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open range log file for %s: %s\n",
+            symbols[idx].symbol, strerror(errno));
+    return;
+  }
+
+  char iso[64];
+  format_minute_iso(minute_ts_ms, iso, sizeof(iso));
+
+  double width = range->high - range->low;
+  double range_bps = range->low > 0 ? 1e4 * width / range->low : NAN;
+  double position = width > 0 ? (range->last_price - range->low) / width : NAN;
+
+  if (fprintf(fp, "%s,%.12g,%.12g,%.12g,%.3f,%.4f\n", iso, range->high, range->low, range->last_price,
+              range_bps, position) < 0) {
+    fprintf(stderr, "WARNING: Failed to write range data for %s\n", symbols[idx].symbol);
+  }
+
+  fclose(fp);
+}
+
+/**
+ * @brief Appends the window's TWAP and volume profile levels to the symbol's profile CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param profile Pointer to the profile snapshot.
+ */
+void profile_log_append_csv(int idx, int64_t minute_ts_ms, const window_profile *profile)
 {
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.csv", PROFILE_DIR, symbols[idx].symbol);
+  FILE *fp = fopen(path, "a");
 
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open profile log file for %s: %s\n",
+            symbols[idx].symbol, strerror(errno));
+    return;
+  }
+
+  char iso[64];
+  format_minute_iso(minute_ts_ms, iso, sizeof(iso));
+
+  if (fprintf(fp, "%s,%.12g,%.12g,%.12g,%.12g\n", iso, profile->twap, profile->poc, profile->value_area_low,
+              profile->value_area_high) < 0) {
+    fprintf(stderr, "WARNING: Failed to write profile data for %s\n", symbols[idx].symbol);
+  }
+
+  fclose(fp);
+}
+
+/**
+ * @brief Appends a symbol's window occupancy, capacity and eviction counters to the window CSV.
+ * @details One file for all symbols (performance/windows.csv), a row per symbol and minute.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param occ Pointer to the occupancy snapshot.
+ */
+void window_log_append_csv(int idx, int64_t minute_ts_ms, const window_occupancy *occ)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/windows.csv", PERFORMANCE_LOGS_DIR);
+  FILE *fp = fopen(path, "a");
+
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open window metrics log: %s\n", strerror(errno));
+    return;
+  }
+
+  /* CSV format: minute_ts_ms,symbol,trades,peak_trades,capacity_trades,memory_kb,forced_evictions,chunk_allocs,pool_free_chunks */
+  if (fprintf(fp, "%" PRId64 ",%s,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%.1f,%" PRIu64 ",%" PRIu64 ",%" PRIu32 "\n", minute_ts_ms,
+              symbols[idx].symbol, occ->trades, occ->peak_trades, occ->capacity_trades, occ->memory_bytes / 1024.0,
+              occ->forced_evictions, occ->chunk_allocs, occ->pool_free_chunks) < 0) {
+    fprintf(stderr, "WARNING: Failed to write window metrics for %s\n", symbols[idx].symbol);
+  }
+
+  fclose(fp);
+}
+
+/**
+ * @brief Maps the trade log of one symbol.
+ * @param idx Index of the symbol.
+ */
+void init_symbol_ingest_files(int idx)
+{
+  /* map trade log segments (rolled over by the trade processor thread) */
+  if (segment_log_open(&symbols[idx].trade_log, TRADES_LOG_DIR, symbols[idx].symbol, "jsonl",
+                       runtime_config_current()->trade_log_rotate) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to open trade log file for %s: %s\n", 
+            symbols[idx].symbol, strerror(errno));
+  }
+}
+
+/**
+ * @brief Opens the trade segment logs and the latency log (the ingest side's outputs).
+ */
+void init_ingest_output_files(void)
+{
   for (int i = 0; i < NUM_SYMBOLS; ++i)
+    if (symbols[i].symbol[0])
+      init_symbol_ingest_files(i);
+
+  /* open network latency log file (kept open, rotated by the trade processor thread) */
+  const char *latency_header = "symbol_index,exchange_ts_ms,recv_ts_ms,process_ts_ms,"
+                               "network_latency_ms,processing_latency_ms,total_latency_ms\n";
+  if (LATENCY_LOG_BINARY)
+    latency_header = LATENCY_LOG_MAGIC;
+
+  if (rotating_log_open(&latency_log, PERFORMANCE_LOGS_DIR, "latency", LATENCY_LOG_BINARY ? "bin" : "csv",
+                        latency_header, runtime_config_current()->latency_log_rotate) < 0)
+  {
+    perror("open network latency file");
+  }
+}
+
+/**
+ * @brief Writes the headers of one symbol's per-minute metric CSVs if they are new.
+ * @param idx Index of the symbol.
+ */
+void init_symbol_analytics_files(int idx)
+{
+  /* initialize moving stats files with headers */
+  int vwap_fd = open_log_fd_append(VWAP_DIR, symbols[idx].symbol, "csv");
+  if (vwap_fd >= 0)
   {
-    /* open trade log files (kept open as file descriptors) */
-    symbols[i].trade_log_fd = open_log_fd_append(TRADES_LOG_DIR, symbols[i].symbol, "jsonl");
-    if (symbols[i].trade_log_fd < 0)
+    struct stat st;
+    if (fstat(vwap_fd, &st) == 0 && st.st_size == 0)
     {
-      fprintf(stderr, "ERROR: Failed to open trade log file for %s: %s\n", 
-              symbols[i].symbol, strerror(errno));
-      symbols[i].trade_log_fd = -1;
+      const char *moving_header = "timestamp_iso,vwap\n";
+      ssize_t result = write(vwap_fd, moving_header, strlen(moving_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write VWAP header for %s\n", symbols[idx].symbol);
+      }
+      if (runtime_config_current()->fsync_per_write)
+        fsync(vwap_fd);
     }
+    close(vwap_fd);
+  } else {
+    fprintf(stderr, "ERROR: Failed to open VWAP log file for %s: %s\n", 
+            symbols[idx].symbol, strerror(errno));
+  }
 
-    /* initialize moving stats files with headers */
-    int vwap_fd = open_log_fd_append(VWAP_DIR, symbols[i].symbol, "csv");
-    if (vwap_fd >= 0)
+  /* initialize per-symbol correlation files */
+  int corr_log_fd = open_log_fd_append(CORRELATION_DIR, symbols[idx].symbol, "csv");
+  if (corr_log_fd >= 0)
+  {
+    struct stat st;
+    if (fstat(corr_log_fd, &st) == 0 && st.st_size == 0)
     {
-      struct stat st;
-      if (fstat(vwap_fd, &st) == 0 && st.st_size == 0)
-      {
-        const char *moving_header = "timestamp_iso,vwap\n";
-        ssize_t result = write(vwap_fd, moving_header, strlen(moving_header));
-        if (result < 0) {
-          fprintf(stderr, "WARNING: Failed to write VWAP header for %s\n", symbols[i].symbol);
-        }
-        if (FSYNC_PER_WRITE)
-          fsync(vwap_fd);
+      const char *corr_header = "timestamp_iso,correlated_with,correlation,lag_timestamp_iso\n";
+      ssize_t result = write(corr_log_fd, corr_header, strlen(corr_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write correlation header for %s\n", symbols[idx].symbol);
       }
-      close(vwap_fd);
-    } else {
-      fprintf(stderr, "ERROR: Failed to open VWAP log file for %s: %s\n", 
-              symbols[i].symbol, strerror(errno));
+      if (runtime_config_current()->fsync_per_write)
+        fsync(corr_log_fd);
     }
+    close(corr_log_fd);
+  }
 
-    /* initialize per-symbol correlation files */
-    int corr_log_fd = open_log_fd_append(CORRELATION_DIR, symbols[i].symbol, "csv");
-    if (corr_log_fd >= 0)
+  /* initialize per-symbol OHLCV bar files */
+  int bar_log_fd = open_log_fd_append(BARS_DIR, symbols[idx].symbol, "csv");
+  if (bar_log_fd >= 0)
+  {
+    struct stat st;
+    if (fstat(bar_log_fd, &st) == 0 && st.st_size == 0)
     {
-      struct stat st;
-      if (fstat(corr_log_fd, &st) == 0 && st.st_size == 0)
-      {
-        const char *corr_header = "timestamp_iso,correlated_with,correlation,lag_timestamp_iso\n";
-        ssize_t result = write(corr_log_fd, corr_header, strlen(corr_header));
-        if (result < 0) {
-          fprintf(stderr, "WARNING: Failed to write correlation header for %s\n", symbols[i].symbol);
-        }
-        if (FSYNC_PER_WRITE)
-          fsync(corr_log_fd);
+      const char *bar_header = "timestamp_iso,interval_minutes,open,high,low,close,volume,trades,vwap\n";
+      ssize_t result = write(bar_log_fd, bar_header, strlen(bar_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write bar header for %s\n", symbols[idx].symbol);
+      }
+      if (runtime_config_current()->fsync_per_write)
+        fsync(bar_log_fd);
+    }
+    close(bar_log_fd);
+  }
+
+  /* initialize per-symbol order-flow files */
+  int flow_log_fd = open_log_fd_append(FLOW_DIR, symbols[idx].symbol, "csv");
+  if (flow_log_fd >= 0)
+  {
+    struct stat st;
+    if (fstat(flow_log_fd, &st) == 0 && st.st_size == 0)
+    {
+      const char *flow_header = "timestamp_iso,buy_volume,sell_volume,imbalance,buy_vwap,sell_vwap\n";
+      ssize_t result = write(flow_log_fd, flow_header, strlen(flow_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write flow header for %s\n", symbols[idx].symbol);
       }
-      close(corr_log_fd);
+      if (runtime_config_current()->fsync_per_write)
+        fsync(flow_log_fd);
     }
+    close(flow_log_fd);
   }
 
+  /* initialize per-symbol volatility files */
+  int vol_log_fd = open_log_fd_append(VOLATILITY_DIR, symbols[idx].symbol, "csv");
+  if (vol_log_fd >= 0)
+  {
+    struct stat st;
+    if (fstat(vol_log_fd, &st) == 0 && st.st_size == 0)
+    {
+      const char *vol_header = "timestamp_iso,realized_vol,parkinson_vol,garman_klass_vol,ewma_vol\n";
+      ssize_t result = write(vol_log_fd, vol_header, strlen(vol_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write volatility header for %s\n", symbols[idx].symbol);
+      }
+      if (runtime_config_current()->fsync_per_write)
+        fsync(vol_log_fd);
+    }
+    close(vol_log_fd);
+  }
+
+  /* initialize per-symbol window quantile files */
+  int quantiles_log_fd = open_log_fd_append(QUANTILES_DIR, symbols[idx].symbol, "csv");
+  if (quantiles_log_fd >= 0)
+  {
+    struct stat st;
+    if (fstat(quantiles_log_fd, &st) == 0 && st.st_size == 0)
+    {
+      const char *quantiles_header = "timestamp_iso,median_price,size_p50,size_p90,size_p99\n";
+      ssize_t result = write(quantiles_log_fd, quantiles_header, strlen(quantiles_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write quantiles header for %s\n", symbols[idx].symbol);
+      }
+      if (runtime_config_current()->fsync_per_write)
+        fsync(quantiles_log_fd);
+    }
+    close(quantiles_log_fd);
+  }
+
+  /* initialize per-symbol window range files */
+  int range_log_fd = open_log_fd_append(RANGE_DIR, symbols[idx].symbol, "csv");
+  if (range_log_fd >= 0)
+  {
+    struct stat st;
+    if (fstat(range_log_fd, &st) == 0 && st.st_size == 0)
+    {
+      const char *range_header = "timestamp_iso,high,low,last_price,range_bps,position\n";
+      ssize_t result = write(range_log_fd, range_header, strlen(range_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write range header for %s\n", symbols[idx].symbol);
+      }
+      if (runtime_config_current()->fsync_per_write)
+        fsync(range_log_fd);
+    }
+    close(range_log_fd);
+  }
+
+  /* initialize per-symbol TWAP / volume profile files */
+  int profile_log_fd = open_log_fd_append(PROFILE_DIR, symbols[idx].symbol, "csv");
+  if (profile_log_fd >= 0)
+  {
+    struct stat st;
+    if (fstat(profile_log_fd, &st) == 0 && st.st_size == 0)
+    {
+      const char *profile_header = "timestamp_iso,twap,poc,value_area_low,value_area_high\n";
+      ssize_t result = write(profile_log_fd, profile_header, strlen(profile_header));
+      if (result < 0) {
+        fprintf(stderr, "WARNING: Failed to write profile header for %s\n", symbols[idx].symbol);
+      }
+      if (runtime_config_current()->fsync_per_write)
+        fsync(profile_log_fd);
+    }
+    close(profile_log_fd);
+  }
+}
+
+/**
+ * @brief Writes the headers of the per-minute metric and performance CSVs if they are new.
+ */
+void init_analytics_output_files(void)
+{
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+    if (symbols[i].symbol[0])
+      init_symbol_analytics_files(i);
+
   /* initialize system resource log file */
   {
     int system_log_fd = open_log_fd_append(PERFORMANCE_LOGS_DIR, "system", "csv");
@@ -298,13 +726,17 @@ void init_output_files(void)
       struct stat st;
       if (fstat(system_log_fd, &st) == 0 && st.st_size == 0)
       {
-        const char *header = "timestamp_ms,cpu_percent,memory_mb\n";
-        ssize_t result = write(system_log_fd, header, strlen(header));
+        char header[256];
+        int len = snprintf(header, sizeof(header), "timestamp_ms,cpu_percent,memory_mb,accounted_mb");
+        for (int s = 0; s < NUM_MEM_SUBSYSTEMS; ++s)
+          len += snprintf(header + len, sizeof(header) - len, ",%s_mb", mem_budget_name((mem_subsystem)s));
+        len += snprintf(header + len, sizeof(header) - len, "\n");
+        ssize_t result = write(system_log_fd, header, (size_t)len);
         if (result < 0) {
           fprintf(stderr, "WARNING: Failed to write system metrics header\n");
         }
 
-        if (FSYNC_PER_WRITE)
+        if (runtime_config_current()->fsync_per_write)
           fsync(system_log_fd);
       }
       close(system_log_fd);
@@ -325,33 +757,92 @@ void init_output_files(void)
           fprintf(stderr, "WARNING: Failed to write scheduler metrics header\n");
         }
 
-        if (FSYNC_PER_WRITE)
+        if (runtime_config_current()->fsync_per_write)
           fsync(scheduler_log_fd);
       }
       close(scheduler_log_fd);
     }
   }
 
-  /* open network latency log file (kept open as file descriptor) */
-  latency_log_fd = open_log_fd_append(PERFORMANCE_LOGS_DIR, "latency", "csv");
-  if (latency_log_fd >= 0)
+  /* initialize window occupancy log file */
   {
-    struct stat st;
-    if (fstat(latency_log_fd, &st) == 0 && st.st_size == 0)
+    int window_log_fd = open_log_fd_append(PERFORMANCE_LOGS_DIR, "windows", "csv");
+    if (window_log_fd >= 0)
     {
-      const char *latency_header = "symbol_index,exchange_ts_ms,recv_ts_ms,process_ts_ms,"
-                                   "network_latency_ms,processing_latency_ms,total_latency_ms\n";
-      ssize_t result = write(latency_log_fd, latency_header, strlen(latency_header));
-      if (result < 0) {
-        fprintf(stderr, "WARNING: Failed to write latency metrics header\n");
-      }
+      struct stat st;
+      if (fstat(window_log_fd, &st) == 0 && st.st_size == 0)
+      {
+        const char *header =
+            "minute_ts_ms,symbol,trades,peak_trades,capacity_trades,memory_kb,forced_evictions,chunk_allocs,pool_free_chunks\n";
+        ssize_t result = write(window_log_fd, header, strlen(header));
+        if (result < 0) {
+          fprintf(stderr, "WARNING: Failed to write window metrics header\n");
+        }
 
-      if (FSYNC_PER_WRITE)
-        fsync(latency_log_fd);
+        if (runtime_config_current()->fsync_per_write)
+          fsync(window_log_fd);
+      }
+      close(window_log_fd);
     }
   }
-  else
+}
+
+/**
+ * @brief Initializes all log files and writes headers if they are new.
+ */
+void init_output_files(void)
+{
+  init_ingest_output_files();
+  init_analytics_output_files();
+}
+
+/**
+ * @brief Writes the shutdown checkpoint (`CHECKPOINT_PREFIX-<role>.json`) atomically.
+ * @details Records the shutdown outcome, the configuration generation and, per symbol,
+ * the trades processed and the newest exchange timestamp, so a restart or an operator
+ * can tell where the outputs end. Written to a temporary file, synced, then renamed.
+ * @param report Shutdown outcome.
+ * @return 0 on success, -1 on error.
+ */
+int write_checkpoint(const shutdown_report *report)
+{
+  char path[128], tmp_path[136];
+  snprintf(path, sizeof(path), "%s-%s.json", CHECKPOINT_PREFIX, report->role);
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+  FILE *fp = fopen(tmp_path, "w");
+  if (!fp)
   {
-    perror("open network latency file");
+    fprintf(stderr, "ERROR: Failed to create checkpoint %s: %s\n", tmp_path, strerror(errno));
+    return -1;
   }
-}
\ No newline at end of file
+
+  const runtime_config *cfg = runtime_config_current();
+  fprintf(fp, "{\n  \"role\": \"%s\",\n", report->role);
+  fprintf(fp, "  \"requested_ms\": %" PRId64 ",\n  \"finished_ms\": %" PRId64 ",\n", report->requested_ms,
+          report->finished_ms);
+  fprintf(fp, "  \"budget_ms\": %d,\n  \"budget_exceeded\": %s,\n", report->budget_ms,
+          report->budget_exceeded ? "true" : "false");
+  fprintf(fp, "  \"queued\": %" PRIu32 ",\n  \"abandoned\": %" PRIu32 ",\n", report->queued, report->abandoned);
+  fprintf(fp, "  \"config_generation\": %" PRIu64 ",\n  \"symbols\": [", cfg->generation);
+
+  int first = 1;
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    if (!symbols[i].symbol[0])
+      continue;
+    fprintf(fp, "%s\n    {\"symbol\": \"%s\", \"trades\": %" PRIu64 ", \"last_trade_ts_ms\": %" PRId64 "}",
+            first ? "" : ",", symbols[i].symbol, symbols[i].trades, symbols[i].last_trade_ts_ms);
+    first = 0;
+  }
+  fprintf(fp, "\n  ]\n}\n");
+
+  int ok = fflush(fp) == 0 && fdatasync(fileno(fp)) == 0;
+  if (fclose(fp) != 0 || !ok || rename(tmp_path, path) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to write checkpoint %s: %s\n", path, strerror(errno));
+    unlink(tmp_path);
+    return -1;
+  }
+  return 0;
+}
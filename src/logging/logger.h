@@ -34,9 +34,11 @@ void trade_log_append(int symbol_index, const raw_trade_message *msg);
 
 /**
  * @brief Logs system performance metrics (CPU, memory) to a CSV file.
+ * @details Next to VmRSS, each row carries the accounted memory in total and per subsystem
+ * (see mem_budget.h).
  * @param timestamp_ms The timestamp of the measurement.
  * @param cpu_percent The CPU utilization percentage.
- * @param mem_mb The memory usage in megabytes.
+ * @param mem_mb The memory usage (VmRSS) in megabytes.
  */
 void log_system_metrics(int64_t timestamp_ms, double cpu_percent, double mem_mb);
 
@@ -75,9 +77,99 @@ void vwap_log_append_csv(int idx, int64_t minute_ts_ms, double vwap);
  */
 void correlation_log_append_csv(int symbol_idx, int64_t minute_ts_ms, const char *other_symbol, double corr, int64_t lag_minute_ts_ms);
 
+/**
+ * @brief Appends an OHLCV bar to the symbol's bar CSV.
+ * @param symbol_idx The index of the symbol.
+ * @param bar Pointer to the closed bar.
+ */
+void bar_log_append_csv(int symbol_idx, const ohlcv_bar *bar);
+
+/**
+ * @brief Appends the window's buy/sell order flow to the symbol's flow CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param flow Pointer to the order-flow snapshot.
+ */
+void flow_log_append_csv(int idx, int64_t minute_ts_ms, const trade_flow *flow);
+
+/**
+ * @brief Appends volatility estimates (as volatilities over the window) to the symbol's CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param est Pointer to the variance estimates.
+ */
+void volatility_log_append_csv(int idx, int64_t minute_ts_ms, const volatility_estimate *est);
+
+/**
+ * @brief Appends the window's price/size quantiles to the symbol's quantiles CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param wq Pointer to the quantile snapshot.
+ */
+void quantiles_log_append_csv(int idx, int64_t minute_ts_ms, const window_quantiles *wq);
+
+/**
+ * @brief Appends the window's high/low range to the symbol's range CSV.
+ * @details `range_bps` is (high - low) / low in basis points; `position` places the last
+ * price within the range (0 = at the low, 1 = at the high, i.e. a breakout of that side).
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param range Pointer to the range snapshot.
+ */
+void range_log_append_csv(int idx, int64_t minute_ts_ms, const window_range *range);
+
+/**
+ * @brief Appends the window's TWAP and volume profile levels to the symbol's profile CSV.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param profile Pointer to the profile snapshot.
+ */
+void profile_log_append_csv(int idx, int64_t minute_ts_ms, const window_profile *profile);
+
+/**
+ * @brief Appends a symbol's window occupancy, capacity and eviction counters to the window CSV.
+ * @details One file for all symbols (performance/windows.csv), a row per symbol and minute.
+ * @param idx The index of the symbol.
+ * @param minute_ts_ms The timestamp of the minute.
+ * @param occ Pointer to the occupancy snapshot.
+ */
+void window_log_append_csv(int idx, int64_t minute_ts_ms, const window_occupancy *occ);
+
+/**
+ * @brief Maps the trade log of one symbol.
+ * @param idx Index of the symbol.
+ */
+void init_symbol_ingest_files(int idx);
+
+/**
+ * @brief Writes the headers of one symbol's per-minute metric CSVs if they are new.
+ * @param idx Index of the symbol.
+ */
+void init_symbol_analytics_files(int idx);
+
+/**
+ * @brief Opens the trade segment logs and the latency log (the ingest side's outputs).
+ */
+void init_ingest_output_files(void);
+
+/**
+ * @brief Writes the headers of the per-minute metric and performance CSVs if they are new.
+ */
+void init_analytics_output_files(void);
+
 /**
  * @brief Initializes all log files and writes headers if they are new.
  */
 void init_output_files(void);
 
+/**
+ * @brief Writes the shutdown checkpoint (`CHECKPOINT_PREFIX-<role>.json`) atomically.
+ * @details Records the shutdown outcome, the configuration generation and, per symbol,
+ * the trades processed and the newest exchange timestamp, so a restart or an operator
+ * can tell where the outputs end. Written to a temporary file, synced, then renamed.
+ * @param report Shutdown outcome.
+ * @return 0 on success, -1 on error.
+ */
+int write_checkpoint(const shutdown_report *report);
+
 #endif /* LOGGER_H */
\ No newline at end of file
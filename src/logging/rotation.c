@@ -0,0 +1,285 @@
+/**
+ * @file rotation.c
+ * @brief Rotating append-only log file implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "rotation.h"
+#include "compressor.h"
+#include "../utils/time_utils.h"
+#include "../utils/runtime_config.h"
+
+#include <glob.h>
+
+#define MS_PER_HOUR (60 * MS_PER_MINUTE)
+#define MS_PER_DAY (24 * MS_PER_HOUR)
+
+/**
+ * @brief Computes the [start, end) rotation period containing a timestamp.
+ * @param policy Rotation policy.
+ * @param ts_ms Timestamp inside the period.
+ * @param out_start_ms Pointer to store the period start.
+ * @param out_end_ms Pointer to store the period end (INT64_MAX if not time-based).
+ */
+void rotation_period_bounds(rotate_policy policy, int64_t ts_ms, int64_t *out_start_ms, int64_t *out_end_ms)
+{
+  int64_t period_ms;
+
+  switch (policy)
+  {
+  case ROTATE_HOURLY:
+    period_ms = MS_PER_HOUR;
+    break;
+  case ROTATE_DAILY:
+    period_ms = MS_PER_DAY;
+    break;
+  default:
+    *out_start_ms = ts_ms;
+    *out_end_ms = INT64_MAX; // only size (or nothing) triggers rotation
+    return;
+  }
+
+  *out_start_ms = (ts_ms / period_ms) * period_ms;
+  *out_end_ms = *out_start_ms + period_ms;
+}
+
+/**
+ * @brief Builds the path of a closed segment: `<dir>/<name>.<YYYYmmddTHHMMSSmmm>.<ext>` (UTC).
+ * @param dir The directory path.
+ * @param name The base file name.
+ * @param ext The file extension.
+ * @param start_ms Start time of the segment.
+ * @param buf Output buffer.
+ * @param bufsz Size of buffer.
+ */
+void rotation_segment_path(const char *dir, const char *name, const char *ext, int64_t start_ms,
+                           char *buf, size_t bufsz)
+{
+  char stamp[32];
+  time_t sec = start_ms / 1000;
+  struct tm tm;
+  gmtime_r(&sec, &tm);
+  strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", &tm);
+  snprintf(buf, bufsz, "%s/%s.%s%03d.%s", dir, name, stamp, (int)(start_ms % 1000), ext);
+}
+
+/**
+ * @brief Updates the period of a rotating log to the one containing a timestamp.
+ * @param log Pointer to the rotating_log.
+ * @param ts_ms Timestamp inside the period.
+ */
+static void rotating_log_set_period(rotating_log *log, int64_t ts_ms)
+{
+  rotation_period_bounds(log->policy, ts_ms, &log->period_start_ms, &log->period_end_ms);
+}
+
+/**
+ * @brief Opens the active segment file and writes the header if it is new.
+ * @param log Pointer to the rotating_log.
+ * @return File descriptor on success, -1 on error.
+ */
+static int rotating_log_open_active(rotating_log *log)
+{
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s.%s", log->dir, log->name, log->ext);
+
+  int fd = open(path, O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  log->bytes_written = 0;
+  if (fstat(fd, &st) == 0)
+    log->bytes_written = st.st_size;
+
+  if (log->bytes_written == 0 && log->header)
+  {
+    size_t header_len = strlen(log->header);
+    if (write(fd, log->header, header_len) < 0)
+      fprintf(stderr, "WARNING: Failed to write header for %s\n", path);
+    else
+      log->bytes_written = (int64_t)header_len;
+
+    if (runtime_config_current()->fsync_per_write)
+      fsync(fd);
+  }
+
+  return fd;
+}
+
+/**
+ * @brief Opens (or reopens) the active segment of a rotating log.
+ * @details The active segment is always `<dir>/<name>.<ext>`. Closed segments left
+ * behind by a previous run are handed to the background compressor.
+ * @param log Pointer to the rotating_log.
+ * @param dir The directory path.
+ * @param name The base file name.
+ * @param ext The file extension.
+ * @param header Header line written to every new segment (NULL for none).
+ * @param policy Rotation policy.
+ * @return 0 on success, -1 on error.
+ */
+int rotating_log_open(rotating_log *log, const char *dir, const char *name, const char *ext,
+                      const char *header, rotate_policy policy)
+{
+  snprintf(log->dir, sizeof(log->dir), "%s", dir);
+  snprintf(log->name, sizeof(log->name), "%s", name);
+  snprintf(log->ext, sizeof(log->ext), "%s", ext);
+  log->header = header;
+  log->policy = policy;
+
+  log->fd = rotating_log_open_active(log);
+  if (log->fd < 0)
+    return -1;
+
+  /* existing data belongs to the period of its last modification */
+  int64_t period_ts_ms = now_ms();
+  struct stat st;
+  size_t header_len = header ? strlen(header) : 0;
+  if (log->bytes_written > (int64_t)header_len && fstat(log->fd, &st) == 0)
+    period_ts_ms = (int64_t)st.st_mtime * 1000;
+  rotating_log_set_period(log, period_ts_ms);
+
+  /* hand over segments that a previous run closed but never compressed */
+  if (LOG_COMPRESS_SEGMENTS)
+  {
+    char pattern[256];
+    glob_t g;
+    snprintf(pattern, sizeof(pattern), "%s/%s.*.%s", dir, name, ext);
+    if (glob(pattern, 0, NULL, &g) == 0)
+    {
+      for (size_t i = 0; i < g.gl_pathc; ++i)
+        segment_compressor_submit(g.gl_pathv[i]);
+      globfree(&g);
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Closes the active segment and hands it to the compressor.
+ * @param log Pointer to the rotating_log.
+ * @param now_ms Current wall-clock time.
+ * @return 0 on success, -1 on error.
+ */
+int rotating_log_rotate(rotating_log *log, int64_t now_ms)
+{
+  size_t header_len = log->header ? strlen(log->header) : 0;
+
+  /* nothing but a header: keep the segment, just start a new period */
+  if (log->bytes_written <= (int64_t)header_len)
+  {
+    rotating_log_set_period(log, now_ms);
+    return 0;
+  }
+
+  /* segment name carries the UTC start of its period */
+  char active_path[256], segment_path[256];
+  snprintf(active_path, sizeof(active_path), "%s/%s.%s", log->dir, log->name, log->ext);
+  rotation_segment_path(log->dir, log->name, log->ext, log->period_start_ms, segment_path, sizeof(segment_path));
+
+  if (rename(active_path, segment_path) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to rotate %s: %s\n", active_path, strerror(errno));
+    rotating_log_set_period(log, now_ms); // retry next period instead of every write
+    return -1;
+  }
+
+  /* open the new segment first so the writer never sees a closed descriptor */
+  int new_fd = rotating_log_open_active(log);
+  if (new_fd < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to open new segment %s: %s\n", active_path, strerror(errno));
+    rotating_log_set_period(log, now_ms); // keep appending to the renamed segment
+    return -1;
+  }
+
+  int old_fd = log->fd;
+  log->fd = new_fd;
+  close(old_fd);
+
+  rotating_log_set_period(log, now_ms);
+
+  if (LOG_COMPRESS_SEGMENTS)
+    segment_compressor_submit(segment_path);
+
+  return 0;
+}
+
+/**
+ * @brief Rotates the log if appending `len` bytes now would cross the policy's limit.
+ * @param log Pointer to the rotating_log.
+ * @param len Number of bytes about to be written.
+ * @param now_ms Current wall-clock time (used by time-based policies).
+ * @return 1 if the next write starts a fresh segment (only its header written), 0 otherwise.
+ */
+int rotating_log_rotate_if_due(rotating_log *log, size_t len, int64_t now_ms)
+{
+  if (now_ms >= log->period_end_ms ||
+      (log->policy == ROTATE_SIZE && log->bytes_written + (int64_t)len > runtime_config_current()->rotate_max_bytes))
+  {
+    rotating_log_rotate(log, now_ms);
+  }
+
+  size_t header_len = log->header ? strlen(log->header) : 0;
+  return log->bytes_written <= (int64_t)header_len;
+}
+
+/**
+ * @brief Appends a buffer to the log, rotating first if the policy requires it.
+ * @details Must only be called from the log's single writer thread: the fd swap is a
+ * plain store on that thread, so no other writer can observe a closed descriptor.
+ * @param log Pointer to the rotating_log.
+ * @param buf Data to write.
+ * @param len Number of bytes to write.
+ * @param now_ms Current wall-clock time (used by time-based policies).
+ * @return Number of bytes written, or -1 on error.
+ */
+ssize_t rotating_log_write(rotating_log *log, const void *buf, size_t len, int64_t now_ms)
+{
+  if (log->fd < 0)
+    return -1;
+
+  rotating_log_rotate_if_due(log, len, now_ms);
+
+  ssize_t result = write(log->fd, buf, len);
+  if (result > 0)
+    log->bytes_written += result;
+
+  return result;
+}
+
+/**
+ * @brief Switches the rotation policy from the next write on.
+ * @details Writer thread only. The active segment keeps its start time, so its name
+ * still covers everything written to it.
+ * @param log Pointer to the rotating_log.
+ * @param policy New policy.
+ * @param now_ms Current wall-clock time.
+ */
+void rotating_log_set_policy(rotating_log *log, rotate_policy policy, int64_t now_ms)
+{
+  if (log->policy == policy)
+    return;
+  int64_t period_start_ms;
+  log->policy = policy;
+  rotation_period_bounds(policy, now_ms, &period_start_ms, &log->period_end_ms);
+}
+
+/**
+ * @brief Syncs and closes the active segment without rotating it.
+ * @param log Pointer to the rotating_log.
+ */
+void rotating_log_close(rotating_log *log)
+{
+  if (log->fd >= 0)
+  {
+    if (fdatasync(log->fd) < 0)
+      fprintf(stderr, "WARNING: Failed to sync %s/%s: %s\n", log->dir, log->name, strerror(errno));
+    close(log->fd);
+    log->fd = -1;
+  }
+}
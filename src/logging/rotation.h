@@ -0,0 +1,97 @@
+/**
+ * @file rotation.h
+ * @brief Rotating append-only log file declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef ROTATION_H
+#define ROTATION_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Computes the [start, end) rotation period containing a timestamp.
+ * @param policy Rotation policy.
+ * @param ts_ms Timestamp inside the period.
+ * @param out_start_ms Pointer to store the period start.
+ * @param out_end_ms Pointer to store the period end (INT64_MAX if not time-based).
+ */
+void rotation_period_bounds(rotate_policy policy, int64_t ts_ms, int64_t *out_start_ms, int64_t *out_end_ms);
+
+/**
+ * @brief Builds the path of a closed segment: `<dir>/<name>.<YYYYmmddTHHMMSSmmm>.<ext>` (UTC).
+ * @param dir The directory path.
+ * @param name The base file name.
+ * @param ext The file extension.
+ * @param start_ms Start time of the segment.
+ * @param buf Output buffer.
+ * @param bufsz Size of buffer.
+ */
+void rotation_segment_path(const char *dir, const char *name, const char *ext, int64_t start_ms,
+                           char *buf, size_t bufsz);
+
+/**
+ * @brief Opens (or reopens) the active segment of a rotating log.
+ * @details The active segment is always `<dir>/<name>.<ext>`. Closed segments left
+ * behind by a previous run are handed to the background compressor.
+ * @param log Pointer to the rotating_log.
+ * @param dir The directory path.
+ * @param name The base file name.
+ * @param ext The file extension.
+ * @param header Header line written to every new segment (NULL for none).
+ * @param policy Rotation policy.
+ * @return 0 on success, -1 on error.
+ */
+int rotating_log_open(rotating_log *log, const char *dir, const char *name, const char *ext,
+                      const char *header, rotate_policy policy);
+
+/**
+ * @brief Rotates the log if appending `len` bytes now would cross the policy's limit.
+ * @details Lets writers of self-contained segments (e.g. delta-encoded records) learn
+ * that the next record opens a new segment before encoding it.
+ * @param log Pointer to the rotating_log.
+ * @param len Number of bytes about to be written.
+ * @param now_ms Current wall-clock time (used by time-based policies).
+ * @return 1 if the next write starts a fresh segment (only its header written), 0 otherwise.
+ */
+int rotating_log_rotate_if_due(rotating_log *log, size_t len, int64_t now_ms);
+
+/**
+ * @brief Appends a buffer to the log, rotating first if the policy requires it.
+ * @details Must only be called from the log's single writer thread: the fd swap is a
+ * plain store on that thread, so no other writer can observe a closed descriptor.
+ * @param log Pointer to the rotating_log.
+ * @param buf Data to write.
+ * @param len Number of bytes to write.
+ * @param now_ms Current wall-clock time (used by time-based policies).
+ * @return Number of bytes written, or -1 on error.
+ */
+ssize_t rotating_log_write(rotating_log *log, const void *buf, size_t len, int64_t now_ms);
+
+/**
+ * @brief Closes the active segment and hands it to the compressor.
+ * @param log Pointer to the rotating_log.
+ * @param now_ms Current wall-clock time.
+ * @return 0 on success, -1 on error.
+ */
+int rotating_log_rotate(rotating_log *log, int64_t now_ms);
+
+/**
+ * @brief Switches the rotation policy from the next write on.
+ * @details Writer thread only. The active segment keeps its start time, so its name
+ * still covers everything written to it.
+ * @param log Pointer to the rotating_log.
+ * @param policy New policy.
+ * @param now_ms Current wall-clock time.
+ */
+void rotating_log_set_policy(rotating_log *log, rotate_policy policy, int64_t now_ms);
+
+/**
+ * @brief Syncs and closes the active segment without rotating it.
+ * @param log Pointer to the rotating_log.
+ */
+void rotating_log_close(rotating_log *log);
+
+#endif /* ROTATION_H */
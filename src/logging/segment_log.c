@@ -0,0 +1,596 @@
+/**
+ * @file segment_log.c
+ * @brief Memory-mapped append-only segment log implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "segment_log.h"
+#include "trade_index.h"
+#include "rotation.h"
+#include "compressor.h"
+#include "../utils/time_utils.h"
+#include "../utils/mem_budget.h"
+#include "../utils/runtime_config.h"
+
+#include <glob.h>
+#include <sys/mman.h>
+
+/* Sync thread state */
+static pthread_t sync_thread;
+static int sync_running;
+static int sync_stop_requested;
+static pthread_mutex_t sync_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sync_cond = PTHREAD_COND_INITIALIZER;
+
+/**
+ * @brief Rounds an offset down to the start of its page.
+ * @param off Byte offset.
+ * @return Page-aligned offset.
+ */
+static size_t page_floor(size_t off)
+{
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  return off - (off % page);
+}
+
+/**
+ * @brief Creates and maps a new preallocated segment file.
+ * @param log Pointer to the segment_log (naming fields only).
+ * @param now_ms Creation time, used in the segment name.
+ * @param out_fd Pointer to store the file descriptor.
+ * @param out_map Pointer to store the mapping.
+ * @param out_path Buffer (256 bytes) to store the segment path.
+ * @return 0 on success, -1 on error.
+ */
+static int segment_create(const segment_log *log, int64_t now_ms, int *out_fd, char **out_map, char *out_path)
+{
+  int fd = -1;
+
+  /* stamps are unique per millisecond; step forward on a collision */
+  for (int64_t ts_ms = now_ms; fd < 0; ++ts_ms)
+  {
+    rotation_segment_path(log->dir, log->name, log->ext, ts_ms, out_path, 256);
+    fd = open(out_path, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0 && errno != EEXIST)
+      return -1;
+  }
+
+  /* reserve the blocks up front so page faults in the mapping never hit ENOSPC */
+  if (fallocate(fd, 0, 0, TRADE_SEGMENT_BYTES) < 0 && ftruncate(fd, TRADE_SEGMENT_BYTES) < 0)
+  {
+    close(fd);
+    unlink(out_path);
+    return -1;
+  }
+
+  char *map = mmap(NULL, TRADE_SEGMENT_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+  {
+    close(fd);
+    unlink(out_path);
+    return -1;
+  }
+  mem_budget_add(MEM_WRITERS, TRADE_SEGMENT_BYTES);
+
+  *out_fd = fd;
+  *out_map = map;
+  return 0;
+}
+
+/**
+ * @brief Opens the minute index that accompanies a segment.
+ * @param segment_path Segment path.
+ * @return File descriptor on success, -1 on error.
+ */
+static int segment_index_open(const char *segment_path)
+{
+  char index_path[272];
+  snprintf(index_path, sizeof(index_path), "%s%s", segment_path, TRADE_INDEX_SUFFIX);
+
+  int fd = open(index_path, O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0)
+    fprintf(stderr, "WARNING: Failed to open trade index %s: %s\n", index_path, strerror(errno));
+
+  return fd;
+}
+
+/**
+ * @brief Flushes, unmaps and truncates a segment to its used size, then hands it to the compressor.
+ * @param fd Segment file descriptor.
+ * @param map Segment mapping (may be NULL).
+ * @param used Bytes written into the segment.
+ * @param path Segment path.
+ */
+static void segment_finalize(int fd, char *map, size_t used, const char *path)
+{
+  if (map)
+  {
+    if (used > 0 && msync(map, used, MS_SYNC) < 0)
+      fprintf(stderr, "WARNING: Failed to sync segment %s: %s\n", path, strerror(errno));
+    munmap(map, TRADE_SEGMENT_BYTES);
+    mem_budget_add(MEM_WRITERS, -TRADE_SEGMENT_BYTES);
+  }
+
+  if (ftruncate(fd, (off_t)used) < 0)
+    fprintf(stderr, "WARNING: Failed to truncate segment %s: %s\n", path, strerror(errno));
+  else if (used > 0 && fdatasync(fd) < 0) // the new size reaches the disk with the data
+    fprintf(stderr, "WARNING: Failed to sync segment %s: %s\n", path, strerror(errno));
+  close(fd);
+
+  if (used == 0)
+  {
+    char index_path[272];
+    snprintf(index_path, sizeof(index_path), "%s%s", path, TRADE_INDEX_SUFFIX);
+    unlink(path);
+    unlink(index_path);
+  }
+  else if (LOG_COMPRESS_SEGMENTS)
+    segment_compressor_submit(path);
+}
+
+/**
+ * @brief Cuts the zero-filled preallocated tail off a segment left by an unclean exit.
+ * @param path Segment path.
+ * @return Size of the segment after trimming, or -1 on error.
+ */
+static off_t segment_trim(const char *path)
+{
+  int fd = open(path, O_RDWR | O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) < 0)
+  {
+    close(fd);
+    return -1;
+  }
+
+  /* scan backwards for the last non-zero byte */
+  char buf[4096];
+  off_t end = st.st_size;
+  while (end > 0)
+  {
+    off_t start = end > (off_t)sizeof(buf) ? end - (off_t)sizeof(buf) : 0;
+    ssize_t n = pread(fd, buf, (size_t)(end - start), start);
+    if (n <= 0)
+      break;
+
+    ssize_t i = n - 1;
+    while (i >= 0 && buf[i] == '\0')
+      --i;
+
+    if (i >= 0)
+    {
+      end = start + i + 1;
+      break;
+    }
+    end = start;
+  }
+
+  if (end < st.st_size && ftruncate(fd, end) < 0)
+    fprintf(stderr, "WARNING: Failed to trim segment %s: %s\n", path, strerror(errno));
+
+  close(fd);
+  return end;
+}
+
+/**
+ * @brief Prepares an unopened segment log (once per log, before the sync thread starts).
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_init(segment_log *log)
+{
+  log->fd = log->index_fd = -1;
+  log->map = NULL;
+  log->used = log->synced = 0;
+  log->num_retired = 0;
+  log->flushing = NULL;
+  log->writer_finalized = 0;
+  pthread_mutex_init(&log->lock, NULL);
+}
+
+/**
+ * @brief Moves the active segment to the retired queue for the sync thread to finalize.
+ * @details Called with `log->lock` held; never waits for the sync thread. If
+ * TRADE_SEGMENT_RETIRED_MAX segments are still waiting (the sync thread fell that far
+ * behind), the oldest one whose mapping the sync thread is not flushing leaves the queue
+ * for the caller to finalize once it has released the lock.
+ * @param log Pointer to the segment_log.
+ * @param overflow Pointer to store the segment the caller must finalize.
+ * @return 1 if `overflow` was filled, 0 otherwise.
+ */
+static int segment_log_hand_over(segment_log *log, segment_retiree *overflow)
+{
+  int taken = 0;
+  if (log->num_retired == TRADE_SEGMENT_RETIRED_MAX)
+  {
+    int victim = log->retired[0].map == log->flushing ? 1 : 0; // at most one mapping is in flight
+    *overflow = log->retired[victim];
+    memmove(&log->retired[victim], &log->retired[victim + 1],
+            (size_t)(log->num_retired - victim - 1) * sizeof(segment_retiree));
+    log->num_retired--;
+    log->writer_finalized++;
+    taken = 1;
+  }
+
+  segment_retiree *r = &log->retired[log->num_retired++];
+  r->fd = log->fd;
+  r->map = log->map;
+  r->used = log->used;
+  memcpy(r->path, log->path, sizeof(r->path));
+  return taken;
+}
+
+/**
+ * @brief Finalizes a retired segment on the writer thread (the sync thread is behind).
+ * @param log Pointer to the segment_log.
+ * @param r The segment taken from the retired queue.
+ */
+static void segment_log_finalize_overflow(segment_log *log, const segment_retiree *r)
+{
+  fprintf(stderr, "WARNING: Trade log %s: sync thread %d segments behind, finalizing %s on the writer (%" PRIu64 " so far)\n",
+          log->name, TRADE_SEGMENT_RETIRED_MAX, r->path, log->writer_finalized);
+  segment_finalize(r->fd, r->map, r->used, r->path);
+}
+
+/**
+ * @brief Opens a segment log and maps a fresh preallocated segment.
+ * @details Segments are named `<dir>/<name>.<YYYYmmddTHHMMSSmmm>.<ext>`, each with a
+ * `<segment>.idx` minute index (see trade_index.h). Segments left
+ * by a previous run are trimmed of their unused preallocated tail and handed to
+ * the compressor.
+ * @param log Pointer to the segment_log.
+ * @param dir The directory path.
+ * @param name The base file name.
+ * @param ext The file extension.
+ * @param policy Time-based roll-over policy (segments also roll over when full).
+ * @return 0 on success, -1 on error.
+ */
+int segment_log_open(segment_log *log, const char *dir, const char *name, const char *ext, rotate_policy policy)
+{
+  snprintf(log->dir, sizeof(log->dir), "%s", dir);
+  snprintf(log->name, sizeof(log->name), "%s", name);
+  snprintf(log->ext, sizeof(log->ext), "%s", ext);
+  log->policy = policy;
+  log->index_fd = -1;
+  log->last_index_minute_ms = INT64_MIN;
+  log->capacity = TRADE_SEGMENT_BYTES;
+
+  char path[256];
+  struct stat st;
+
+  /* a plain <name>.<ext> file from the write(2)-based logger becomes a closed segment */
+  snprintf(path, sizeof(path), "%s/%s.%s", dir, name, ext);
+  if (stat(path, &st) == 0)
+  {
+    char legacy_path[256];
+    rotation_segment_path(dir, name, ext, (int64_t)st.st_mtime * 1000, legacy_path, sizeof(legacy_path));
+    if (st.st_size == 0 || rename(path, legacy_path) < 0)
+      unlink(path);
+  }
+
+  /* recover segments a previous run did not finalize */
+  char pattern[256];
+  glob_t g;
+  snprintf(pattern, sizeof(pattern), "%s/%s.*.%s", dir, name, ext);
+  if (glob(pattern, 0, NULL, &g) == 0)
+  {
+    for (size_t i = 0; i < g.gl_pathc; ++i)
+    {
+      off_t size = segment_trim(g.gl_pathv[i]);
+      if (size == 0)
+        unlink(g.gl_pathv[i]);
+      else if (size > 0 && LOG_COMPRESS_SEGMENTS)
+        segment_compressor_submit(g.gl_pathv[i]);
+    }
+    globfree(&g);
+  }
+
+  int64_t now = now_ms();
+  int64_t period_start_ms;
+  int fd;
+  char *map;
+  if (segment_create(log, now, &fd, &map, path) < 0)
+    return -1;
+
+  /* the sync thread may already be running (a symbol added at runtime) */
+  pthread_mutex_lock(&log->lock);
+  log->fd = fd;
+  log->map = map;
+  memcpy(log->path, path, sizeof(log->path));
+  __atomic_store_n(&log->used, 0, __ATOMIC_RELEASE);
+  log->synced = 0;
+  pthread_mutex_unlock(&log->lock);
+
+  log->index_fd = segment_index_open(log->path);
+  rotation_period_bounds(policy, now, &period_start_ms, &log->period_end_ms);
+
+  return 0;
+}
+
+/**
+ * @brief Replaces the active segment with a new one and retires the old one to the sync thread.
+ * @details The writer normally leaves the old segment's msync and unmap to the sync thread;
+ * it only finalizes a segment itself when the retired queue is full, and never waits.
+ * @param log Pointer to the segment_log.
+ * @param now_ms Current wall-clock time.
+ * @return 0 on success, -1 on error.
+ */
+static int segment_log_roll(segment_log *log, int64_t now_ms)
+{
+  int new_fd;
+  char *new_map;
+  char new_path[256];
+  int64_t period_start_ms;
+
+  if (segment_create(log, now_ms, &new_fd, &new_map, new_path) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to create trade log segment for %s: %s\n", log->name, strerror(errno));
+    rotation_period_bounds(log->policy, now_ms, &period_start_ms, &log->period_end_ms);
+    return -1;
+  }
+
+  segment_retiree overflow;
+  pthread_mutex_lock(&log->lock);
+
+  int overflowed = segment_log_hand_over(log, &overflow);
+  log->fd = new_fd;
+  log->map = new_map;
+  memcpy(log->path, new_path, sizeof(log->path));
+  __atomic_store_n(&log->used, 0, __ATOMIC_RELEASE);
+  log->synced = 0;
+
+  pthread_mutex_unlock(&log->lock);
+
+  if (overflowed)
+    segment_log_finalize_overflow(log, &overflow);
+
+  /* the index is only ever written by this thread, so it is swapped here directly */
+  if (log->index_fd >= 0)
+    close(log->index_fd);
+  log->index_fd = segment_index_open(new_path);
+  log->last_index_minute_ms = INT64_MIN;
+
+  rotation_period_bounds(log->policy, now_ms, &period_start_ms, &log->period_end_ms);
+  return 0;
+}
+
+/**
+ * @brief Copies a line (plus a trailing newline) into the active segment.
+ * @details Writer thread only. No system call is made unless the segment rolls over
+ * or the record opens a new minute in the segment's index.
+ * @param log Pointer to the segment_log.
+ * @param line Line contents (without newline).
+ * @param len Length of the line.
+ * @param record_ts_ms Timestamp of the record (drives the minute index).
+ * @param now_ms Current wall-clock time (used by the roll-over policy).
+ * @return 0 on success, -1 on error.
+ */
+int segment_log_append_line(segment_log *log, const char *line, size_t len, int64_t record_ts_ms, int64_t now_ms)
+{
+  if (!log->map)
+    return -1;
+
+  size_t used = log->used; // only this thread stores to it
+  if (used + len + 1 > log->capacity || (now_ms >= log->period_end_ms && used > 0))
+  {
+    if (segment_log_roll(log, now_ms) < 0 && used + len + 1 > log->capacity)
+      return -1;
+    used = log->used;
+  }
+
+  /* first record of a new minute: remember where it starts */
+  int64_t record_minute_ms = (record_ts_ms / MS_PER_MINUTE) * MS_PER_MINUTE;
+  if (record_minute_ms > log->last_index_minute_ms && log->index_fd >= 0)
+  {
+    trade_index_entry entry = {.minute_ts_ms = record_minute_ms, .offset = used};
+    if (write(log->index_fd, &entry, sizeof(entry)) == (ssize_t)sizeof(entry))
+      log->last_index_minute_ms = record_minute_ms;
+  }
+
+  memcpy(log->map + used, line, len);
+  log->map[used + len] = '\n';
+
+  /* publish after the copy so the sync thread never flushes a partial record */
+  __atomic_store_n(&log->used, used + len + 1, __ATOMIC_RELEASE);
+
+  if (runtime_config_current()->fsync_per_write)
+  {
+    size_t start = page_floor(used);
+    msync(log->map + start, used + len + 1 - start, MS_SYNC);
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Switches the time-based roll-over policy from the next append on.
+ * @details Writer thread only.
+ * @param log Pointer to the segment_log.
+ * @param policy New policy.
+ * @param now_ms Current wall-clock time.
+ */
+void segment_log_set_policy(segment_log *log, rotate_policy policy, int64_t now_ms)
+{
+  if (log->policy == policy)
+    return;
+  int64_t period_start_ms;
+  log->policy = policy;
+  rotation_period_bounds(policy, now_ms, &period_start_ms, &log->period_end_ms);
+}
+
+/**
+ * @brief Retires the active segment to the sync thread and leaves the log closed.
+ * @details For a log whose writer has stopped using it while the sync thread keeps
+ * running (a symbol removed at runtime); the log can be opened again later.
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_retire(segment_log *log)
+{
+  if (log->fd < 0)
+    return;
+
+  segment_retiree overflow;
+  pthread_mutex_lock(&log->lock);
+
+  int overflowed = segment_log_hand_over(log, &overflow);
+  log->fd = -1;
+  log->map = NULL;
+  __atomic_store_n(&log->used, 0, __ATOMIC_RELEASE);
+  log->synced = 0;
+
+  pthread_mutex_unlock(&log->lock);
+
+  if (overflowed)
+    segment_log_finalize_overflow(log, &overflow);
+
+  if (log->index_fd >= 0)
+    close(log->index_fd);
+  log->index_fd = -1;
+}
+
+/**
+ * @brief Flushes the published range of the active segment and finalizes the retired ones.
+ * @details Called periodically by the sync thread. The mapping it flushes is marked in
+ * `flushing` so that a writer finding the retired queue full leaves it alone.
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_sync(segment_log *log)
+{
+  pthread_mutex_lock(&log->lock);
+
+  char *map = log->map;
+  size_t used = __atomic_load_n(&log->used, __ATOMIC_ACQUIRE);
+  size_t synced = log->synced;
+
+  segment_retiree retired[TRADE_SEGMENT_RETIRED_MAX];
+  int num_retired = log->num_retired;
+  memcpy(retired, log->retired, (size_t)num_retired * sizeof(segment_retiree));
+  log->num_retired = 0;
+  int flush = map && used > synced;
+  log->flushing = flush ? map : NULL;
+
+  pthread_mutex_unlock(&log->lock);
+
+  /* the mapping stays valid even if the writer rolls over meanwhile: it then waits in the
+   * retired queue, where the writer skips it while `flushing` names it */
+  if (flush)
+  {
+    size_t start = page_floor(synced);
+    int flushed = msync(map + start, used - start, MS_SYNC) == 0;
+
+    /* clean pages below the writer's page are dropped to keep RSS flat */
+    size_t drop_end = page_floor(used);
+    if (flushed && drop_end > start)
+      madvise(map + start, drop_end - start, MADV_DONTNEED);
+
+    pthread_mutex_lock(&log->lock);
+    log->flushing = NULL;
+    if (flushed && log->map == map) // not rolled over meanwhile
+      log->synced = used;
+    pthread_mutex_unlock(&log->lock);
+  }
+
+  for (int i = 0; i < num_retired; ++i)
+    segment_finalize(retired[i].fd, retired[i].map, retired[i].used, retired[i].path);
+}
+
+/**
+ * @brief Finalizes the active segment (truncates it to its used size) and closes the log.
+ * @details Must only be called once the writer and sync threads have stopped; undoes
+ * segment_log_init.
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_close(segment_log *log)
+{
+  if (log->index_fd >= 0)
+  {
+    fdatasync(log->index_fd);
+    close(log->index_fd);
+    log->index_fd = -1;
+  }
+
+  for (int i = 0; i < log->num_retired; ++i)
+    segment_finalize(log->retired[i].fd, log->retired[i].map, log->retired[i].used, log->retired[i].path);
+  log->num_retired = 0;
+
+  if (log->fd >= 0)
+  {
+    segment_finalize(log->fd, log->map, log->used, log->path);
+    log->fd = -1;
+    log->map = NULL;
+  }
+  pthread_mutex_destroy(&log->lock);
+}
+
+/**
+ * @brief Sync thread: flushes every trade log segment each TRADE_SEGMENT_SYNC_MS.
+ * @param arg Thread argument (unused).
+ * @return NULL.
+ */
+static void *segment_log_sync_thread_fn(void *arg)
+{
+  (void)arg;
+
+  pthread_mutex_lock(&sync_lock);
+  while (!sync_stop_requested)
+  {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += TRADE_SEGMENT_SYNC_MS / 1000;
+    deadline.tv_nsec += (TRADE_SEGMENT_SYNC_MS % 1000) * NS_PER_MS;
+    if (deadline.tv_nsec >= NS_PER_SEC)
+    {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= NS_PER_SEC;
+    }
+    pthread_cond_timedwait(&sync_cond, &sync_lock, &deadline);
+    pthread_mutex_unlock(&sync_lock);
+
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+      segment_log_sync(&symbols[i].trade_log);
+
+    pthread_mutex_lock(&sync_lock);
+  }
+  pthread_mutex_unlock(&sync_lock);
+
+  return NULL;
+}
+
+/**
+ * @brief Starts the background thread that periodically msyncs all trade log segments.
+ * @return 0 on success, -1 on error.
+ */
+int segment_log_sync_start(void)
+{
+  sync_stop_requested = 0;
+
+  if (pthread_create(&sync_thread, NULL, segment_log_sync_thread_fn, NULL) != 0)
+  {
+    fprintf(stderr, "ERROR: Failed to create segment sync thread: %s\n", strerror(errno));
+    return -1;
+  }
+
+  sync_running = 1;
+  return 0;
+}
+
+/**
+ * @brief Stops the sync thread after a final flush.
+ */
+void segment_log_sync_stop(void)
+{
+  if (!sync_running)
+    return;
+
+  pthread_mutex_lock(&sync_lock);
+  sync_stop_requested = 1;
+  pthread_cond_signal(&sync_cond);
+  pthread_mutex_unlock(&sync_lock);
+
+  pthread_join(sync_thread, NULL); // the wake-up runs one last sync pass
+  sync_running = 0;
+}
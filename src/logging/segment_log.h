@@ -0,0 +1,93 @@
+/**
+ * @file segment_log.h
+ * @brief Memory-mapped append-only segment log declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef SEGMENT_LOG_H
+#define SEGMENT_LOG_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Prepares an unopened segment log (once per log, before the sync thread starts).
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_init(segment_log *log);
+
+/**
+ * @brief Opens a segment log and maps a fresh preallocated segment.
+ * @details Segments are named `<dir>/<name>.<YYYYmmddTHHMMSSmmm>.<ext>`, each with a
+ * `<segment>.idx` minute index (see trade_index.h). Segments left
+ * by a previous run are trimmed of their unused preallocated tail and handed to
+ * the compressor.
+ * @param log Pointer to the segment_log.
+ * @param dir The directory path.
+ * @param name The base file name.
+ * @param ext The file extension.
+ * @param policy Time-based roll-over policy (segments also roll over when full).
+ * @return 0 on success, -1 on error.
+ */
+int segment_log_open(segment_log *log, const char *dir, const char *name, const char *ext, rotate_policy policy);
+
+/**
+ * @brief Copies a line (plus a trailing newline) into the active segment.
+ * @details Writer thread only. No system call is made unless the segment rolls over
+ * or the record opens a new minute in the segment's index.
+ * @param log Pointer to the segment_log.
+ * @param line Line contents (without newline).
+ * @param len Length of the line.
+ * @param record_ts_ms Timestamp of the record (drives the minute index).
+ * @param now_ms Current wall-clock time (used by the roll-over policy).
+ * @return 0 on success, -1 on error.
+ */
+int segment_log_append_line(segment_log *log, const char *line, size_t len, int64_t record_ts_ms, int64_t now_ms);
+
+/**
+ * @brief Switches the time-based roll-over policy from the next append on.
+ * @details Writer thread only.
+ * @param log Pointer to the segment_log.
+ * @param policy New policy.
+ * @param now_ms Current wall-clock time.
+ */
+void segment_log_set_policy(segment_log *log, rotate_policy policy, int64_t now_ms);
+
+/**
+ * @brief Retires the active segment to the sync thread and leaves the log closed.
+ * @details For a log whose writer has stopped using it while the sync thread keeps
+ * running (a symbol removed at runtime); the log can be opened again later.
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_retire(segment_log *log);
+
+/**
+ * @brief Flushes the published range of the active segment and finalizes the retired ones.
+ * @details Called periodically by the sync thread. A writer that finds TRADE_SEGMENT_RETIRED_MAX
+ * segments still retired finalizes the oldest one not being flushed itself, so it never
+ * waits for this thread.
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_sync(segment_log *log);
+
+/**
+ * @brief Finalizes the active segment (truncates it to its used size) and closes the log.
+ * @details Must only be called once the writer and sync threads have stopped; undoes
+ * segment_log_init.
+ * @param log Pointer to the segment_log.
+ */
+void segment_log_close(segment_log *log);
+
+/**
+ * @brief Starts the background thread that periodically msyncs all trade log segments.
+ * @return 0 on success, -1 on error.
+ */
+int segment_log_sync_start(void);
+
+/**
+ * @brief Stops the sync thread after a final flush.
+ */
+void segment_log_sync_stop(void);
+
+#endif /* SEGMENT_LOG_H */
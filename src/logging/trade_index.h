@@ -0,0 +1,29 @@
+/**
+ * @file trade_index.h
+ * @brief On-disk format of the minute index written alongside each trade log segment
+ *
+ * Kept free of libwebsockets/common.h so offline tools can include it.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef TRADE_INDEX_H
+#define TRADE_INDEX_H
+
+#include <stdint.h>
+
+/** Suffix appended to a segment's uncompressed path to name its index. */
+#define TRADE_INDEX_SUFFIX ".idx"
+
+/**
+ * @brief One index entry: the first record of a minute and where it starts in the segment.
+ * @details Entries are appended in increasing minute order, one per minute that has trades.
+ */
+typedef struct
+{
+  int64_t minute_ts_ms; /**< exchange minute (aligned to minute) */
+  uint64_t offset;      /**< byte offset of the minute's first record in the uncompressed segment */
+} trade_index_entry;
+
+#endif /* TRADE_INDEX_H */
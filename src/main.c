@@ -16,7 +16,11 @@
  * - Per-minute calculation of cross-asset Pearson correlations with lag analysis.
  * - Precise, drift-compensating scheduling using `clock_nanosleep`.
  * - Comprehensive logging of raw trades, computed metrics, and system performance.
- * - Graceful shutdown on SIGINT/SIGTERM.
+ * - Graceful shutdown on SIGINT/SIGTERM within a time budget: ingestion stops, queued
+ *   trades are drained, outputs are synced and a checkpoint records where they end.
+ * - Optional split into an ingest process and an analytics process (`--role`) connected
+ *   by a shared-memory trade ring, so analytics can be restarted without dropping the feed.
+ * - Symbols and logging policies reloaded from the config file on SIGHUP, without a restart.
 *
  * @author Fraidakis Ioannis
  * @date September 2025
@@ -26,79 +30,279 @@
 #include "config.h"
 #include "data/queue.h"
 #include "data/sliding_window.h"
-#include "data/vwap_history.h"
+#include "data/chunk_pool.h"
+#include "data/quantiles.h"
+#include "data/vwap_matrix.h"
+#include "data/bar_builder.h"
+#include "data/shm_channel.h"
 #include "utils/time_utils.h"
+#include "utils/runtime_config.h"
+#include "utils/mem_budget.h"
+#include "utils/alloc_audit.h"
 #include "logging/logger.h"
+#include "logging/rotation.h"
+#include "logging/compressor.h"
+#include "logging/segment_log.h"
 #include "network/websocket.h"
 #include "network/okx_parser.h"
+#include "network/replay.h"
 #include "compute/vwap_calculator.h"
+#include "compute/volatility.h"
+#include "compute/alert_engine.h"
 #include "compute/correlation.h"
 #include "scheduler/scheduler.h"
 
+#include <getopt.h>
+#include <poll.h>
+#include <sys/signalfd.h>
+
 /* ============================================================================
  * GLOBAL VARIABLE DEFINITIONS
  * ============================================================================ */
 
 /* Array of consolidated symbol data */
 symbol_data symbols[NUM_SYMBOLS];
+vwap_matrix vwap_hist;
+
+/* Trade storage and quantile nodes of every symbol's window (analytics side) */
+static chunk_pool window_pool;
+static chunk_pool window_node_pool;
 
 /* Global trade queue and file descriptors */
 raw_trade_queue raw_queue;
-int latency_log_fd = -1;
+rotating_log latency_log = {.fd = -1};
+
+/* Shared-memory channel between the ingest and analytics processes */
+static shm_channel channel;
+shm_channel *trade_channel;
 
 /* Worker thread synchronization */
 pthread_t vwap_worker_thread;
 pthread_t correlation_worker_thread;
 pthread_barrier_t compute_start_barrier; // To start workers together
 pthread_barrier_t compute_done_barrier;  // To wait for workers to finish
+pthread_mutex_t compute_lock = PTHREAD_MUTEX_INITIALIZER;
 int64_t current_minute_ms;
+double minute_metrics[NUM_SYMBOLS][NUM_ALERT_METRICS];
+
+/**
+ * @brief Which part of the pipeline this process runs.
+ */
+typedef enum
+{
+  ROLE_ALL = 0,   /**< everything in one process (default) */
+  ROLE_INGEST,    /**< feed, trade logs and latency log; forwards parsed trades to shared memory */
+  ROLE_ANALYTICS  /**< windows, per-minute workers, metrics and alerts fed from shared memory */
+} process_role;
+
+static process_role role = ROLE_ALL;
+static int lossless_feed; /**< replay input: wait for ring space instead of dropping trades */
+
+/* Configuration reload (SIGHUP) */
+static const char *config_path = CONFIG_PATH;
+
+/* SIGINT, SIGTERM and SIGHUP are blocked in every thread and read by the main thread here */
+static int signal_fd = -1;
+static int feed_detached; /**< the feed thread missed the shutdown budget and may still push */
+
+static int wait_signal(int timeout_ms);
+static void reload_config(void);
 
 /* ============================================================================
  * INITIALIZATION AND CLEANUP
  * ============================================================================ */
 
+/**
+ * @brief Allocates the windows of one symbol slot (analytics side).
+ * @param i Slot index.
+ */
+static void symbol_windows_init(int i)
+{
+  sliding_window_init(&symbols[i].trade_window, &window_pool, &window_node_pool);
+  bar_builder_init(&symbols[i].bars, BAR_HISTORY_SIZE_MINUTES);
+  volatility_init(&symbols[i].vol);
+}
+
+/**
+ * @brief Frees the windows of one symbol slot (analytics side).
+ * @param i Slot index.
+ */
+static void symbol_windows_cleanup(int i)
+{
+  sliding_window_cleanup(&symbols[i].trade_window);
+  bar_builder_cleanup(&symbols[i].bars);
+}
+
 /**
  * @brief Cleans up all program resources.
+ * @details Every log is synced before it is closed; the checkpoint is written last, once
+ * the outputs it describes are on disk.
+ * @param deadline_ns Monotonic time by which compression must stop (0 = compress everything).
+ * @param report Shutdown outcome to checkpoint, or NULL.
  */
-static void cleanup_resources(void)
+static void cleanup_resources(int64_t deadline_ns, shutdown_report *report)
 {
-  /* cleanup all symbol data structures */
-  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  if (role != ROLE_ANALYTICS)
   {
-    if (symbols[i].trade_log_fd >= 0)
-    {
-      close(symbols[i].trade_log_fd);
-      symbols[i].trade_log_fd = -1;
-    }
-    sliding_window_cleanup(&symbols[i].trade_window);
-    vwap_history_cleanup(&symbols[i].vwap_hist);
+    segment_log_sync_stop(); // final msync of the mapped trade segments
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+      segment_log_close(&symbols[i].trade_log);
+    rotating_log_close(&latency_log);
+    segment_compressor_stop(deadline_ns); // compress queued segments while the budget lasts
+    if (!feed_detached)
+      trade_queue_cleanup(&raw_queue); // cleanup raw trade queue resources
   }
 
-  if (latency_log_fd >= 0)
-    close(latency_log_fd);
+  if (role != ROLE_INGEST)
+  {
+    /* cleanup all symbol data structures */
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+      if (symbols[i].symbol[0])
+        symbol_windows_cleanup(i);
+    if (window_pool.base)
+      mem_budget_add(MEM_WINDOWS, -(int64_t)WINDOW_POOL_BYTES);
+    if (window_node_pool.base)
+      mem_budget_add(MEM_WINDOWS, -(int64_t)(WINDOW_QUANTILE_NODES * sizeof(quantile_node)));
+    chunk_pool_cleanup(&window_pool); // after the windows have returned their chunks
+    chunk_pool_cleanup(&window_node_pool);
+    correlation_cleanup();
+    vwap_matrix_cleanup(&vwap_hist);
+    alert_engine_cleanup();
+  }
+
+  if (trade_channel)
+  {
+    if (role == ROLE_INGEST && shm_channel_dropped(trade_channel) > 0)
+      fprintf(stderr, "WARNING: %" PRIu64 " trades were dropped on a full shared-memory ring\n",
+              shm_channel_dropped(trade_channel));
+    mem_budget_add(MEM_IPC, -(int64_t)trade_channel->map_bytes);
+    shm_channel_close(trade_channel); // the ingest process also removes it
+    trade_channel = NULL;
+  }
 
-  trade_queue_cleanup(&raw_queue); // cleanup raw trade queue resources
+  if (report)
+  {
+    report->finished_ms = now_ms();
+    if (write_checkpoint(report) == 0)
+      printf("INFO: Checkpoint written to %s-%s.json\n", CHECKPOINT_PREFIX, report->role);
+  }
+  runtime_config_cleanup();
   printf("INFO: Resource cleanup complete\n");
 }
 
 /**
- * @brief Initialize all symbol data structures.
+ * @brief Initialize all symbol data structures from the published configuration.
  */
 static void symbols_data_init(void)
 {  
+  const runtime_config *cfg = runtime_config_current();
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    memcpy(symbols[i].symbol, cfg->symbols[i], SYMBOL_NAME_MAX);
+    segment_log_init(&symbols[i].trade_log); // every slot: a reload may open it later
+  }
+  if (role == ROLE_INGEST)
+    return; // the windows live in the analytics process
+
+  if (chunk_pool_init(&window_pool, WINDOW_POOL_CHUNKS, WINDOW_CHUNK_TRADES * sizeof(processed_trade)) != 0)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate the window chunk pool (%d chunks)\n", WINDOW_POOL_CHUNKS);
+    exit(1);
+  }
+  mem_budget_add(MEM_WINDOWS, (int64_t)WINDOW_POOL_BYTES);
+  if (WINDOW_QUANTILE_MODE == QUANTILE_EXACT)
+  {
+    if (chunk_pool_init(&window_node_pool, WINDOW_QUANTILE_NODES, sizeof(quantile_node)) != 0)
+    {
+      fprintf(stderr, "ERROR: Failed to allocate the window quantile node pool (%u nodes)\n", WINDOW_QUANTILE_NODES);
+      exit(1);
+    }
+    mem_budget_add(MEM_WINDOWS, (int64_t)(WINDOW_QUANTILE_NODES * sizeof(quantile_node)));
+  }
   for (int i = 0; i < NUM_SYMBOLS; ++i)
+    if (symbols[i].symbol[0])
+      symbol_windows_init(i);
+  vwap_matrix_init(&vwap_hist, VWAP_HISTORY_SIZE_MINUTES, NUM_SYMBOLS); // one row per minute, all symbols
+}
+
+/**
+ * @brief Attaches the analytics process to the ingest process's channel, waiting for it to appear.
+ * @details Reloads the VWAP history published by a previous analytics process, so the
+ * correlation search resumes at once; the sliding windows refill from live trades. Columns
+ * are matched by symbol name, since the previous process may have had other slots.
+ * @return 0 on success, -1 on shutdown or layout mismatch.
+ */
+static int analytics_attach(void)
+{
+  int waiting_logged = 0;
+  while (!__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
+  {
+    int rc = shm_channel_attach(&channel, SHM_CHANNEL_NAME, SHM_TRADE_RING_SIZE, VWAP_HISTORY_SIZE_MINUTES,
+                                NUM_SYMBOLS);
+    if (rc == 0)
+      break;
+    if (rc == -2)
+    {
+      fprintf(stderr, "ERROR: Shared memory %s was created by an incompatible build\n", SHM_CHANNEL_NAME);
+      return -1;
+    }
+    if (!waiting_logged)
+      printf("INFO: Waiting for the ingest process (%s)...\n", SHM_CHANNEL_NAME);
+    waiting_logged = 1;
+
+    int sig = wait_signal(SHM_ATTACH_RETRY_MS);
+    if (sig == SIGHUP)
+      reload_config();
+    else if (sig != 0)
+      __atomic_store_n(&shutdown_requested, 1, __ATOMIC_RELEASE); // nothing to drain yet
+  }
+  if (__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
+    return -1;
+  trade_channel = &channel;
+  mem_budget_add(MEM_IPC, (int64_t)channel.map_bytes);
+
+  static int64_t ts[VWAP_HISTORY_SIZE_MINUTES];
+  static double rows[VWAP_HISTORY_SIZE_MINUTES][NUM_SYMBOLS];
+  static char names[NUM_SYMBOLS][SHM_SYMBOL_MAX];
+  int n = shm_channel_read_vwap(trade_channel, VWAP_HISTORY_SIZE_MINUTES, ts, &rows[0][0], &names[0][0]);
+  if (n < 0)
+    fprintf(stderr, "WARNING: VWAP snapshot is being rewritten, starting with an empty history\n");
+
+  int slot_of[NUM_SYMBOLS];
+  for (int c = 0; c < NUM_SYMBOLS; ++c)
+    slot_of[c] = names[c][0] ? runtime_config_symbol_index(runtime_config_current(), names[c]) : -1;
+  for (int r = 0; r < n; ++r)
   {
-    symbols[i].symbol = SYMBOLS[i];
-    symbols[i].trade_log_fd = -1;
-    sliding_window_init(&symbols[i].trade_window);
-    vwap_history_init(&symbols[i].vwap_hist, VWAP_HISTORY_SIZE_MINUTES);
+    double row[NUM_SYMBOLS];
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+      row[i] = NAN;
+    for (int c = 0; c < NUM_SYMBOLS; ++c)
+      if (slot_of[c] >= 0)
+        row[slot_of[c]] = rows[r][c];
+    vwap_matrix_append(&vwap_hist, ts[r], row);
   }
+  shm_channel_publish_names(trade_channel, symbols[0].symbol, sizeof(symbol_data)); // this process's columns
+  printf("INFO: Attached to the ingest process (%d minutes of VWAP history restored)\n", n > 0 ? n : 0);
+  return 0;
 }
 
 /* ============================================================================
  * TRADE PROCESSING THREAD
  * ============================================================================ */
 
+/**
+ * @brief Applies the logging policies of a newly published configuration (slot writer only).
+ * @param cfg Published configuration.
+ */
+static void apply_log_policies(const runtime_config *cfg)
+{
+  int64_t now = now_ms();
+  rotating_log_set_policy(&latency_log, cfg->latency_log_rotate, now);
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+    if (cfg->symbols[i][0])
+      segment_log_set_policy(&symbols[i].trade_log, cfg->trade_log_rotate, now);
+}
+
 /**
  * @brief Consumer thread for processing events.
  * @param arg Thread argument (unused).
@@ -108,14 +312,24 @@ static void *trade_processor_thread_fn(void *arg)
 {
   (void)arg;
   raw_trade_message msg;
+  uint64_t dropped = 0;
+  int64_t last_drop_warning_ms = 0;
+  uint64_t generation = runtime_config_current()->generation;
+  alloc_audit_thread_start("trade-processor", 1);
 
-  while (!shutdown_requested)
+  while (!__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
   {
-    if (!trade_queue_pop(&raw_queue, &msg))
+    runtime_config_reader_offline(); // may block: a reload need not wait for us
+    int popped = trade_queue_pop(&raw_queue, &msg);
+    runtime_config_reader_online(); // no slot from an older configuration is held past here
+    if (!popped)
+      break; // queue closed and drained, or the shutdown budget ran out
+
+    const runtime_config *cfg = runtime_config_current();
+    if (cfg->generation != generation)
     {
-      if (shutdown_requested)
-        break;
-      continue;
+      apply_log_policies(cfg);
+      generation = cfg->generation;
     }
 
     /* parse the raw JSON message to extract trade details */
@@ -127,123 +341,562 @@ static void *trade_processor_thread_fn(void *arg)
 
     /* process message: append to log and update window */
     trade_log_append(msg.symbol_index, &msg);
+    symbols[msg.symbol_index].trades++;
+    symbols[msg.symbol_index].last_trade_ts_ms = msg.exchange_ts_ms;
+    alloc_audit_trade(msg.exchange_ts_ms);
     int64_t process_ts_ms = now_ms();
     log_latency_metrics(msg.symbol_index, msg.exchange_ts_ms, msg.receive_ts_ms, process_ts_ms);
-    sliding_window_add_trade(&symbols[msg.symbol_index].trade_window, msg.exchange_ts_ms, msg.price, msg.size);
+
+    if (trade_channel)
+    {
+      /* ingest role: hand the parsed trade to the analytics process, never block on it */
+      shm_trade trade = {msg.exchange_ts_ms, msg.receive_ts_ms, msg.price, msg.size, msg.side, ""};
+      memcpy(trade.symbol, symbols[msg.symbol_index].symbol, SYMBOL_NAME_MAX); // SHM_SYMBOL_MAX is larger
+      while (lossless_feed && shm_channel_space(trade_channel) == 0 &&
+             !__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
+        usleep(1000); // replay: the analytics process sets the pace
+      if (!shm_channel_push(trade_channel, &trade))
+      {
+        dropped++;
+        if (process_ts_ms - last_drop_warning_ms >= 1000) // at most one warning per second
+        {
+          fprintf(stderr, "WARNING: Shared-memory ring full (analytics down or slow), %" PRIu64 " trades dropped\n",
+                  dropped);
+          last_drop_warning_ms = process_ts_ms;
+        }
+      }
+      continue;
+    }
+
+    sliding_window_add_trade(&symbols[msg.symbol_index].trade_window, msg.exchange_ts_ms, msg.price, msg.size,
+                             msg.side);
+    bar_builder_add_trade(&symbols[msg.symbol_index].bars, msg.price, msg.size);
   }
 
+  runtime_config_reader_offline();
+  return NULL;
+}
+
+/**
+ * @brief Analytics-role consumer of the shared-memory ring, in place of the trade processor.
+ * @details Stops the process once the ingest process is gone and its trades are drained.
+ * @param arg Thread argument (unused).
+ * @return NULL.
+ */
+static void *shm_consumer_thread_fn(void *arg)
+{
+  (void)arg;
+  shm_trade trade;
+  alloc_audit_thread_start("shm-consumer", 1);
+
+  while (!__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
+  {
+    runtime_config_reader_online();
+    if (!shm_channel_pop(trade_channel, &trade))
+    {
+      runtime_config_reader_offline(); // about to sleep
+      if (!shm_channel_wait(trade_channel, SHM_WAIT_TIMEOUT_MS) && !shm_channel_producer_alive(trade_channel) &&
+          !shm_channel_wait(trade_channel, 0)) // nothing was pushed just before it exited
+      {
+        fprintf(stderr, "WARNING: Ingest process has exited, stopping analytics\n");
+        kill(getpid(), SIGINT); // process-directed, so the main thread's signalfd sees it
+        break;
+      }
+      continue;
+    }
+
+    /* the slot comes from this process's configuration, which may differ from the ingest one */
+    int idx = runtime_config_symbol_index(runtime_config_current(), trade.symbol);
+    if (idx < 0)
+      continue;
+    symbols[idx].trades++;
+    symbols[idx].last_trade_ts_ms = trade.exchange_ts_ms;
+    alloc_audit_trade(trade.exchange_ts_ms);
+    sliding_window_add_trade(&symbols[idx].trade_window, trade.exchange_ts_ms, trade.price, trade.size,
+                             trade.side);
+    bar_builder_add_trade(&symbols[idx].bars, trade.price, trade.size);
+  }
+
+  runtime_config_reader_offline();
   return NULL;
 }
 
 /* ============================================================================
- * SIGNAL HANDLING
+ * CONFIGURATION RELOAD
  * ============================================================================ */
 
 /**
- * @brief Signal handler for graceful shutdown.
+ * @brief Applies the config file to the running process.
+ * @details Removed symbols leave in a first generation; once the slot writer has moved
+ * past it, their logs are retired and their windows freed. Added symbols then get fresh
+ * slots and a second generation publishes them. The trade path never waits for any of
+ * this: it only loads the current configuration pointer. The per-minute tick is held off
+ * (compute_lock) while slots change.
+ */
+static void reload_config(void)
+{
+  runtime_config wanted, shrunk, grown;
+  if (runtime_config_load(config_path, 1, &wanted) < 0)
+  {
+    fprintf(stderr, "WARNING: Keeping the current configuration\n");
+    return;
+  }
+  const runtime_config *current = runtime_config_current();
+  runtime_config_plan(current, &wanted, &shrunk, &grown);
+
+  pthread_mutex_lock(&compute_lock);
+  runtime_config_publish(&shrunk);
+  runtime_config_synchronize(); // no trade of a removed symbol is in flight any more
+
+  int removed = 0, added = 0;
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    if (!current->symbols[i][0] || shrunk.symbols[i][0])
+      continue;
+    if (role != ROLE_ANALYTICS)
+      segment_log_retire(&symbols[i].trade_log); // the sync thread finalizes the segment
+    if (role != ROLE_INGEST)
+    {
+      symbol_windows_cleanup(i);
+      vwap_matrix_clear_column(&vwap_hist, i); // a later symbol in this slot starts without history
+      for (int m = 0; m < NUM_ALERT_METRICS; ++m)
+        minute_metrics[i][m] = NAN;
+    }
+    symbols[i].symbol[0] = '\0';
+    removed++;
+  }
+
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    if (!grown.symbols[i][0] || shrunk.symbols[i][0])
+      continue;
+    memcpy(symbols[i].symbol, grown.symbols[i], SYMBOL_NAME_MAX);
+    symbols[i].trades = 0;
+    symbols[i].last_trade_ts_ms = 0;
+    if (role != ROLE_INGEST)
+    {
+      symbol_windows_init(i);
+      init_symbol_analytics_files(i);
+    }
+    if (role != ROLE_ANALYTICS)
+      init_symbol_ingest_files(i);
+    added++;
+  }
+  const runtime_config *published = runtime_config_publish(&grown);
+
+  if ((removed > 0 || added > 0) && role != ROLE_INGEST)
+  {
+    alert_engine_reload();
+    if (trade_channel)
+      shm_channel_publish_names(trade_channel, symbols[0].symbol, sizeof(symbol_data));
+  }
+  pthread_mutex_unlock(&compute_lock);
+
+  if (lws_context)
+    lws_cancel_service(lws_context); // the WebSocket thread updates the subscription
+
+  printf("INFO: Reloaded %s (generation %" PRIu64 "): %d symbols, %d added, %d removed\n", config_path,
+         published->generation, published->num_symbols, added, removed);
+}
+
+/* ============================================================================
+ * SIGNAL HANDLING AND SHUTDOWN
+ * ============================================================================ */
+
+/**
+ * @brief No-op handler: delivering SHUTDOWN_WAKE_SIGNAL interrupts the scheduler's sleep.
  * @param sig Signal number.
  */
-static void on_termination_signal(int sig)
+static void on_wake_signal(int sig)
 {
   (void)sig;
-  printf("\n=== GRACEFUL TERMINATION INITIATED ===\n");
-  printf("INFO: Received termination signal, shutting down...\n");
+}
 
-  shutdown_requested = 1;
+/**
+ * @brief Blocks the process signals and opens the signalfd that delivers them to the main thread.
+ * @details Must run before any thread is created, so every thread inherits the mask and
+ * SIGINT/SIGTERM/SIGHUP (including the kill() calls of the feed threads) only reach the
+ * signalfd. Signal handlers are thus no longer needed for shutdown or reload.
+ */
+static void signals_init(void)
+{
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGINT);
+  sigaddset(&set, SIGTERM);
+  sigaddset(&set, SIGHUP);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  signal_fd = signalfd(-1, &set, SFD_CLOEXEC);
+  if (signal_fd < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to create signalfd: %s\n", strerror(errno));
+    exit(1);
+  }
 
-  /* wake up any threads that are blocked on I/O or condition variables */
-  lws_cancel_service(lws_context);               // unblocks lws_service
-  pthread_cond_signal(&raw_queue.cond_not_empty); // unblocks trade_queue_pop
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = on_wake_signal; // no SA_RESTART: the interrupted sleep returns EINTR
+  sigemptyset(&sa.sa_mask);
+  sigaction(SHUTDOWN_WAKE_SIGNAL, &sa, NULL);
+}
+
+/**
+ * @brief Waits for the next signal on the signalfd.
+ * @param timeout_ms Maximum wait, or -1 to wait indefinitely.
+ * @return Signal number, or 0 on timeout.
+ */
+static int wait_signal(int timeout_ms)
+{
+  struct pollfd pfd = {signal_fd, POLLIN, 0};
+  if (poll(&pfd, 1, timeout_ms) <= 0)
+    return 0;
+
+  struct signalfd_siginfo info;
+  if (read(signal_fd, &info, sizeof(info)) != (ssize_t)sizeof(info))
+    return 0;
+  return (int)info.ssi_signo;
+}
+
+/**
+ * @brief Joins a thread, giving up at a monotonic deadline.
+ * @param thread Thread to join.
+ * @param deadline_ns Monotonic deadline (now_monotonic_ns).
+ * @return 0 if joined, -1 if the thread was still running at the deadline.
+ */
+static int join_by(pthread_t thread, int64_t deadline_ns)
+{
+  int64_t remaining_ns = deadline_ns - now_monotonic_ns();
+  if (remaining_ns < 0)
+    remaining_ns = 0;
+
+  struct timespec abstime; // pthread_timedjoin_np takes CLOCK_REALTIME
+  clock_gettime(CLOCK_REALTIME, &abstime);
+  abstime.tv_sec += (time_t)(remaining_ns / 1000000000LL);
+  abstime.tv_nsec += (long)(remaining_ns % 1000000000LL);
+  if (abstime.tv_nsec >= 1000000000L)
+  {
+    abstime.tv_sec++;
+    abstime.tv_nsec -= 1000000000L;
+  }
+  return pthread_timedjoin_np(thread, NULL, &abstime) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Stops the pipeline in order, draining queued trades within the shutdown budget.
+ * @details The feed stops first; the trade processor then empties the queue and exits
+ * on its own. If the budget runs out, the processor is stopped and the trades still
+ * queued are counted as abandoned; a feed thread stuck in a read is left behind. The
+ * per-minute threads stop last (a tick in progress completes). In the analytics role,
+ * trades still in the shared-memory ring stay there for the next analytics process.
+ * @param feed Feed thread (WebSocket or replay; unused in the analytics role).
+ * @param consumer Trade processor or shared-memory consumer thread.
+ * @param scheduler Scheduler thread (unused in the ingest role).
+ * @param report Pointer to store the outcome.
+ * @return Monotonic deadline of the budget, for the remaining cleanup.
+ */
+static int64_t shutdown_pipeline(pthread_t feed, pthread_t consumer, pthread_t scheduler, shutdown_report *report)
+{
+  report->budget_ms = runtime_config_current()->shutdown_budget_ms;
+  int64_t deadline_ns = now_monotonic_ns() + (int64_t)report->budget_ms * 1000000LL;
+
+  if (role != ROLE_ANALYTICS)
+  {
+    __atomic_store_n(&ingest_stop_requested, 1, __ATOMIC_RELEASE);
+    if (lws_context)
+      lws_cancel_service(lws_context); // unblocks lws_service (not created in replay mode)
+    if (join_by(feed, deadline_ns) < 0)
+    {
+      fprintf(stderr, "WARNING: Feed thread did not stop within the shutdown budget, leaving it behind\n");
+      pthread_detach(feed);
+      feed_detached = 1;
+      report->budget_exceeded = 1;
+    }
+
+    report->queued = raw_queue_close(&raw_queue); // the processor exits once it is empty
+    printf("INFO: Ingestion stopped, draining %" PRIu32 " queued trades\n", report->queued);
+    if (join_by(consumer, deadline_ns) < 0)
+    {
+      __atomic_store_n(&shutdown_requested, 1, __ATOMIC_RELEASE);
+      pthread_mutex_lock(&raw_queue.lock);
+      pthread_cond_broadcast(&raw_queue.cond_not_empty);
+      pthread_mutex_unlock(&raw_queue.lock);
+      pthread_join(consumer, NULL); // at most one more trade
+      report->abandoned = raw_queue_size(&raw_queue);
+      report->budget_exceeded = 1;
+    }
+  }
+
+  __atomic_store_n(&shutdown_requested, 1, __ATOMIC_RELEASE);
+  if (role == ROLE_ANALYTICS)
+    pthread_join(consumer, NULL); // within SHM_WAIT_TIMEOUT_MS
+
+  if (role != ROLE_INGEST)
+  {
+    /* a tick in progress completes; a sleeping scheduler is woken (again, if the signal
+     * landed just before it went to sleep) */
+    do
+      pthread_kill(scheduler, SHUTDOWN_WAKE_SIGNAL);
+    while (join_by(scheduler, now_monotonic_ns() + 50 * 1000000LL) < 0);
+    pthread_join(vwap_worker_thread, NULL);
+    pthread_join(correlation_worker_thread, NULL);
+  }
+  return deadline_ns;
 }
 
 /* ============================================================================
  * MAIN FUNCTION
  * ============================================================================ */
 
+/**
+ * @brief Prints command-line usage.
+ * @param prog Program name.
+ */
+static void print_usage(const char *prog)
+{
+  fprintf(stderr, "Usage: %s [--replay FILE|-] [--alerts FILE] [--config FILE] [--role all|ingest|analytics]\n",
+          prog);
+  fprintf(stderr, "  --replay FILE  feed archived JSONL trades (or stdin with '-') instead of the OKX WebSocket\n");
+  fprintf(stderr, "  --alerts FILE  alert rule file (default: %s if present)\n", ALERT_RULES_PATH);
+  fprintf(stderr, "  --config FILE  symbols and logging policies, reloaded on SIGHUP (default: %s if present)\n",
+          CONFIG_PATH);
+  fprintf(stderr, "  --role ROLE    all (default), ingest (feed and trade logs) or analytics (metrics),\n");
+  fprintf(stderr, "                 the last two connected through shared memory %s\n", SHM_CHANNEL_NAME);
+}
+
 /**
  * @brief Main entry point of the program.
+ * @param argc Argument count.
+ * @param argv Argument vector.
  * @return 0 on success, 1 on error.
  */
-int main(void)
+int main(int argc, char **argv)
 {
+  const char *replay_path = NULL;
+  const char *alerts_path = NULL;
+  int config_required = 0;
+
+  static const struct option long_options[] = {
+      {"replay", required_argument, NULL, 'r'},
+      {"alerts", required_argument, NULL, 'a'},
+      {"config", required_argument, NULL, 'c'},
+      {"role", required_argument, NULL, 'R'},
+      {"help", no_argument, NULL, 'h'},
+      {NULL, 0, NULL, 0}};
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "r:a:c:R:h", long_options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+    case 'r':
+      replay_path = optarg;
+      break;
+    case 'a':
+      alerts_path = optarg;
+      break;
+    case 'c':
+      config_path = optarg;
+      config_required = 1;
+      break;
+    case 'R':
+      if (strcmp(optarg, "all") == 0)
+        role = ROLE_ALL;
+      else if (strcmp(optarg, "ingest") == 0)
+        role = ROLE_INGEST;
+      else if (strcmp(optarg, "analytics") == 0)
+        role = ROLE_ANALYTICS;
+      else
+      {
+        fprintf(stderr, "ERROR: Unknown role '%s'\n", optarg);
+        print_usage(argv[0]);
+        return 1;
+      }
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (role == ROLE_ANALYTICS && replay_path)
+  {
+    fprintf(stderr, "ERROR: --replay feeds the ingest process, not the analytics one\n");
+    return 1;
+  }
+
+  /* symbols and logging policies: the first configuration generation */
+  runtime_config startup_config;
+  int loaded = runtime_config_load(config_path, config_required, &startup_config);
+  if (loaded < 0)
+    return 1;
+  runtime_config_publish(&startup_config);
+
   printf("=== OKX REAL-TIME TRADE PROCESSOR STARTING ===\n");
-  printf("INFO: Monitoring %d cryptocurrency symbols\n", NUM_SYMBOLS);
+  if (loaded)
+    printf("INFO: Configuration read from %s (send SIGHUP to reload it)\n", config_path);
+  printf("INFO: Monitoring %d cryptocurrency symbols (up to %d)\n", startup_config.num_symbols, NUM_SYMBOLS);
   printf("INFO: Window size: %d minutes (%lld ms)\n", WINDOW_MINUTES, (long long)WINDOW_MS);
-  printf("INFO: Window capacity: %d trades per symbol\n", WINDOW_CAPACITY);
+  printf("INFO: Window capacity: up to %d trades per symbol, in chunks of %d from a pool of %d (%zu MB)\n",
+         WINDOW_CAPACITY, WINDOW_CHUNK_TRADES, WINDOW_POOL_CHUNKS,
+         WINDOW_POOL_BYTES / (1024 * 1024));
+  if (WINDOW_QUANTILE_MODE == QUANTILE_EXACT)
+    printf("INFO: Window quantiles: %u nodes shared by all symbols (%zu MB)\n", WINDOW_QUANTILE_NODES,
+           WINDOW_QUANTILE_NODES * sizeof(quantile_node) / (1024 * 1024));
   printf("INFO: Moving average points: %d\n", MOVING_AVG_POINTS);
   printf("INFO: Maximum correlation lag: %d minutes\n", MAX_LAG_MINUTES);
+  if (role != ROLE_ALL)
+    printf("INFO: Running as the %s process\n", role == ROLE_INGEST ? "ingest" : "analytics");
   
-  signal(SIGINT, on_termination_signal);
-  signal(SIGTERM, on_termination_signal);
+  signals_init(); // before any thread exists
 
   ensure_BASE_DATA_DIRs();
 
   /* init structures */
-  trade_queue_init(&raw_queue, RAW_TRADE_QUEUE_SIZE); // initialize raw trade queue
-  symbols_data_init();                       // initialize all symbol data structures
+  symbols_data_init(); // initialize all symbol data structures
 
-  init_output_files(); // create and initialize all output files
+  if (role != ROLE_ANALYTICS)
+  {
+    trade_queue_init(&raw_queue, RAW_TRADE_QUEUE_SIZE); // initialize raw trade queue
+    if (LOG_COMPRESS_SEGMENTS)
+      segment_compressor_start(); // background gzip of rotated segments
+    init_ingest_output_files();   // trade logs and latency log
+  }
+  if (role != ROLE_INGEST)
+  {
+    init_analytics_output_files(); // per-minute metric and performance CSVs
+
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+      for (int m = 0; m < NUM_ALERT_METRICS; ++m)
+        minute_metrics[i][m] = NAN;
+    if (alert_engine_init(alerts_path ? alerts_path : ALERT_RULES_PATH, alerts_path != NULL) < 0)
+      return 1;
+    correlation_init();
+  }
 
-  /* create websocket thread */
-  lws_set_log_level(LLL_USER | LLL_ERR | LLL_WARN, NULL); // set lws log level (enable user, error, warning)
-  pthread_t websocket_thread;
-  if (pthread_create(&websocket_thread, NULL, websocket_thread_fn, NULL) != 0)
+  if (role == ROLE_INGEST)
   {
-    fprintf(stderr, "ERROR: Failed to create WebSocket thread: %s\n", strerror(errno));
-    return 1;
+    if (shm_channel_create(&channel, SHM_CHANNEL_NAME, SHM_TRADE_RING_SIZE, VWAP_HISTORY_SIZE_MINUTES,
+                           NUM_SYMBOLS) < 0)
+      return 1;
+    trade_channel = &channel;
+    mem_budget_add(MEM_IPC, (int64_t)channel.map_bytes);
+    lossless_feed = replay_path != NULL;
+    printf("INFO: Forwarding trades to the analytics process through %s (%d slots)\n", SHM_CHANNEL_NAME,
+           SHM_TRADE_RING_SIZE);
+  }
+  else if (role == ROLE_ANALYTICS && analytics_attach() < 0)
+  {
+    cleanup_resources(0, NULL);
+    return __atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE) ? 0 : 1;
   }
 
-  /* create trade processor thread */
-  pthread_t trade_processor_thread;
-  if (pthread_create(&trade_processor_thread, NULL, trade_processor_thread_fn, NULL) != 0)
+  /* everything preallocated is in place: check it against the budget before any thread runs */
+  if (mem_budget_enforce(runtime_config_current()->memory_budget_mb) < 0)
   {
-    fprintf(stderr, "ERROR: Failed to create trade processor thread: %s\n", strerror(errno));
+    cleanup_resources(0, NULL);
     return 1;
   }
 
-  /* initialize barriers for 3 threads: coordinator + 2 workers */
-  pthread_barrier_init(&compute_start_barrier, NULL, 3);
-  pthread_barrier_init(&compute_done_barrier, NULL, 3);
-
-  /* create worker threads */
-  if (pthread_create(&vwap_worker_thread, NULL, vwap_worker_fn, NULL) != 0)
+  /* the feed side: websocket (or replay) thread and trade processor */
+  pthread_t websocket_thread = 0, trade_processor_thread;
+  if (role != ROLE_ANALYTICS)
   {
-    fprintf(stderr, "ERROR: Failed to create VWAP worker thread: %s\n", strerror(errno));
-    return 1;
+    if (segment_log_sync_start() < 0) // periodic msync; finalizes the segments a roll-over retires
+      return 1;
+
+    /* create websocket thread (or the replay feeder in its place) */
+    lws_set_log_level(LLL_USER | LLL_ERR | LLL_WARN, NULL); // set lws log level (enable user, error, warning)
+    if (replay_path)
+    {
+      if (pthread_create(&websocket_thread, NULL, replay_thread_fn, (void *)replay_path) != 0)
+      {
+        fprintf(stderr, "ERROR: Failed to create replay thread: %s\n", strerror(errno));
+        return 1;
+      }
+    }
+    else if (pthread_create(&websocket_thread, NULL, websocket_thread_fn, NULL) != 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create WebSocket thread: %s\n", strerror(errno));
+      return 1;
+    }
+
+    /* create trade processor thread */
+    if (pthread_create(&trade_processor_thread, NULL, trade_processor_thread_fn, NULL) != 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create trade processor thread: %s\n", strerror(errno));
+      return 1;
+    }
   }
-  if (pthread_create(&correlation_worker_thread, NULL, correlation_worker_fn, NULL) != 0)
+  else if (pthread_create(&trade_processor_thread, NULL, shm_consumer_thread_fn, NULL) != 0)
   {
-    fprintf(stderr, "ERROR: Failed to create correlation worker thread: %s\n", strerror(errno));
+    fprintf(stderr, "ERROR: Failed to create shared-memory consumer thread: %s\n", strerror(errno));
     return 1;
   }
 
-  /* create metrics coordinator thread */
-  pthread_t scheduler_thread;
-  if (pthread_create(&scheduler_thread, NULL, scheduler_thread_fn, NULL) != 0)
+  /* the analytics side: per-minute workers and their coordinator */
+  pthread_t scheduler_thread = 0;
+  if (role != ROLE_INGEST)
   {
-    fprintf(stderr, "ERROR: Failed to create scheduler thread: %s\n", strerror(errno));
-    return 1;
+    /* initialize barriers for 3 threads: coordinator + 2 workers */
+    pthread_barrier_init(&compute_start_barrier, NULL, 3);
+    pthread_barrier_init(&compute_done_barrier, NULL, 3);
+
+    /* create worker threads */
+    if (pthread_create(&vwap_worker_thread, NULL, vwap_worker_fn, NULL) != 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create VWAP worker thread: %s\n", strerror(errno));
+      return 1;
+    }
+    if (pthread_create(&correlation_worker_thread, NULL, correlation_worker_fn, NULL) != 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create correlation worker thread: %s\n", strerror(errno));
+      return 1;
+    }
+
+    /* create metrics coordinator thread */
+    if (pthread_create(&scheduler_thread, NULL, scheduler_thread_fn, NULL) != 0)
+    {
+      fprintf(stderr, "ERROR: Failed to create scheduler thread: %s\n", strerror(errno));
+      return 1;
+    }
   }
 
   printf("=== ALL THREADS STARTED SUCCESSFULLY ===\n");
   printf("INFO: System is now processing real-time trade data\n");
   printf("INFO: Press Ctrl+C to stop gracefully\n");
 
-  pthread_join(websocket_thread, NULL);
-  pthread_join(trade_processor_thread, NULL);
-  pthread_join(scheduler_thread, NULL);
-  pthread_join(vwap_worker_thread, NULL);
-  pthread_join(correlation_worker_thread, NULL);
+  /* the main thread handles signals: SIGHUP reloads, SIGINT/SIGTERM shut down */
+  int sig;
+  while ((sig = wait_signal(-1)) != SIGINT && sig != SIGTERM)
+    if (sig == SIGHUP)
+      reload_config();
+
+  printf("\n=== GRACEFUL TERMINATION INITIATED ===\n");
+  shutdown_report report;
+  memset(&report, 0, sizeof(report));
+  report.role = role == ROLE_ALL ? "all" : role == ROLE_INGEST ? "ingest" : "analytics";
+  report.requested_ms = now_ms();
+  printf("INFO: Received %s, shutting down...\n", strsignal(sig));
 
+  int64_t deadline_ns = shutdown_pipeline(websocket_thread, trade_processor_thread, scheduler_thread, &report);
   printf("INFO: All threads have terminated\n");
+  int audit_failed = alloc_audit_report() < 0; // ALLOC_AUDIT builds only
 
-  pthread_barrier_destroy(&compute_start_barrier);
-  pthread_barrier_destroy(&compute_done_barrier);
+  if (role != ROLE_INGEST)
+  {
+    pthread_barrier_destroy(&compute_start_barrier);
+    pthread_barrier_destroy(&compute_done_barrier);
+  }
 
   /* cleanup */
   printf("INFO: Cleaning up resources...\n");
-  cleanup_resources();
+  cleanup_resources(deadline_ns, &report);
+  close(signal_fd);
 
+  printf("INFO: Shutdown took %" PRId64 " ms (budget %d ms): drained %" PRIu32 " of %" PRIu32
+         " queued trades, %" PRIu32 " abandoned%s\n",
+         report.finished_ms - report.requested_ms, report.budget_ms, report.queued - report.abandoned,
+         report.queued, report.abandoned, report.budget_exceeded ? " (budget exceeded)" : "");
   printf("=== PROGRAM TERMINATED GRACEFULLY ===\n");
-  return 0;
+  return audit_failed ? 1 : 0;
 }
\ No newline at end of file
@@ -8,21 +8,29 @@
 
 #include "okx_parser.h"
 #include "../utils/time_utils.h"
+#include "../utils/runtime_config.h"
 
-const char *okx_subscribe_payload =
-    "{"
-    "\"op\":\"subscribe\"," // JSON -> "op":"subscribe",
-    "\"args\":["
-    "{\"channel\":\"trades\",\"instId\":\"BTC-USDT\"},"
-    "{\"channel\":\"trades\",\"instId\":\"ADA-USDT\"},"
-    "{\"channel\":\"trades\",\"instId\":\"ETH-USDT\"},"
-    "{\"channel\":\"trades\",\"instId\":\"DOGE-USDT\"},"
-    "{\"channel\":\"trades\",\"instId\":\"XRP-USDT\"},"
-    "{\"channel\":\"trades\",\"instId\":\"SOL-USDT\"},"
-    "{\"channel\":\"trades\",\"instId\":\"LTC-USDT\"},"
-    "{\"channel\":\"trades\",\"instId\":\"BNB-USDT\"}"
-    "]"
-    "}";
+/**
+ * @brief Builds an OKX request that subscribes to (or unsubscribes from) the trades of instruments.
+ * @param op "subscribe" or "unsubscribe".
+ * @param names First instrument id.
+ * @param stride Distance between instrument ids.
+ * @param count Number of instrument ids.
+ * @param buf Output buffer.
+ * @param size Output buffer size.
+ * @return Payload length, or -1 if the buffer is too small.
+ */
+int okx_build_subscription(const char *op, const char *names, size_t stride, int count, char *buf, size_t size)
+{
+  /* e.g. {"op":"subscribe","args":[{"channel":"trades","instId":"BTC-USDT"},...]} */
+  size_t len = (size_t)snprintf(buf, size, "{\"op\":\"%s\",\"args\":[", op);
+  for (int i = 0; i < count && len < size; ++i)
+    len += (size_t)snprintf(buf + len, size - len, "%s{\"channel\":\"trades\",\"instId\":\"%s\"}", i ? "," : "",
+                            names + (size_t)i * stride);
+  if (len < size)
+    len += (size_t)snprintf(buf + len, size - len, "]}");
+  return len < size ? (int)len : -1;
+}
 
 /**
  * @brief Helper function to extract quoted string value (C version).
@@ -121,16 +129,8 @@ int parse_okx_trade(const char *json, raw_trade_message *msg)
     return 0;
   }
 
-  // Map instId to symbol index
-  int symbol_idx = -1;
-  for (int i = 0; i < NUM_SYMBOLS; ++i)
-  {
-    if (strcmp(inst_id, SYMBOLS[i]) == 0)
-    {
-      symbol_idx = i;
-      break;
-    }
-  }
+  // Map instId to its slot in the published configuration
+  int symbol_idx = runtime_config_symbol_index(runtime_config_current(), inst_id);
   if (symbol_idx < 0) {
     fprintf(stderr, "WARNING: Unknown symbol '%s' in trade message\n", inst_id);
     return 0;
@@ -167,6 +167,19 @@ int parse_okx_trade(const char *json, raw_trade_message *msg)
     return 0;
   }
 
+  // Extract taker side; older or foreign feeds may omit it
+  char side_str[8];
+  int side = TRADE_SIDE_UNKNOWN;
+  const char *side_cursor = json_extract_string(cursor, "\"side\"", side_str, sizeof(side_str));
+  if (side_cursor)
+  {
+    if (strcmp(side_str, "buy") == 0)
+      side = TRADE_SIDE_BUY;
+    else if (strcmp(side_str, "sell") == 0)
+      side = TRADE_SIDE_SELL;
+    cursor = side_cursor;
+  }
+
   // Extract timestamp with validation
   char ts_str[32];
   cursor = json_extract_string(cursor, "\"ts\"", ts_str, sizeof(ts_str));
@@ -192,6 +205,7 @@ int parse_okx_trade(const char *json, raw_trade_message *msg)
   msg->exchange_ts_ms = ts_ms;
   msg->price = price;
   msg->size = size;
+  msg->side = side;
 
   return 1;
 }
\ No newline at end of file
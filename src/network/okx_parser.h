@@ -29,6 +29,16 @@ const char *json_extract_string(const char *json, const char *key, char *out, si
  */
 int parse_okx_trade(const char *json, raw_trade_message *msg);
 
-extern const char *okx_subscribe_payload;
+/**
+ * @brief Builds an OKX request that subscribes to (or unsubscribes from) the trades of instruments.
+ * @param op "subscribe" or "unsubscribe".
+ * @param names First instrument id.
+ * @param stride Distance between instrument ids.
+ * @param count Number of instrument ids.
+ * @param buf Output buffer.
+ * @param size Output buffer size.
+ * @return Payload length, or -1 if the buffer is too small.
+ */
+int okx_build_subscription(const char *op, const char *names, size_t stride, int count, char *buf, size_t size);
 
 #endif /* OKX_PARSER_H */
\ No newline at end of file
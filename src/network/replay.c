@@ -0,0 +1,92 @@
+/**
+ * @file replay.c
+ * @brief Replay of archived trade messages implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "replay.h"
+#include "../data/queue.h"
+#include "../utils/time_utils.h"
+#include "../utils/alloc_audit.h"
+
+/**
+ * @brief Sleeps for a number of milliseconds.
+ * @param ms Duration in milliseconds.
+ */
+static void replay_sleep_ms(long ms)
+{
+  struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * NS_PER_MS};
+  nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Thread function feeding archived raw JSON lines into the trade queue.
+ * @details Replaces the WebSocket thread in replay mode. Lines are pushed with
+ * backpressure (the live queue drops the oldest message when full) and the
+ * program is asked to shut down once the input is exhausted; the shutdown drains the queue.
+ * @param arg Path of a JSONL file, or "-" for stdin (e.g. piped from trade_query).
+ * @return NULL.
+ */
+void *replay_thread_fn(void *arg)
+{
+  const char *path = (const char *)arg;
+  alloc_audit_thread_start("replay", 0);
+  FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open replay input %s: %s\n", path, strerror(errno));
+    kill(getpid(), SIGINT); // process-directed, so the main thread's signalfd sees it
+    return NULL;
+  }
+
+  printf("INFO: Replaying trades from %s\n", strcmp(path, "-") == 0 ? "stdin" : path);
+
+  static char line[4096];
+  raw_trade_message msg;
+  long long replayed = 0;
+
+  while (!__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE) && fgets(line, sizeof(line), fp))
+  {
+    size_t len = strcspn(line, "\r\n");
+
+    /* discard the rest of an over-long line */
+    if (line[len] == '\0' && !feof(fp))
+    {
+      int c;
+      while ((c = fgetc(fp)) != EOF && c != '\n')
+        ;
+    }
+
+    if (len == 0)
+      continue;
+
+    /* leave room in the queue: a full live queue overwrites its oldest entry */
+    while (raw_queue_size(&raw_queue) >= raw_queue.capacity - 1 &&
+           !__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE))
+      replay_sleep_ms(1);
+
+    memset(&msg, 0, sizeof(msg));
+    if (len > sizeof(msg.raw_json) - 1)
+      len = sizeof(msg.raw_json) - 1;
+    memcpy(msg.raw_json, line, len);
+    msg.raw_json[len] = '\0';
+    msg.receive_ts_ms = now_ms();
+
+    trade_queue_push(&raw_queue, &msg);
+    replayed++;
+  }
+
+  if (fp != stdin)
+    fclose(fp);
+
+  printf("INFO: Replay input exhausted after %lld messages\n", replayed);
+
+  /* stop as on Ctrl+C: the processor drains what is still queued */
+  if (!__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE))
+    kill(getpid(), SIGINT);
+
+  return NULL;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file replay.h
+ * @brief Replay of archived trade messages declarations
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Thread function feeding archived raw JSON lines into the trade queue.
+ * @details Replaces the WebSocket thread in replay mode. Lines are pushed with
+ * backpressure (the live queue drops the oldest message when full) and the
+ * program is asked to shut down once the input is exhausted and processed.
+ * @param arg Path of a JSONL file, or "-" for stdin (e.g. piped from trade_query).
+ * @return NULL.
+ */
+void *replay_thread_fn(void *arg);
+
+#endif /* REPLAY_H */
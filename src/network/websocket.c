@@ -10,12 +10,85 @@
 #include "okx_parser.h"
 #include "../data/queue.h"
 #include "../utils/time_utils.h"
+#include "../utils/runtime_config.h"
+#include "../utils/alloc_audit.h"
 
 /* WebSocket globals */
 struct lws_context *lws_context;
 struct lws *ws_client = NULL;
 int reconnect_attempts, reconnect_backoff_s;
 
+/* Instruments subscribed on the current connection, and the next change (WebSocket thread only) */
+static char subscribed[NUM_SYMBOLS][SYMBOL_NAME_MAX];
+static char pending[NUM_SYMBOLS][SYMBOL_NAME_MAX];
+
+/**
+ * @brief Lists the instruments whose subscription differs from the published configuration.
+ * @param unsubscribe Nonzero for subscribed instruments that were removed, zero for
+ * configured instruments that are not subscribed yet.
+ * @return Number of instruments stored in `pending`.
+ */
+static int subscription_changes(int unsubscribe)
+{
+  const runtime_config *cfg = runtime_config_current();
+  int n = 0;
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    const char *name = unsubscribe ? subscribed[i] : cfg->symbols[i];
+    if (!name[0])
+      continue;
+
+    int listed = 0;
+    if (unsubscribe)
+      listed = runtime_config_symbol_index(cfg, name) >= 0;
+    else
+      for (int j = 0; j < NUM_SYMBOLS && !listed; ++j)
+        listed = strcmp(name, subscribed[j]) == 0;
+    if (!listed)
+      memcpy(pending[n++], name, SYMBOL_NAME_MAX);
+  }
+  return n;
+}
+
+/**
+ * @brief Sends a subscribe or unsubscribe request for the `pending` instruments and records it.
+ * @param wsi WebSocket instance.
+ * @param op "subscribe" or "unsubscribe".
+ * @param count Number of pending instruments.
+ * @return 0 on success, -1 on error.
+ */
+static int send_subscription(struct lws *wsi, const char *op, int count)
+{
+  // Need to allocate buffer with LWS_PRE bytes before the payload
+  // LWS_PRE: number of extra bytes to reserve at the start of buffer (header bytes)
+  unsigned char buf[LWS_PRE + 64 + NUM_SYMBOLS * (48 + SYMBOL_NAME_MAX)];
+  int payload_len = okx_build_subscription(op, pending[0], SYMBOL_NAME_MAX, count, (char *)buf + LWS_PRE,
+                                           sizeof(buf) - LWS_PRE);
+
+  if (payload_len < 0 || lws_write(wsi, buf + LWS_PRE, (size_t)payload_len, LWS_WRITE_TEXT) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to send %s message\n", op);
+    return -1;
+  }
+
+  int unsubscribe = strcmp(op, "unsubscribe") == 0;
+  for (int k = 0; k < count; ++k)
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+    {
+      if (unsubscribe && strcmp(subscribed[i], pending[k]) == 0)
+      {
+        subscribed[i][0] = '\0';
+        break;
+      }
+      if (!unsubscribe && !subscribed[i][0])
+      {
+        memcpy(subscribed[i], pending[k], SYMBOL_NAME_MAX);
+        break;
+      }
+    }
+  return 0;
+}
+
 /**
  * @brief Libwebsockets callback function.
  * @param wsi WebSocket instance.
@@ -34,32 +107,12 @@ int okx_ws_client_callback(struct lws *wsi, enum lws_callback_reasons reason, vo
 
   case LWS_CALLBACK_CLIENT_ESTABLISHED:
   {
-    /* Connected: send subscription message */
+    /* Connected: subscribe to the configured symbols */
     printf("INFO: WebSocket connection established to OKX\n");
 
-    // Need to allocate buffer with LWS_PRE bytes before the payload
-    // LWS_PRE: number of extra bytes to reserve at the start of buffer (header bytes)
-    size_t payload_len = strlen(okx_subscribe_payload);
-    unsigned char *buf = malloc(LWS_PRE + payload_len);
-
-    if (!buf)
-    {
-      fprintf(stderr, "ERROR: Failed to allocate buffer for subscription message\n");
+    memset(subscribed, 0, sizeof(subscribed));
+    if (send_subscription(wsi, "subscribe", subscription_changes(0)) < 0)
       return -1;
-    }
-
-    // Copy payload after LWS_PRE bytes
-    memcpy(buf + LWS_PRE, okx_subscribe_payload, payload_len);
-
-    // Send the subscription message
-    int result = lws_write(wsi, buf + LWS_PRE, payload_len, LWS_WRITE_TEXT);
-    free(buf);
-
-    if (result < 0)
-    {
-      fprintf(stderr, "ERROR: Failed to send subscription message\n");
-      return -1;
-    }
 
     ws_client = wsi; // Store the websocket instance globally
 
@@ -90,6 +143,35 @@ int okx_ws_client_callback(struct lws *wsi, enum lws_callback_reasons reason, vo
     break;
   }
 
+  case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+  {
+    /* lws_cancel_service() after a config reload: resubscribe from the service thread */
+    if (ws_client && (subscription_changes(1) > 0 || subscription_changes(0) > 0))
+      lws_callback_on_writable(ws_client);
+    break;
+  }
+
+  case LWS_CALLBACK_CLIENT_WRITEABLE:
+  {
+    /* one request per writable callback: unsubscribe removed symbols first, then add new ones */
+    int n = subscription_changes(1);
+    if (n > 0)
+    {
+      if (send_subscription(wsi, "unsubscribe", n) < 0)
+        return -1;
+      printf("INFO: Unsubscribed from %d symbol(s)\n", n);
+      if (subscription_changes(0) > 0)
+        lws_callback_on_writable(wsi);
+    }
+    else if ((n = subscription_changes(0)) > 0)
+    {
+      if (send_subscription(wsi, "subscribe", n) < 0)
+        return -1;
+      printf("INFO: Subscribed to %d more symbol(s)\n", n);
+    }
+    break;
+  }
+
   case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
   {
     fprintf(stderr, "ERROR: WebSocket connection failed: %s\n", in ? (char *)in : "Unknown error");
@@ -99,7 +181,7 @@ int okx_ws_client_callback(struct lws *wsi, enum lws_callback_reasons reason, vo
 
   case LWS_CALLBACK_CLIENT_CLOSED:
   {
-    if (shutdown_requested)
+    if (__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE))
       printf("INFO: WebSocket connection closed gracefully\n");
     else
       fprintf(stderr, "WARNING: WebSocket connection lost unexpectedly\n");
@@ -141,6 +223,7 @@ void *websocket_thread_fn(void *arg)
   (void)arg;
   struct lws_context_creation_info ctx_info; // Context creation info
   struct lws_client_connect_info conn_info;    // Connection info
+  alloc_audit_thread_start("websocket", 0); // libwebsockets allocates per frame internally
 
   memset(&ctx_info, 0, sizeof(ctx_info));
   ctx_info.port = CONTEXT_PORT_NO_LISTEN;                  // Define as client only (no server)
@@ -158,7 +241,7 @@ void *websocket_thread_fn(void *arg)
 
   const int MAX_RETRY_ATTEMPTS = 8; // 2^9-1 = 511s total wait time (around 8.5 minutes)
 
-  while (!shutdown_requested)
+  while (!__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE))
   {
     printf("INFO: Attempting to connect to OKX WebSocket API...\n");
     memset(&conn_info, 0, sizeof(conn_info));
@@ -178,7 +261,7 @@ void *websocket_thread_fn(void *arg)
     printf("INFO: Connection attempt initiated, entering service loop...\n");
 
     /* run service loop until connection closed or established */
-    while (lws_service(lws_context, 1000) >= 0 && !shutdown_requested)
+    while (lws_service(lws_context, 1000) >= 0 && !__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE))
     { // 1000 ms timeout (ignored from v3.2)
       if (ws_client == NULL)
       {
@@ -187,7 +270,7 @@ void *websocket_thread_fn(void *arg)
       }
     }
 
-    if (shutdown_requested)
+    if (__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE))
       break; // Break outer loop if signaled (SIGINT)
 
     if (ws_client == NULL) // Connection failed or was lost
@@ -195,13 +278,16 @@ void *websocket_thread_fn(void *arg)
       if (++reconnect_attempts > MAX_RETRY_ATTEMPTS)
       {
         fprintf(stderr, "ERROR: Failed to reconnect after %d attempts, terminating\n", MAX_RETRY_ATTEMPTS);
-        raise(SIGINT); // signal main thread to exit
+        kill(getpid(), SIGINT); // signal main thread to exit (process-directed, for its signalfd)
         break;
       }
 
       fprintf(stderr, "WARNING: Connection failed, retry %d/%d - waiting %ds before next attempt\n", 
               reconnect_attempts, MAX_RETRY_ATTEMPTS, reconnect_backoff_s);
-      sleep(reconnect_backoff_s);
+      for (int waited_ms = 0;
+           waited_ms < reconnect_backoff_s * 1000 && !__atomic_load_n(&ingest_stop_requested, __ATOMIC_ACQUIRE);
+           waited_ms += 100)
+        usleep(100 * 1000); // a shutdown does not wait for the backoff
 
       // Exponential backoff
       reconnect_backoff_s = reconnect_backoff_s * 2;
@@ -9,7 +9,11 @@
 #include "scheduler.h"
 #include "../utils/time_utils.h"
 #include "../utils/system_monitor.h"
+#include "../utils/mem_budget.h"
+#include "../utils/alloc_audit.h"
+#include "../utils/runtime_config.h"
 #include "../logging/logger.h"
+#include "../compute/alert_engine.h"
 
 /**
  * @brief Coordinator thread that schedules the worker threads to run precisely every minute.
@@ -19,10 +23,12 @@
 void *scheduler_thread_fn(void *arg)
 {
   (void)arg;
+  alloc_audit_thread_start("scheduler", 0);
 
   /* Performance monitoring variables */
   double cpu_last_time = 0.0;
   double cpu_last_usage = 0.0;
+  int over_budget = 0;
 
   /* EMA for computation duration (in nanoseconds) */
   double ema_duration_ns = 0.0;
@@ -34,7 +40,7 @@ void *scheduler_thread_fn(void *arg)
   int64_t now_ns = now_monotonic_ns();
   int64_t scheduled_time_ns = ((now_ns / PERIOD_NS) + 1) * PERIOD_NS;
 
-  while (!shutdown_requested)
+  while (!__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
   {
     now_ns = now_monotonic_ns();
 
@@ -61,7 +67,7 @@ void *scheduler_thread_fn(void *arg)
     wake_ts.tv_nsec = target_wakeup_ns % NS_PER_SEC;
 
     /* Sleep until target time, handling interruptions */
-    while (!shutdown_requested)
+    while (!__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
     {
       int ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_ts, NULL);
 
@@ -83,9 +89,12 @@ void *scheduler_thread_fn(void *arg)
       }
     }
 
-    if (shutdown_requested)
+    if (__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
       break;
 
+    /* The symbol set stays put for the whole tick (a reload waits for it) */
+    pthread_mutex_lock(&compute_lock);
+
     /* Record current minute timestamp (aligned to minute boundary) */
     current_minute_ms = (now_ms() / MS_PER_MINUTE) * MS_PER_MINUTE;
 
@@ -98,6 +107,10 @@ void *scheduler_thread_fn(void *arg)
     /* Wait for workers to complete */
     pthread_barrier_wait(&compute_done_barrier);
 
+    /* Evaluate alert rules on the metrics the workers just published */
+    alert_engine_evaluate(current_minute_ms);
+    pthread_mutex_unlock(&compute_lock);
+
     int64_t work_end_ns = now_monotonic_ns();
     int64_t work_duration_ns = work_end_ns - work_start_ns;
 
@@ -115,6 +128,14 @@ void *scheduler_thread_fn(void *arg)
     double cpu_percent = get_cpu_usage(&cpu_last_time, &cpu_last_usage);
     double memory_mb = get_memory_mb();
     log_system_metrics(current_minute_ms, cpu_percent, memory_mb);
+
+    /* windows stay within their pools, but a reload adding symbols or alert rules raises the total: warn once past the budget */
+    int budget_mb = runtime_config_current()->memory_budget_mb;
+    int over = budget_mb > 0 && mem_budget_total() > (int64_t)budget_mb * 1024 * 1024;
+    if (over && !over_budget)
+      fprintf(stderr, "WARNING: Accounted memory (%.1f MB) is over the %d MB budget\n",
+              mem_budget_total() / (1024.0 * 1024.0), budget_mb);
+    over_budget = over;
     log_scheduler_metrics(scheduled_time_ns / NS_PER_MS, work_end_ns / NS_PER_MS, schedule_drift_ns);
 
     /* Schedule next period */
@@ -122,7 +143,7 @@ void *scheduler_thread_fn(void *arg)
   }
 
   /* Unblock worker threads so they can exit */
-  if (shutdown_requested)
+  if (__atomic_load_n(&shutdown_requested, __ATOMIC_ACQUIRE))
   {
     pthread_barrier_wait(&compute_start_barrier);
     pthread_barrier_wait(&compute_done_barrier);
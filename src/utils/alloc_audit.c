@@ -0,0 +1,195 @@
+/**
+ * @file alloc_audit.c
+ * @brief Steady-state allocation audit implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "alloc_audit.h"
+
+#ifdef ALLOC_AUDIT
+
+#include <dlfcn.h>
+
+#define AUDIT_MAX_THREADS 16 /**< registered threads */
+#define AUDIT_CALLERS 4      /**< distinct call sites kept per thread */
+
+/* glibc's allocator, which the wrappers below forward to */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+/**
+ * @brief Allocations of one thread after the warm-up (written by that thread only).
+ */
+typedef struct
+{
+  const char *name;
+  int trade_path;
+  uint64_t allocs;
+  uint64_t bytes;
+  void *callers[AUDIT_CALLERS];
+} audit_thread;
+
+static audit_thread audit_threads[AUDIT_MAX_THREADS];
+static int audit_num_threads;
+static int audit_warm; /**< set once the trade path has run ALLOC_AUDIT_WARMUP_MS of trade time */
+
+/* Calling thread's entry (-1 if unregistered) and its first trade */
+static __thread int audit_slot = -1;
+static __thread int64_t audit_first_ts_ms = -1;
+
+/**
+ * @brief Counts one allocation against the calling thread, once warmed up.
+ * @param size Bytes requested.
+ * @param caller Return address of the allocation call.
+ */
+static inline void audit_count(size_t size, void *caller)
+{
+  if (audit_slot < 0 || !__atomic_load_n(&audit_warm, __ATOMIC_RELAXED))
+    return;
+
+  audit_thread *t = &audit_threads[audit_slot];
+  for (int k = 0; k < AUDIT_CALLERS; ++k)
+  {
+    if (t->callers[k] == caller)
+      break;
+    if (!t->callers[k])
+    {
+      t->callers[k] = caller;
+      break;
+    }
+  }
+  t->allocs++;
+  t->bytes += size;
+}
+
+/**
+ * @brief Counting malloc.
+ * @param size Bytes.
+ * @return Allocated memory, or NULL.
+ */
+void *malloc(size_t size)
+{
+  audit_count(size, __builtin_return_address(0));
+  return __libc_malloc(size);
+}
+
+/**
+ * @brief Counting calloc.
+ * @param count Elements.
+ * @param size Bytes per element.
+ * @return Zeroed memory, or NULL.
+ */
+void *calloc(size_t count, size_t size)
+{
+  audit_count(count * size, __builtin_return_address(0));
+  return __libc_calloc(count, size);
+}
+
+/**
+ * @brief Counting realloc (resizing to 0 bytes is a free and is not counted).
+ * @param ptr Memory to resize (may be NULL).
+ * @param size New size.
+ * @return Resized memory, or NULL.
+ */
+void *realloc(void *ptr, size_t size)
+{
+  if (size > 0)
+    audit_count(size, __builtin_return_address(0));
+  return __libc_realloc(ptr, size);
+}
+
+/**
+ * @brief free, paired with the wrappers above.
+ * @param ptr Memory to release (may be NULL).
+ */
+void free(void *ptr)
+{
+  __libc_free(ptr);
+}
+
+/**
+ * @brief Registers the calling thread with the audit.
+ * @param name Thread name used in the report.
+ * @param trade_path Nonzero if the thread must not allocate in the steady state.
+ */
+void alloc_audit_thread_start(const char *name, int trade_path)
+{
+  int slot = __atomic_fetch_add(&audit_num_threads, 1, __ATOMIC_RELAXED);
+  if (slot >= AUDIT_MAX_THREADS)
+  {
+    fprintf(stderr, "WARNING: Allocation audit: too many threads, not tracking %s\n", name);
+    return;
+  }
+  audit_threads[slot].name = name;
+  audit_threads[slot].trade_path = trade_path;
+  audit_slot = slot;
+}
+
+/**
+ * @brief Notes a trade handled by the calling thread; ends the warm-up once trade time has
+ * advanced ALLOC_AUDIT_WARMUP_MS past the first one.
+ * @param trade_ts_ms Exchange timestamp of the trade.
+ */
+void alloc_audit_trade(int64_t trade_ts_ms)
+{
+  if (__atomic_load_n(&audit_warm, __ATOMIC_RELAXED))
+    return;
+  if (audit_first_ts_ms < 0)
+    audit_first_ts_ms = trade_ts_ms;
+  else if (trade_ts_ms - audit_first_ts_ms >= ALLOC_AUDIT_WARMUP_MS)
+  {
+    printf("INFO: Allocation audit: warm-up over, counting allocations from now on\n");
+    __atomic_store_n(&audit_warm, 1, __ATOMIC_RELAXED);
+  }
+}
+
+/**
+ * @brief Prints the allocations of every registered thread since the warm-up ended.
+ * @return 0 if no trade-path thread allocated, -1 if one did or the warm-up never ended.
+ */
+int alloc_audit_report(void)
+{
+  if (!__atomic_load_n(&audit_warm, __ATOMIC_RELAXED))
+  {
+    fprintf(stderr, "ERROR: Allocation audit: the input ended within the %lld ms warm-up\n",
+            (long long)ALLOC_AUDIT_WARMUP_MS);
+    return -1;
+  }
+
+  int failed = 0;
+  int n = audit_num_threads < AUDIT_MAX_THREADS ? audit_num_threads : AUDIT_MAX_THREADS;
+  printf("INFO: Allocation audit after warm-up:\n");
+  for (int i = 0; i < n; ++i)
+  {
+    const audit_thread *t = &audit_threads[i];
+    printf("INFO:   %-18s %8" PRIu64 " allocations %10" PRIu64 " bytes%s\n", t->name, t->allocs, t->bytes,
+           t->trade_path ? " (trade path)" : "");
+    for (int k = 0; k < AUDIT_CALLERS && t->callers[k]; ++k)
+    {
+      Dl_info info;
+      if (dladdr(t->callers[k], &info) && info.dli_fname)
+        printf("INFO:     from %s+%#lx (%s)\n", info.dli_fname,
+               (unsigned long)((char *)t->callers[k] - (char *)info.dli_fbase),
+               info.dli_sname ? info.dli_sname : "?");
+      else
+        printf("INFO:     from %p\n", t->callers[k]);
+    }
+    if (t->trade_path && t->allocs > 0)
+      failed = 1;
+  }
+
+  if (failed)
+  {
+    fprintf(stderr, "ERROR: Allocation audit: the trade path allocated after warm-up "
+                    "(resolve the offsets with addr2line -f -e <object>)\n");
+    return -1;
+  }
+  printf("INFO: Allocation audit passed: the trade path did not allocate\n");
+  return 0;
+}
+
+#endif /* ALLOC_AUDIT */
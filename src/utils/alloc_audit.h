@@ -0,0 +1,64 @@
+/**
+ * @file alloc_audit.h
+ * @brief Steady-state allocation audit declarations
+ *
+ * Built with -DALLOC_AUDIT (`make audit`), the program replaces malloc, calloc, realloc
+ * and free with counting wrappers around glibc's allocator. Threads register themselves
+ * by name. Once the trade path has run ALLOC_AUDIT_WARMUP_MS of trade time, so that every
+ * window has filled once, each allocation is counted against the thread that made it,
+ * along with its first distinct call sites for addr2line. At exit the counts are printed,
+ * and the run fails if a trade-path thread allocated. In a normal build every call below
+ * is an empty inline function.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef ALLOC_AUDIT_H
+#define ALLOC_AUDIT_H
+
+#include "../../include/common.h"
+
+#ifdef ALLOC_AUDIT
+
+/**
+ * @brief Registers the calling thread with the audit.
+ * @param name Thread name used in the report.
+ * @param trade_path Nonzero if the thread must not allocate in the steady state.
+ */
+void alloc_audit_thread_start(const char *name, int trade_path);
+
+/**
+ * @brief Notes a trade handled by the calling thread; ends the warm-up once trade time has
+ * advanced ALLOC_AUDIT_WARMUP_MS past the first one.
+ * @param trade_ts_ms Exchange timestamp of the trade.
+ */
+void alloc_audit_trade(int64_t trade_ts_ms);
+
+/**
+ * @brief Prints the allocations of every registered thread since the warm-up ended.
+ * @return 0 if no trade-path thread allocated, -1 if one did or the warm-up never ended.
+ */
+int alloc_audit_report(void);
+
+#else
+
+static inline void alloc_audit_thread_start(const char *name, int trade_path)
+{
+  (void)name;
+  (void)trade_path;
+}
+
+static inline void alloc_audit_trade(int64_t trade_ts_ms)
+{
+  (void)trade_ts_ms;
+}
+
+static inline int alloc_audit_report(void)
+{
+  return 0;
+}
+
+#endif /* ALLOC_AUDIT */
+
+#endif /* ALLOC_AUDIT_H */
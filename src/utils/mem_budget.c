@@ -0,0 +1,95 @@
+/**
+ * @file mem_budget.c
+ * @brief Memory accounting per subsystem implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "mem_budget.h"
+
+/* Bytes held by each subsystem (updated with relaxed atomics from any thread) */
+static int64_t used_bytes[NUM_MEM_SUBSYSTEMS];
+
+static const char *const subsystem_names[NUM_MEM_SUBSYSTEMS] = {
+  [MEM_QUEUE] = "queue",
+  [MEM_WINDOWS] = "windows",
+  [MEM_HISTORY] = "history",
+  [MEM_CORRELATION] = "correlation",
+  [MEM_ALERTS] = "alerts",
+  [MEM_WRITERS] = "writers",
+  [MEM_IPC] = "ipc",
+};
+
+/**
+ * @brief Records memory allocated (bytes > 0) or released (bytes < 0) by a subsystem.
+ * @details Lock-free; callable from any thread.
+ * @param s Subsystem.
+ * @param bytes Change in bytes.
+ */
+void mem_budget_add(mem_subsystem s, int64_t bytes)
+{
+  __atomic_fetch_add(&used_bytes[s], bytes, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns the memory currently held by a subsystem.
+ * @param s Subsystem.
+ * @return Bytes.
+ */
+int64_t mem_budget_used(mem_subsystem s)
+{
+  return __atomic_load_n(&used_bytes[s], __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns the memory currently held by all subsystems.
+ * @return Bytes.
+ */
+int64_t mem_budget_total(void)
+{
+  int64_t total = 0;
+  for (int s = 0; s < NUM_MEM_SUBSYSTEMS; ++s)
+    total += mem_budget_used((mem_subsystem)s);
+  return total;
+}
+
+/**
+ * @brief Short name of a subsystem, as used in reports and CSV columns.
+ * @param s Subsystem.
+ * @return Name (e.g. "windows").
+ */
+const char *mem_budget_name(mem_subsystem s)
+{
+  return subsystem_names[s];
+}
+
+/**
+ * @brief Prints the per-subsystem breakdown and checks the total against a budget.
+ * @param budget_mb Budget in MB (0 = none).
+ * @return 0 if the total fits, -1 if it exceeds the budget.
+ */
+int mem_budget_enforce(int budget_mb)
+{
+  int64_t total = mem_budget_total();
+
+  printf("INFO: Memory at startup: %.1f MB accounted", total / (1024.0 * 1024.0));
+  if (budget_mb > 0)
+    printf(" of a %d MB budget", budget_mb);
+  printf("\n");
+  for (int s = 0; s < NUM_MEM_SUBSYSTEMS; ++s)
+  {
+    int64_t used = mem_budget_used((mem_subsystem)s);
+    if (used > 0)
+      printf("INFO:   %-12s %8.1f MB (%4.1f%%)\n", subsystem_names[s], used / (1024.0 * 1024.0),
+             100.0 * used / total);
+  }
+
+  if (budget_mb > 0 && total > (int64_t)budget_mb * 1024 * 1024)
+  {
+    fprintf(stderr, "ERROR: Accounted memory (%.1f MB) exceeds the %d MB budget (memory_budget_mb)\n",
+            total / (1024.0 * 1024.0), budget_mb);
+    return -1;
+  }
+  return 0;
+}
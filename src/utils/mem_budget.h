@@ -0,0 +1,55 @@
+/**
+ * @file mem_budget.h
+ * @brief Memory accounting per subsystem declarations
+ *
+ * Every subsystem reports the memory it allocates or maps (and gives back) under its
+ * mem_subsystem, so a process knows its footprint without walking the heap. The total is
+ * checked against the configured budget once startup has allocated everything, before any
+ * thread runs, and exported each minute next to VmRSS in system.csv. Figures are reserved
+ * sizes: a mapping or a pool counts in full even while its pages are untouched.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Records memory allocated (bytes > 0) or released (bytes < 0) by a subsystem.
+ * @details Lock-free; callable from any thread.
+ * @param s Subsystem.
+ * @param bytes Change in bytes.
+ */
+void mem_budget_add(mem_subsystem s, int64_t bytes);
+
+/**
+ * @brief Returns the memory currently held by a subsystem.
+ * @param s Subsystem.
+ * @return Bytes.
+ */
+int64_t mem_budget_used(mem_subsystem s);
+
+/**
+ * @brief Returns the memory currently held by all subsystems.
+ * @return Bytes.
+ */
+int64_t mem_budget_total(void);
+
+/**
+ * @brief Short name of a subsystem, as used in reports and CSV columns.
+ * @param s Subsystem.
+ * @return Name (e.g. "windows").
+ */
+const char *mem_budget_name(mem_subsystem s);
+
+/**
+ * @brief Prints the per-subsystem breakdown and checks the total against a budget.
+ * @param budget_mb Budget in MB (0 = none).
+ * @return 0 if the total fits, -1 if it exceeds the budget.
+ */
+int mem_budget_enforce(int budget_mb);
+
+#endif /* MEM_BUDGET_H */
@@ -0,0 +1,328 @@
+/**
+ * @file runtime_config.c
+ * @brief Runtime configuration with read-copy-update publication implementation
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#include "runtime_config.h"
+
+#define RECLAIM_POLL_US 200 /**< Poll interval while waiting for the slot writer */
+
+/* Published generation (written by the main thread on SIGHUP, read by everyone) */
+static const runtime_config *current_config = NULL;
+static uint64_t published_generation = 0;
+
+/* Generation last observed by the slot writer, 0 while it is idle */
+static uint64_t reader_generation = 0;
+
+/**
+ * @brief Parses a rotation policy name.
+ * @param name Policy name.
+ * @return The policy, or -1 if unknown.
+ */
+static int rotate_policy_from_name(const char *name)
+{
+  if (strcmp(name, "none") == 0)
+    return ROTATE_NONE;
+  if (strcmp(name, "hourly") == 0)
+    return ROTATE_HOURLY;
+  if (strcmp(name, "daily") == 0)
+    return ROTATE_DAILY;
+  if (strcmp(name, "size") == 0)
+    return ROTATE_SIZE;
+  return -1;
+}
+
+/**
+ * @brief Fills a configuration with the compile-time defaults (SYMBOLS and the logging #defines).
+ * @param cfg Pointer to the configuration.
+ */
+void runtime_config_defaults(runtime_config *cfg)
+{
+  memset(cfg, 0, sizeof(*cfg));
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+    snprintf(cfg->symbols[i], SYMBOL_NAME_MAX, "%s", SYMBOLS[i]);
+  cfg->num_symbols = NUM_SYMBOLS;
+  cfg->trade_log_rotate = TRADE_LOG_ROTATE;
+  cfg->latency_log_rotate = LATENCY_LOG_ROTATE;
+  cfg->rotate_max_bytes = LOG_ROTATE_MAX_BYTES;
+  cfg->retain_segments = LOG_RETAIN_SEGMENTS;
+  cfg->fsync_per_write = FSYNC_PER_WRITE;
+  cfg->shutdown_budget_ms = SHUTDOWN_BUDGET_MS;
+  cfg->memory_budget_mb = MEMORY_BUDGET_MB;
+}
+
+/**
+ * @brief Replaces the symbols of a configuration with a list, in order.
+ * @param cfg Pointer to the configuration.
+ * @param list Instrument ids separated by spaces or commas.
+ * @param path Config file path (for messages).
+ * @param line_no Line number (for messages).
+ * @return 0 on success, -1 if the list is empty.
+ */
+static int parse_symbols(runtime_config *cfg, char *list, const char *path, int line_no)
+{
+  runtime_config parsed = *cfg;
+  memset(parsed.symbols, 0, sizeof(parsed.symbols));
+  parsed.num_symbols = 0;
+
+  char *save = NULL;
+  for (char *tok = strtok_r(list, " \t,\r\n", &save); tok; tok = strtok_r(NULL, " \t,\r\n", &save))
+  {
+    if (strlen(tok) >= SYMBOL_NAME_MAX)
+    {
+      fprintf(stderr, "WARNING: %s:%d: symbol '%s' is longer than %d characters\n", path, line_no, tok,
+              SYMBOL_NAME_MAX - 1);
+      continue;
+    }
+    if (runtime_config_symbol_index(&parsed, tok) >= 0)
+      continue; // listed twice
+    if (parsed.num_symbols == NUM_SYMBOLS)
+    {
+      fprintf(stderr, "WARNING: %s:%d: more than %d symbols, ignoring '%s' and the rest\n", path, line_no,
+              NUM_SYMBOLS, tok);
+      break;
+    }
+    snprintf(parsed.symbols[parsed.num_symbols++], SYMBOL_NAME_MAX, "%s", tok);
+  }
+
+  if (parsed.num_symbols == 0)
+  {
+    fprintf(stderr, "WARNING: %s:%d: empty symbol list\n", path, line_no);
+    return -1;
+  }
+  *cfg = parsed;
+  return 0;
+}
+
+/**
+ * @brief Reads a config file over the compile-time defaults.
+ * @details Each non-comment line is `key = value`: `symbols` (instrument ids separated by
+ * spaces or commas, at most NUM_SYMBOLS, placed in slots in file order),
+ * `trade_log_rotate` and `latency_log_rotate` (none, hourly, daily or size),
+ * `log_rotate_max_mb`, `log_retain_segments`, `fsync_per_write`, `shutdown_budget_ms` and
+ * `memory_budget_mb`. Invalid lines are skipped with a warning; keys that are absent keep
+ * their default.
+ * @param path Config file path.
+ * @param required Nonzero if a missing file is an error (explicit --config).
+ * @param cfg Pointer to store the configuration.
+ * @return 1 if the file was read, 0 if it is missing (defaults), -1 on error.
+ */
+int runtime_config_load(const char *path, int required, runtime_config *cfg)
+{
+  runtime_config_defaults(cfg);
+
+  FILE *fp = fopen(path, "r");
+  if (!fp)
+  {
+    if (required || errno != ENOENT)
+    {
+      fprintf(stderr, "ERROR: Failed to open config %s: %s\n", path, strerror(errno));
+      return -1;
+    }
+    return 0;
+  }
+
+  char line[1024];
+  int line_no = 0;
+  while (fgets(line, sizeof(line), fp))
+  {
+    line_no++;
+    char *hash = strchr(line, '#');
+    if (hash)
+      *hash = '\0';
+
+    char key[32];
+    int value_at = 0;
+    if (sscanf(line, " %31[a-z_] = %n", key, &value_at) < 1)
+    {
+      if (strspn(line, " \t\r\n") != strlen(line))
+        fprintf(stderr, "WARNING: %s:%d: expected 'key = value'\n", path, line_no);
+      continue; // blank or comment
+    }
+    if (value_at == 0)
+    {
+      fprintf(stderr, "WARNING: %s:%d: missing '=' after '%s'\n", path, line_no, key);
+      continue;
+    }
+    char *value = line + value_at;
+    value[strcspn(value, "\r\n")] = '\0';
+
+    char word[32];
+    long long number;
+    if (strcmp(key, "symbols") == 0)
+      parse_symbols(cfg, value, path, line_no);
+    else if (strcmp(key, "trade_log_rotate") == 0 || strcmp(key, "latency_log_rotate") == 0)
+    {
+      int policy = sscanf(value, "%31s", word) == 1 ? rotate_policy_from_name(word) : -1;
+      if (policy < 0)
+        fprintf(stderr, "WARNING: %s:%d: %s must be none, hourly, daily or size\n", path, line_no, key);
+      else if (key[0] == 't')
+        cfg->trade_log_rotate = (rotate_policy)policy;
+      else
+        cfg->latency_log_rotate = (rotate_policy)policy;
+    }
+    else if (sscanf(value, "%lld", &number) != 1 || number < 0)
+      fprintf(stderr, "WARNING: %s:%d: %s needs a non-negative number\n", path, line_no, key);
+    else if (strcmp(key, "log_rotate_max_mb") == 0 && number > 0)
+      cfg->rotate_max_bytes = number * 1024 * 1024;
+    else if (strcmp(key, "log_retain_segments") == 0)
+      cfg->retain_segments = (int)number;
+    else if (strcmp(key, "fsync_per_write") == 0)
+      cfg->fsync_per_write = number != 0;
+    else if (strcmp(key, "shutdown_budget_ms") == 0 && number <= INT32_MAX)
+      cfg->shutdown_budget_ms = (int)number;
+    else if (strcmp(key, "memory_budget_mb") == 0 && number <= INT32_MAX)
+      cfg->memory_budget_mb = (int)number;
+    else
+      fprintf(stderr, "WARNING: %s:%d: unknown or invalid key '%s'\n", path, line_no, key);
+  }
+  fclose(fp);
+  return 1;
+}
+
+/**
+ * @brief Plans the move from the current configuration to a newly loaded one in two steps.
+ * @details Symbols present in both keep their slot. `shrunk` is the current slot layout
+ * minus the removed symbols, with the new logging policies; `grown` adds the new symbols
+ * to free slots, preferring slots that were already free so a removed symbol's slot is
+ * only reused when nothing else is left.
+ * @param current Published configuration.
+ * @param wanted Newly loaded configuration (symbols in file order).
+ * @param shrunk Pointer to store the first step.
+ * @param grown Pointer to store the final layout.
+ */
+void runtime_config_plan(const runtime_config *current, const runtime_config *wanted, runtime_config *shrunk,
+                         runtime_config *grown)
+{
+  *shrunk = *wanted;
+  memset(shrunk->symbols, 0, sizeof(shrunk->symbols));
+  shrunk->num_symbols = 0;
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+  {
+    if (current->symbols[i][0] && runtime_config_symbol_index(wanted, current->symbols[i]) >= 0)
+    {
+      memcpy(shrunk->symbols[i], current->symbols[i], SYMBOL_NAME_MAX);
+      shrunk->num_symbols++;
+    }
+  }
+
+  *grown = *shrunk;
+  for (int k = 0; k < NUM_SYMBOLS; ++k)
+  {
+    const char *name = wanted->symbols[k];
+    if (!name[0] || runtime_config_symbol_index(grown, name) >= 0)
+      continue;
+
+    int slot = -1;
+    for (int i = 0; i < NUM_SYMBOLS && slot < 0; ++i)
+      if (!grown->symbols[i][0] && !current->symbols[i][0])
+        slot = i; // free before and after: nothing to drain
+    for (int i = 0; i < NUM_SYMBOLS && slot < 0; ++i)
+      if (!grown->symbols[i][0])
+        slot = i; // a removed symbol's slot, reused after the first step
+    memcpy(grown->symbols[slot], name, SYMBOL_NAME_MAX);
+    grown->num_symbols++;
+  }
+}
+
+/**
+ * @brief Looks up the slot of an instrument.
+ * @param cfg Configuration.
+ * @param name Instrument id.
+ * @return Slot index, or -1 if the instrument is not configured.
+ */
+int runtime_config_symbol_index(const runtime_config *cfg, const char *name)
+{
+  for (int i = 0; i < NUM_SYMBOLS; ++i)
+    if (cfg->symbols[i][0] && strcmp(name, cfg->symbols[i]) == 0)
+      return i;
+  return -1;
+}
+
+/**
+ * @brief Returns the published configuration (one acquire load).
+ * @return Current generation; never NULL after the startup publication.
+ */
+const runtime_config *runtime_config_current(void)
+{
+  return __atomic_load_n(&current_config, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Publishes a copy of a configuration as the next generation.
+ * @param cfg Template (its generation and previous fields are ignored).
+ * @return The published generation.
+ */
+const runtime_config *runtime_config_publish(const runtime_config *cfg)
+{
+  runtime_config *next = malloc(sizeof(*next));
+  if (!next)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate configuration\n");
+    exit(1);
+  }
+  *next = *cfg;
+  next->previous = current_config; // only this thread publishes
+  next->generation = published_generation + 1;
+
+  __atomic_store_n(&current_config, next, __ATOMIC_RELEASE);
+  __atomic_store_n(&published_generation, next->generation, __ATOMIC_SEQ_CST);
+  return next;
+}
+
+/**
+ * @brief Reports a quiescent state of the slot writer: it holds no slot index mapped earlier.
+ * @details Called by the trade processor or shared-memory consumer between trades.
+ */
+void runtime_config_reader_online(void)
+{
+  uint64_t seen;
+  do
+  {
+    /* announce, then check the announcement did not race a publication that already
+     * found this thread idle */
+    seen = __atomic_load_n(&published_generation, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&reader_generation, seen, __ATOMIC_SEQ_CST);
+  } while (__atomic_load_n(&published_generation, __ATOMIC_SEQ_CST) != seen);
+}
+
+/**
+ * @brief Marks the slot writer idle (about to block); it maps no slot until it comes back online.
+ */
+void runtime_config_reader_offline(void)
+{
+  __atomic_store_n(&reader_generation, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Waits until the slot writer has observed the published generation or is idle.
+ */
+void runtime_config_synchronize(void)
+{
+  uint64_t target = __atomic_load_n(&published_generation, __ATOMIC_SEQ_CST);
+  for (;;)
+  {
+    uint64_t seen = __atomic_load_n(&reader_generation, __ATOMIC_SEQ_CST);
+    if (seen == 0 || seen >= target)
+      return;
+    usleep(RECLAIM_POLL_US);
+  }
+}
+
+/**
+ * @brief Frees every generation (at exit, once no thread reads the configuration).
+ */
+void runtime_config_cleanup(void)
+{
+  const runtime_config *cfg = current_config;
+  while (cfg)
+  {
+    const runtime_config *previous = cfg->previous;
+    free((void *)cfg);
+    cfg = previous;
+  }
+  current_config = NULL;
+}
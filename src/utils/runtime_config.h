@@ -0,0 +1,99 @@
+/**
+ * @file runtime_config.h
+ * @brief Runtime configuration with read-copy-update publication declarations
+ *
+ * The symbol list and the logging policies are read from a `key = value` file at startup
+ * and again on SIGHUP. Each version is an immutable runtime_config generation published
+ * with a single atomic pointer store, so readers (the trade path included) only ever load
+ * one pointer. Old generations are kept until exit, which lets any thread hold one for as
+ * long as it likes. Symbol slots need more: the thread that writes into them (trade
+ * processor or shared-memory consumer) reports quiescent states, and a slot is only freed
+ * or reused once that thread has moved past every generation that still mapped it.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include "../../include/common.h"
+
+/**
+ * @brief Fills a configuration with the compile-time defaults (SYMBOLS and the logging #defines).
+ * @param cfg Pointer to the configuration.
+ */
+void runtime_config_defaults(runtime_config *cfg);
+
+/**
+ * @brief Reads a config file over the compile-time defaults.
+ * @details Each non-comment line is `key = value`: `symbols` (instrument ids separated by
+ * spaces or commas, at most NUM_SYMBOLS, placed in slots in file order),
+ * `trade_log_rotate` and `latency_log_rotate` (none, hourly, daily or size),
+ * `log_rotate_max_mb`, `log_retain_segments`, `fsync_per_write`, `shutdown_budget_ms` and
+ * `memory_budget_mb`. Invalid lines are skipped with a warning; keys that are absent keep
+ * their default.
+ * @param path Config file path.
+ * @param required Nonzero if a missing file is an error (explicit --config).
+ * @param cfg Pointer to store the configuration.
+ * @return 1 if the file was read, 0 if it is missing (defaults), -1 on error.
+ */
+int runtime_config_load(const char *path, int required, runtime_config *cfg);
+
+/**
+ * @brief Plans the move from the current configuration to a newly loaded one in two steps.
+ * @details Symbols present in both keep their slot. `shrunk` is the current slot layout
+ * minus the removed symbols, with the new logging policies; `grown` adds the new symbols
+ * to free slots, preferring slots that were already free so a removed symbol's slot is
+ * only reused when nothing else is left.
+ * @param current Published configuration.
+ * @param wanted Newly loaded configuration (symbols in file order).
+ * @param shrunk Pointer to store the first step.
+ * @param grown Pointer to store the final layout.
+ */
+void runtime_config_plan(const runtime_config *current, const runtime_config *wanted, runtime_config *shrunk,
+                         runtime_config *grown);
+
+/**
+ * @brief Looks up the slot of an instrument.
+ * @param cfg Configuration.
+ * @param name Instrument id.
+ * @return Slot index, or -1 if the instrument is not configured.
+ */
+int runtime_config_symbol_index(const runtime_config *cfg, const char *name);
+
+/**
+ * @brief Returns the published configuration (one acquire load).
+ * @return Current generation; never NULL after the startup publication.
+ */
+const runtime_config *runtime_config_current(void);
+
+/**
+ * @brief Publishes a copy of a configuration as the next generation.
+ * @param cfg Template (its generation and previous fields are ignored).
+ * @return The published generation.
+ */
+const runtime_config *runtime_config_publish(const runtime_config *cfg);
+
+/**
+ * @brief Reports a quiescent state of the slot writer: it holds no slot index mapped earlier.
+ * @details Called by the trade processor or shared-memory consumer between trades.
+ */
+void runtime_config_reader_online(void);
+
+/**
+ * @brief Marks the slot writer idle (about to block); it maps no slot until it comes back online.
+ */
+void runtime_config_reader_offline(void);
+
+/**
+ * @brief Waits until the slot writer has observed the published generation or is idle.
+ */
+void runtime_config_synchronize(void);
+
+/**
+ * @brief Frees every generation (at exit, once no thread reads the configuration).
+ */
+void runtime_config_cleanup(void);
+
+#endif /* RUNTIME_CONFIG_H */
@@ -0,0 +1,110 @@
+/**
+ * @file audit_feed.c
+ * @brief Generates the replay input of the steady-state allocation audit (`make audit`).
+ *
+ * Usage: audit_feed [-m MINUTES] [-b BURST] > feed.jsonl
+ *
+ * Writes OKX trade messages as JSONL: MINUTES of trade time (default 20, past the audit's
+ * 15-minute warm-up) at 2 trades per second for each default symbol, on a 0.01 tick so
+ * prices repeat. Then BTC-USDT gets a burst of BURST trades (default 20000) 1 ms apart at
+ * strictly falling, distinct prices. The burst takes its window to a peak well above
+ * anything reached during the warm-up: every trade stays in the max deque and adds a
+ * quantile key, and the window pulls fresh chunks from the pool. Two quiet minutes follow
+ * so the minute workers run on the grown window. If the trade path allocates while growing,
+ * the audit fails on this input.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_SYMBOLS 8
+#define START_TS_MS 1759276800000LL /**< 2025-10-01T00:00Z */
+#define QUIET_INTERVAL_MS 500       /**< per symbol: 2 trades per second */
+#define COOLDOWN_MS (2 * 60 * 1000LL)
+
+static const char *const symbols[NUM_SYMBOLS] = {"BTC-USDT", "ADA-USDT", "ETH-USDT", "DOGE-USDT",
+                                                 "XRP-USDT", "SOL-USDT", "LTC-USDT", "BNB-USDT"};
+
+static uint64_t trade_id;
+
+/**
+ * @brief Writes one trade as an OKX trades-channel message.
+ * @param symbol Instrument id.
+ * @param ts_ms Exchange timestamp.
+ * @param price Price.
+ * @param size Size.
+ */
+static void emit_trade(const char *symbol, int64_t ts_ms, double price, double size)
+{
+  ++trade_id;
+  printf("{\"arg\":{\"channel\":\"trades\",\"instId\":\"%s\"},\"data\":[{\"instId\":\"%s\",\"tradeId\":\"%" PRIu64
+         "\",\"px\":\"%.2f\",\"sz\":\"%.4f\",\"side\":\"%s\",\"ts\":\"%" PRId64 "\",\"count\":\"1\",\"source\":\"0\","
+         "\"seqId\":%" PRIu64 "}]}\n",
+         symbol, symbol, trade_id, price, size, trade_id % 2 ? "buy" : "sell", ts_ms, trade_id);
+}
+
+/**
+ * @brief Writes a quiet stretch: every symbol trades every QUIET_INTERVAL_MS on a random walk.
+ * @param from_ms First timestamp.
+ * @param to_ms End timestamp (exclusive).
+ * @param prices Current price of each symbol (updated).
+ */
+static void emit_quiet(int64_t from_ms, int64_t to_ms, double *prices)
+{
+  for (int64_t ts = from_ms; ts < to_ms; ts += QUIET_INTERVAL_MS)
+    for (int s = 0; s < NUM_SYMBOLS; ++s)
+    {
+      prices[s] = round(prices[s] * (1.0 + 2e-4 * (rand() / (double)RAND_MAX - 0.5)) * 100.0) / 100.0;
+      emit_trade(symbols[s], ts + s, prices[s], 0.01 + (rand() % 1000) / 100.0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+  int minutes = 20;
+  long burst = 20000;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+      minutes = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+      burst = atol(argv[++i]);
+    else
+    {
+      fprintf(stderr, "Usage: %s [-m MINUTES] [-b BURST] > feed.jsonl\n", argv[0]);
+      return 1;
+    }
+  }
+
+  double prices[NUM_SYMBOLS];
+  for (int s = 0; s < NUM_SYMBOLS; ++s)
+    prices[s] = 100.0 * (s + 1);
+  srand(42);
+
+  int64_t ts = START_TS_MS;
+  emit_quiet(ts, ts + minutes * 60 * 1000LL, prices);
+  ts += minutes * 60 * 1000LL;
+
+  // Burst on the first symbol: distinct prices one tick apart, each below the last
+  double price = prices[0] + burst * 0.01;
+  for (long i = 0; i < burst; ++i)
+  {
+    emit_trade(symbols[0], ts + i, price, 0.001 * (1 + i % 997));
+    price -= 0.01;
+  }
+  prices[0] = price;
+  ts += burst;
+
+  emit_quiet(ts, ts + COOLDOWN_MS, prices);
+  return 0;
+}
@@ -0,0 +1,590 @@
+/**
+ * @file corr_bench.c
+ * @brief Measures the pruned lagged correlation search against the exhaustive one.
+ *
+ * Usage: corr_bench [-s SYMBOLS] [-t TICKS] [-w WINDOW] [-d VWAP_DIR] [-k]
+ *
+ * Builds a synthetic universe (default 256 symbols) of minute VWAP paths driven by a market
+ * factor, sector factors and idiosyncratic noise, with some symbols following their sector
+ * a few minutes late, or loads the recorded per-symbol VWAP CSVs of VWAP_DIR (every tick
+ * they cover unless -t is given). The paths are laid out time-major, one row of all symbols
+ * per minute, like the VWAP matrix. At every tick each symbol's newest window is matched
+ * against every symbol and lag four ways: the original per-pair search (pearson_correlation
+ * on copied windows), the vectorized exhaustive search, the batched exhaustive search (one
+ * blocked matrix product per lag for all sources), and the pruned search. Reports the
+ * time of each, the share of exact evaluations skipped, and any mismatch with the original.
+ * The single-precision search is timed too (including its own preparation) and checked
+ * against the original for the largest absolute error of the best coefficient and the share
+ * of sources whose best match (target and lag) is unchanged.
+ * With -k, prints instead a table of ns per correlation of the cross-sum kernels for several
+ * window lengths: the plain loop, the register-blocked generic kernel and the kernel
+ * corr_universe_init selects (specialized where one exists), checking they agree bit for bit.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+
+#include "../src/compute/corr_gemm.h"
+#include "../src/compute/corr_search.h"
+
+#define WINDOW_LEN 8     /**< MOVING_AVG_POINTS (default -w) */
+#define MAX_WINDOW 256   /**< largest -w */
+#define MAX_LAG 60       /**< MAX_LAG_MINUTES */
+#define KERNEL_EVALS 1e7 /**< correlations timed per kernel table run */
+#define KERNEL_TRIALS 3  /**< runs per kernel table cell, the fastest is reported */
+#define NUM_SECTORS 16
+#define MAX_FILES 1024 /**< CSVs loaded from a VWAP directory */
+
+static int window_len = WINDOW_LEN; /**< -w */
+
+/**
+ * @brief Draws a standard normal variate (Box-Muller).
+ * @return The variate.
+ */
+static double randn(void)
+{
+  double u1 = (rand() + 1.0) / (RAND_MAX + 2.0), u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * @brief Generates minute VWAP paths for a synthetic universe.
+ * @param num_symbols Number of symbols.
+ * @param minutes Points per path.
+ * @param out Output, [minute][symbol].
+ */
+static void synth_universe(int num_symbols, int minutes, double *out)
+{
+  int lead = MAX_LAG; // factor history before the first minute, so lagged followers have data
+  int total = minutes + lead;
+  double *market = malloc(total * sizeof(double));
+  double *sector = malloc((size_t)NUM_SECTORS * total * sizeof(double));
+
+  srand(42);
+  market[0] = 0.0;
+  for (int t = 1; t < total; ++t)
+    market[t] = market[t - 1] + 1e-3 * randn();
+  for (int s = 0; s < NUM_SECTORS; ++s)
+  {
+    sector[s * total] = 0.0;
+    for (int t = 1; t < total; ++t)
+      sector[s * total + t] = sector[s * total + t - 1] + 1e-3 * randn();
+  }
+
+  for (int i = 0; i < num_symbols; ++i)
+  {
+    int s = i % NUM_SECTORS;
+    int delay = (i / NUM_SECTORS) % 4 == 3 ? 1 + rand() % 20 : 0; // a quarter follow late
+    double beta = 0.5 + rand() / (double)RAND_MAX, idio = 0.0;
+    double base = 1.0 + 1000.0 * rand() / (double)RAND_MAX;
+    for (int t = 0; t < minutes; ++t)
+    {
+      int src_t = lead + t - delay;
+      idio += 8e-4 * randn();
+      out[(size_t)t * num_symbols + i] = base * exp(beta * market[src_t] + sector[s * total + src_t] + idio);
+    }
+  }
+
+  free(market);
+  free(sector);
+}
+
+/**
+ * @brief Loads the VWAP column of every CSV in a directory, truncated to the shortest file.
+ * @param dir Directory of `<SYMBOL>.csv` files (timestamp_iso,vwap,...).
+ * @param num_symbols Pointer to store the number of files loaded.
+ * @param minutes Pointer to store the points per path.
+ * @return Paths, [minute][symbol], or NULL on error.
+ */
+static double *load_vwap_dir(const char *dir, int *num_symbols, int *minutes)
+{
+  DIR *d = opendir(dir);
+  if (!d)
+  {
+    fprintf(stderr, "ERROR: Failed to open %s\n", dir);
+    return NULL;
+  }
+
+  double *rows[MAX_FILES];
+  int lens[MAX_FILES], count = 0, shortest = 0;
+  struct dirent *e;
+  while ((e = readdir(d)) && count < MAX_FILES)
+  {
+    size_t name_len = strlen(e->d_name);
+    if (name_len < 5 || strcmp(e->d_name + name_len - 4, ".csv") != 0)
+      continue;
+
+    char path[4096], line[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+      continue;
+
+    int n = 0, cap = 4096;
+    double *row = malloc(cap * sizeof(double));
+    while (row && fgets(line, sizeof(line), fp))
+    {
+      char *comma = strchr(line, ',');
+      if (!comma || sscanf(comma + 1, "%lf", &row[n]) != 1)
+        continue; // header
+      if (++n == cap)
+      {
+        double *grown = realloc(row, (cap *= 2) * sizeof(double));
+        if (!grown)
+          free(row);
+        row = grown;
+      }
+    }
+    fclose(fp);
+
+    if (row && n > 0)
+    {
+      rows[count] = row;
+      lens[count] = n;
+      shortest = count == 0 || n < shortest ? n : shortest;
+      count++;
+    }
+    else
+      free(row);
+  }
+  closedir(d);
+
+  double *paths = count ? malloc((size_t)count * shortest * sizeof(double)) : NULL;
+  for (int i = 0; i < count; ++i)
+  {
+    for (int t = 0; paths && t < shortest; ++t) // keep the most recent `shortest` minutes of each file
+      paths[(size_t)t * count + i] = rows[i][lens[i] - shortest + t];
+    free(rows[i]);
+  }
+
+  *num_symbols = count;
+  *minutes = shortest;
+  return paths;
+}
+
+/**
+ * @brief The original search: every target, every lag, pearson_correlation on copied windows.
+ * @param paths Time-major paths.
+ * @param num_symbols Symbols per row.
+ * @param first_row Oldest row of the history at this tick.
+ * @param rows Rows in the history.
+ * @param minute_ts_ms Row timestamps (indexed like `paths` rows).
+ * @param src Source symbol.
+ * @param out Pointer to store the best match.
+ */
+static void reference_best(const double *paths, int num_symbols, int first_row, int rows, const int64_t *minute_ts_ms,
+                           int src, corr_match *out)
+{
+  double x[MAX_WINDOW], y[MAX_WINDOW];
+  for (int k = 0; k < window_len; ++k)
+    x[k] = paths[(size_t)(first_row + rows - window_len + k) * num_symbols + src];
+
+  int found = 0;
+  out->corr = NAN;
+  out->target = -1;
+  out->minute_ts_ms = 0;
+  for (int j = 0; j < num_symbols; ++j)
+  {
+    int min_lag = j == src ? window_len : 0;
+    int max_lag = rows - window_len < MAX_LAG ? rows - window_len : MAX_LAG;
+    for (int lag = min_lag; lag <= max_lag; ++lag)
+    {
+      int start = first_row + rows - window_len - lag;
+      for (int k = 0; k < window_len; ++k)
+        y[k] = paths[(size_t)(start + k) * num_symbols + j];
+      double c = pearson_correlation(x, y, window_len);
+      if (!isnan(c) && (!found || fabs(c) > fabs(out->corr)))
+      {
+        out->corr = c;
+        out->target = j;
+        out->minute_ts_ms = minute_ts_ms[start + window_len - 1];
+        found = 1;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Recomputes a match's coefficient with two-pass, long double arithmetic.
+ * @param paths Time-major paths.
+ * @param num_symbols Symbols per row.
+ * @param src_end Row of the source window's last point.
+ * @param m Match (its minute_ts_ms is a row index times 60000 here).
+ * @param src Source symbol.
+ * @return The coefficient.
+ */
+static double accurate_corr(const double *paths, int num_symbols, int src_end, const corr_match *m, int src)
+{
+  int tgt_end = (int)(m->minute_ts_ms / 60000);
+  long double mean_x = 0, mean_y = 0, sxy = 0, sxx = 0, syy = 0;
+  for (int k = 0; k < window_len; ++k)
+  {
+    mean_x += paths[(size_t)(src_end - k) * num_symbols + src];
+    mean_y += paths[(size_t)(tgt_end - k) * num_symbols + m->target];
+  }
+  mean_x /= window_len;
+  mean_y /= window_len;
+  for (int k = 0; k < window_len; ++k)
+  {
+    long double dx = paths[(size_t)(src_end - k) * num_symbols + src] - mean_x;
+    long double dy = paths[(size_t)(tgt_end - k) * num_symbols + m->target] - mean_y;
+    sxy += dx * dy;
+    sxx += dx * dx;
+    syy += dy * dy;
+  }
+  return (double)(sxy / sqrtl(sxx * syy));
+}
+
+/**
+ * @brief Tells whether two matches are identical (coefficients compared bit for bit).
+ * @param a First match.
+ * @param b Second match.
+ * @return 1 if identical.
+ */
+static int same_match(const corr_match *a, const corr_match *b)
+{
+  return a->target == b->target && a->minute_ts_ms == b->minute_ts_ms &&
+         (a->corr == b->corr || (isnan(a->corr) && isnan(b->corr)));
+}
+
+/**
+ * @brief Returns the elapsed nanoseconds between two timestamps.
+ * @param a Start.
+ * @param b End.
+ * @return Nanoseconds.
+ */
+static double elapsed_ns(const struct timespec *a, const struct timespec *b)
+{
+  return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+/**
+ * @brief The cross sums as computed before the kernels: one lag, every target, plain loops.
+ * @param x Source window.
+ * @param y First row of the target windows.
+ * @param n Window length.
+ * @param w Symbols per row.
+ * @param sum_xy Output, one cross sum per target.
+ */
+static void plain_cross_sums(const double *x, const double *y, int n, int w, double *sum_xy)
+{
+  for (int j = 0; j < w; ++j)
+    sum_xy[j] = 0.0;
+  for (int k = 0; k < n; ++k)
+  {
+    const double *row = &y[(size_t)k * w];
+    for (int j = 0; j < w; ++j)
+      sum_xy[j] += x[k] * row[j];
+  }
+}
+
+/**
+ * @brief Times a cross-sum kernel over every lag of a universe.
+ * @param fn Kernel.
+ * @param paths Time-major paths with at least n + MAX_LAG rows.
+ * @param w Symbols per row.
+ * @param n Window length.
+ * @param sum_xy Output of the last call (w values per lag, MAX_LAG + 1 lags).
+ * @return Nanoseconds per correlation (best of KERNEL_TRIALS runs).
+ */
+static double time_cross_sums(corr_cross_sums_fn fn, const double *paths, int w, int n, double *sum_xy)
+{
+  const double *x = &paths[(size_t)MAX_LAG * w]; // the newest window of symbol 0, as a column
+  double xs[MAX_WINDOW];
+  for (int k = 0; k < n; ++k)
+    xs[k] = x[(size_t)k * w];
+
+  int reps = (int)(KERNEL_EVALS / ((double)(MAX_LAG + 1) * w)) + 1;
+  double best_ns = INFINITY;
+  for (int trial = 0; trial < KERNEL_TRIALS; ++trial)
+  {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < reps; ++r)
+      for (int lag = 0; lag <= MAX_LAG; ++lag)
+        fn(xs, &paths[(size_t)(MAX_LAG - lag) * w], n, w, &sum_xy[(size_t)lag * w]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (elapsed_ns(&t0, &t1) < best_ns)
+      best_ns = elapsed_ns(&t0, &t1);
+  }
+  return best_ns / ((double)reps * (MAX_LAG + 1) * w);
+}
+
+/**
+ * @brief Times a single-candidate kernel over every target and lag of a universe.
+ * @param fn Kernel.
+ * @param paths Time-major paths with at least n + MAX_LAG rows.
+ * @param w Symbols per row.
+ * @param n Window length.
+ * @param sum_xy Output (w values per lag, MAX_LAG + 1 lags).
+ * @return Nanoseconds per correlation (best of KERNEL_TRIALS runs).
+ */
+static double time_dot(corr_dot_fn fn, const double *paths, int w, int n, double *sum_xy)
+{
+  double xs[MAX_WINDOW];
+  for (int k = 0; k < n; ++k)
+    xs[k] = paths[(size_t)(MAX_LAG + k) * w];
+
+  int reps = (int)(KERNEL_EVALS / ((double)(MAX_LAG + 1) * w)) + 1;
+  double best_ns = INFINITY;
+  for (int trial = 0; trial < KERNEL_TRIALS; ++trial)
+  {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < reps; ++r)
+      for (int lag = 0; lag <= MAX_LAG; ++lag)
+        for (int j = 0; j < w; ++j)
+          sum_xy[(size_t)lag * w + j] = fn(xs, &paths[(size_t)(MAX_LAG - lag) * w + j], n, w);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (elapsed_ns(&t0, &t1) < best_ns)
+      best_ns = elapsed_ns(&t0, &t1);
+  }
+  return best_ns / ((double)reps * (MAX_LAG + 1) * w);
+}
+
+/**
+ * @brief Prints ns per correlation of the kernels for several window lengths.
+ * @param w Symbols per row.
+ * @return Number of kernels whose sums differ from the plain loop.
+ */
+static int kernel_table(int w)
+{
+  static const int lengths[] = {8, 12, 16, 24, 32, 64, 128};
+  int num_lengths = sizeof(lengths) / sizeof(lengths[0]);
+  int rows = MAX_WINDOW + MAX_LAG;
+  size_t cells = (size_t)(MAX_LAG + 1) * w;
+  double *paths = malloc((size_t)rows * w * sizeof(double));
+  double *expected = malloc(cells * sizeof(double)), *got = malloc(cells * sizeof(double));
+  if (!paths || !expected || !got)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate %d symbols\n", w);
+    return 1;
+  }
+  synth_universe(w, rows, paths);
+
+  int mismatches = 0;
+  printf("Kernels, %d symbols, lags 0..%d: ns per correlation (cross sums only)\n", w, MAX_LAG);
+  printf("window  plain loop  blocked  selected  | one candidate: generic  selected\n");
+  for (int i = 0; i < num_lengths; ++i)
+  {
+    int n = lengths[i];
+    corr_kernels generic, selected;
+    corr_kernels_select(&generic, n, 0);
+    corr_kernels_select(&selected, n, 1);
+
+    double plain_ns = time_cross_sums(plain_cross_sums, paths, w, n, expected);
+    double blocked_ns = time_cross_sums(generic.cross_sums, paths, w, n, got);
+    mismatches += memcmp(expected, got, cells * sizeof(double)) != 0;
+    double selected_ns = time_cross_sums(selected.cross_sums, paths, w, n, got);
+    mismatches += memcmp(expected, got, cells * sizeof(double)) != 0;
+    double dot_ns = time_dot(generic.dot, paths, w, n, got);
+    mismatches += memcmp(expected, got, cells * sizeof(double)) != 0;
+    double dot_selected_ns = time_dot(selected.dot, paths, w, n, got);
+    mismatches += memcmp(expected, got, cells * sizeof(double)) != 0;
+
+    printf("%6d  %10.2f  %7.2f  %8.2f%s |                %7.2f  %8.2f\n", n, plain_ns, blocked_ns, selected_ns,
+           selected.specialized ? "*" : " ", dot_ns, dot_selected_ns);
+  }
+  printf("(* specialized for this length; %s)\n",
+         mismatches ? "SUMS DIFFER from the plain loop" : "all sums bit-identical to the plain loop");
+
+  free(paths);
+  free(expected);
+  free(got);
+  return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+  int num_symbols = 256, ticks = 60, ticks_given = 0, kernels = 0;
+  const char *vwap_dir = NULL;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+      num_symbols = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+    {
+      ticks = atoi(argv[++i]);
+      ticks_given = 1;
+    }
+    else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+      window_len = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+      vwap_dir = argv[++i];
+    else if (strcmp(argv[i], "-k") == 0)
+      kernels = 1;
+    else
+    {
+      fprintf(stderr, "Usage: %s [-s SYMBOLS] [-t TICKS] [-w WINDOW] [-d VWAP_DIR] [-k]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (num_symbols < 1 || ticks < 1)
+  {
+    fprintf(stderr, "ERROR: SYMBOLS and TICKS must be positive\n");
+    return 1;
+  }
+  if (window_len < 2 || window_len > MAX_WINDOW)
+  {
+    fprintf(stderr, "ERROR: WINDOW must be between 2 and %d\n", MAX_WINDOW);
+    return 1;
+  }
+  if (kernels)
+    return kernel_table(num_symbols) ? 2 : 0;
+
+  int points = window_len + MAX_LAG;
+  int minutes = points + ticks - 1;
+  double *paths;
+  if (vwap_dir)
+  {
+    int available;
+    paths = load_vwap_dir(vwap_dir, &num_symbols, &available);
+    if (!paths || available < points)
+    {
+      fprintf(stderr, "ERROR: Need at least %d minutes of VWAPs in %s\n", points, vwap_dir);
+      return 1;
+    }
+    if (!ticks_given || ticks > available - points + 1)
+      ticks = available - points + 1;
+    minutes = available;
+  }
+  else
+    paths = malloc((size_t)num_symbols * minutes * sizeof(double));
+
+  int64_t *minute_ts_ms = malloc(minutes * sizeof(int64_t));
+  corr_match *reference = malloc(num_symbols * sizeof(corr_match));
+  corr_match *batched = malloc(num_symbols * sizeof(corr_match));
+  corr_match *single = malloc(num_symbols * sizeof(corr_match));
+  corr_universe universe, universe_f32;
+  if (!paths || !minute_ts_ms || !reference || !batched || !single ||
+      corr_universe_init(&universe, window_len, MAX_LAG, num_symbols) < 0 ||
+      corr_universe_init(&universe_f32, window_len, MAX_LAG, num_symbols) < 0)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate %d symbols\n", num_symbols);
+    return 1;
+  }
+  if (!vwap_dir)
+    synth_universe(num_symbols, minutes, paths);
+  for (int t = 0; t < minutes; ++t)
+    minute_ts_ms[t] = (int64_t)t * 60000;
+
+  corr_search_stats exhaustive_stats = {0, 0}, batched_stats = {0, 0}, pruned_stats = {0, 0};
+  double reference_ns = 0, prepare_ns = 0, exhaustive_ns = 0, batched_ns = 0, pruned_ns = 0, single_ns = 0;
+  uint64_t matches = 0, mismatches = 0, single_same = 0;
+  double single_max_error = 0.0, double_max_error = 0.0, single_exact_error = 0.0;
+  universe_f32.single_precision = 1;
+  struct timespec t0, t1;
+
+  for (int tick = 0; tick < ticks; ++tick)
+  {
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < num_symbols; ++i)
+      reference_best(paths, num_symbols, tick, points, minute_ts_ms, i, &reference[i]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    reference_ns += elapsed_ns(&t0, &t1);
+
+    /* the history at this tick: a view of the last `points` rows */
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    universe.rows = points;
+    universe.vwap = &paths[(size_t)tick * num_symbols];
+    universe.minute_ts_ms = &minute_ts_ms[tick];
+    corr_universe_prepare(&universe);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    prepare_ns += elapsed_ns(&t0, &t1);
+
+    for (int prune = 0; prune <= 1; ++prune)
+    {
+      clock_gettime(CLOCK_MONOTONIC, &t0);
+      for (int i = 0; i < num_symbols; ++i)
+      {
+        corr_match m;
+        corr_search_best(&universe, i, prune, &m, prune ? &pruned_stats : &exhaustive_stats);
+        if (same_match(&m, &reference[i]))
+          matches++;
+        else
+          mismatches++;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      *(prune ? &pruned_ns : &exhaustive_ns) += elapsed_ns(&t0, &t1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    corr_search_all(&universe, 0, batched, &batched_stats);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    batched_ns += elapsed_ns(&t0, &t1);
+    for (int i = 0; i < num_symbols; ++i)
+    {
+      if (same_match(&batched[i], &reference[i]))
+        matches++;
+      else
+        mismatches++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    universe_f32.rows = points;
+    universe_f32.vwap = universe.vwap;
+    universe_f32.minute_ts_ms = universe.minute_ts_ms;
+    corr_universe_prepare(&universe_f32);
+    corr_search_all(&universe_f32, 0, single, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    single_ns += elapsed_ns(&t0, &t1);
+    for (int i = 0; i < num_symbols; ++i)
+    {
+      if (single[i].target == reference[i].target && single[i].minute_ts_ms == reference[i].minute_ts_ms)
+        single_same++;
+      if (reference[i].target >= 0)
+      {
+        double exact = accurate_corr(paths, num_symbols, tick + points - 1, &reference[i], i);
+        if (fabs(reference[i].corr - exact) > double_max_error)
+          double_max_error = fabs(reference[i].corr - exact);
+        if (single[i].target == reference[i].target && single[i].minute_ts_ms == reference[i].minute_ts_ms &&
+            fabs(single[i].corr - exact) > single_exact_error)
+          single_exact_error = fabs(single[i].corr - exact);
+      }
+      double error = isnan(single[i].corr) != isnan(reference[i].corr) ? INFINITY
+                                                                         : fabs(single[i].corr - reference[i].corr);
+      if (error > single_max_error) // false when both are NAN
+        single_max_error = error;
+    }
+  }
+
+  printf("Universe: %d symbols, %d ticks, window %d, lags 0..%d (%" PRIu64 " candidates per tick)\n",
+         num_symbols, ticks, window_len, MAX_LAG, pruned_stats.candidates / ticks);
+  printf("Per-pair reference   : %9.3f ms/tick\n", reference_ns / ticks / 1e6);
+  printf("Shared window sums   : %9.3f ms/tick (sums and screening signatures, used by both below)\n",
+         prepare_ns / ticks / 1e6);
+  printf("Exhaustive, all lanes: %9.3f ms/tick, %" PRIu64 " exact evaluations\n", exhaustive_ns / ticks / 1e6,
+         exhaustive_stats.exact);
+  printf("Batched GEMM (%s): %9.3f ms/tick, %" PRIu64 " exact evaluations\n", corr_gemm_backend(),
+         batched_ns / ticks / 1e6, batched_stats.exact);
+  printf("Pruned               : %9.3f ms/tick, %" PRIu64 " exact evaluations (%.1f%% pruned)\n",
+         pruned_ns / ticks / 1e6, pruned_stats.exact, 100.0 * (1.0 - (double)pruned_stats.exact / pruned_stats.candidates));
+  printf("Single precision     : %9.3f ms/tick (own window sums included), max |error| of the best "
+         "coefficient %.2e, same best match for %.2f%% of sources\n",
+         single_ns / ticks / 1e6, single_max_error, 100.0 * single_same / ((double)ticks * num_symbols));
+  printf("                       against two-pass long double: double path %.2e, single precision %.2e\n",
+         double_max_error, single_exact_error);
+  printf("Exactness            : %" PRIu64 "/%" PRIu64 " best matches identical to the per-pair search\n", matches,
+         matches + mismatches);
+
+  corr_universe_cleanup(&universe);
+  corr_universe_cleanup(&universe_f32);
+  free(reference);
+  free(batched);
+  free(single);
+  free(paths);
+  free(minute_ts_ms);
+  return mismatches ? 2 : 0;
+}
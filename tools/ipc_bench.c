@@ -0,0 +1,380 @@
+/**
+ * @file ipc_bench.c
+ * @brief Compares the in-process trade queue with the shared-memory channel to a second process.
+ *
+ * Usage: ipc_bench [-n TRADES] [-r RATE]
+ *
+ * In-process: a producer thread hands 1 KB raw trade messages to a consumer thread through
+ * a mutex/condition-variable ring, as the WebSocket thread and the trade processor do.
+ * Shared memory: the producer pushes parsed trades into the SPSC ring of shm_channel and a
+ * forked consumer process pops them, as the ingest and analytics roles do.
+ * Without -r the producer runs flat out (waiting for space instead of dropping) and the
+ * throughput is reported; with -r it sends RATE trades per second, drops on a full ring
+ * like the real producer, and the consumer reports the hand-over latency.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/data/shm_channel.h"
+
+#define QUEUE_SIZE 1024    /**< RAW_TRADE_QUEUE_SIZE */
+#define RING_SIZE 65536    /**< SHM_TRADE_RING_SIZE */
+#define WAIT_TIMEOUT_MS 100
+#define CHANNEL_NAME "/okx-trader-ipc-bench"
+
+/**
+ * @brief The in-process queue element: same size and layout as raw_trade_message.
+ */
+typedef struct
+{
+  int symbol_index;
+  int64_t exchange_ts_ms;
+  double price;
+  double size;
+  int side;
+  char raw_json[1024];
+  int64_t receive_ts_ms;
+} bench_message;
+
+/**
+ * @brief Mutex/condition-variable ring as in queue.c (waits for space instead of dropping when paced off).
+ */
+typedef struct
+{
+  bench_message *buffer;
+  uint32_t capacity, head_idx, tail_idx;
+  int done;
+  pthread_mutex_t lock;
+  pthread_cond_t cond_not_empty, cond_not_full;
+} bench_queue;
+
+/**
+ * @brief Consumer-side results.
+ */
+typedef struct
+{
+  uint64_t received;
+  double checksum;
+  double latency_sum_us;
+  double latency_max_us;
+} bench_result;
+
+static bench_queue queue;
+static bench_result queue_result;
+static uint64_t trades = 2000000;
+static double rate = 0.0;
+
+/**
+ * @brief Monotonic time in nanoseconds (comparable across processes).
+ * @return Nanoseconds.
+ */
+static int64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Sleeps until an absolute monotonic time.
+ * @param deadline_ns Wake-up time.
+ */
+static void sleep_until(int64_t deadline_ns)
+{
+  struct timespec ts = {(time_t)(deadline_ns / 1000000000LL), (long)(deadline_ns % 1000000000LL)};
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+/**
+ * @brief Records one received trade.
+ * @param r Results.
+ * @param price Trade price.
+ * @param sent_ns Producer timestamp.
+ */
+static void record(bench_result *r, double price, int64_t sent_ns)
+{
+  r->received++;
+  r->checksum += price;
+  if (rate > 0.0)
+  {
+    double us = (now_ns() - sent_ns) / 1000.0;
+    r->latency_sum_us += us;
+    if (us > r->latency_max_us)
+      r->latency_max_us = us;
+  }
+}
+
+/**
+ * @brief Price of the i-th synthetic trade.
+ * @param i Trade number.
+ * @return Price.
+ */
+static double trade_price(uint64_t i)
+{
+  return 100.0 + (double)(i % 1000) * 0.01;
+}
+
+/**
+ * @brief In-process consumer thread.
+ * @param arg Unused.
+ * @return NULL.
+ */
+static void *queue_consumer(void *arg)
+{
+  (void)arg;
+  bench_message msg;
+  for (;;)
+  {
+    pthread_mutex_lock(&queue.lock);
+    while (queue.head_idx == queue.tail_idx && !queue.done)
+      pthread_cond_wait(&queue.cond_not_empty, &queue.lock);
+    if (queue.head_idx == queue.tail_idx)
+    {
+      pthread_mutex_unlock(&queue.lock);
+      break;
+    }
+    msg = queue.buffer[queue.head_idx];
+    queue.head_idx = (queue.head_idx + 1) % queue.capacity;
+    pthread_cond_signal(&queue.cond_not_full);
+    pthread_mutex_unlock(&queue.lock);
+
+    record(&queue_result, msg.price, msg.receive_ts_ms);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Runs the in-process queue benchmark.
+ * @param dropped Pointer to store the dropped trades.
+ * @return Elapsed seconds.
+ */
+static double run_queue(uint64_t *dropped)
+{
+  queue.buffer = calloc(QUEUE_SIZE, sizeof(bench_message));
+  if (!queue.buffer)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate the queue\n");
+    exit(1);
+  }
+  queue.capacity = QUEUE_SIZE;
+  pthread_mutex_init(&queue.lock, NULL);
+  pthread_cond_init(&queue.cond_not_empty, NULL);
+  pthread_cond_init(&queue.cond_not_full, NULL);
+
+  pthread_t consumer;
+  pthread_create(&consumer, NULL, queue_consumer, NULL);
+
+  bench_message msg;
+  memset(&msg, 0, sizeof(msg));
+  snprintf(msg.raw_json, sizeof(msg.raw_json), "{\"arg\":{\"channel\":\"trades\",\"instId\":\"BTC-USDT\"}}");
+  *dropped = 0;
+  int64_t start = now_ns();
+  for (uint64_t i = 0; i < trades; ++i)
+  {
+    if (rate > 0.0)
+      sleep_until(start + (int64_t)(i * 1e9 / rate));
+    msg.price = trade_price(i);
+    msg.receive_ts_ms = now_ns();
+
+    pthread_mutex_lock(&queue.lock);
+    while ((queue.tail_idx + 1) % queue.capacity == queue.head_idx)
+    {
+      if (rate > 0.0)
+      {
+        queue.head_idx = (queue.head_idx + 1) % queue.capacity; // drop oldest, as queue.c does
+        (*dropped)++;
+      }
+      else
+        pthread_cond_wait(&queue.cond_not_full, &queue.lock);
+    }
+    queue.buffer[queue.tail_idx] = msg;
+    queue.tail_idx = (queue.tail_idx + 1) % queue.capacity;
+    pthread_cond_signal(&queue.cond_not_empty);
+    pthread_mutex_unlock(&queue.lock);
+  }
+  pthread_mutex_lock(&queue.lock);
+  queue.done = 1;
+  pthread_cond_signal(&queue.cond_not_empty);
+  pthread_mutex_unlock(&queue.lock);
+  pthread_join(consumer, NULL);
+  double elapsed = (now_ns() - start) / 1e9;
+
+  free(queue.buffer);
+  return elapsed;
+}
+
+/**
+ * @brief Shared-memory consumer, run in the forked child.
+ * @param out Results, written to the pipe.
+ */
+static void shm_consumer(int out)
+{
+  shm_channel ch;
+  if (shm_channel_attach(&ch, CHANNEL_NAME, RING_SIZE, 1, 1) != 0)
+  {
+    fprintf(stderr, "ERROR: Child failed to attach to %s\n", CHANNEL_NAME);
+    _exit(1);
+  }
+
+  bench_result r;
+  memset(&r, 0, sizeof(r));
+  shm_trade t;
+  for (;;)
+  {
+    if (shm_channel_pop(&ch, &t))
+    {
+      if (t.symbol[0] == '\0') // end marker
+        break;
+      record(&r, t.price, t.receive_ts_ms);
+    }
+    else
+      shm_channel_wait(&ch, WAIT_TIMEOUT_MS);
+  }
+  shm_channel_close(&ch);
+
+  if (write(out, &r, sizeof(r)) != (ssize_t)sizeof(r))
+    _exit(1);
+  _exit(0);
+}
+
+/**
+ * @brief Runs the shared-memory benchmark with a forked consumer.
+ * @param result Pointer to store the consumer's results.
+ * @param dropped Pointer to store the dropped trades.
+ * @return Elapsed seconds.
+ */
+static double run_shm(bench_result *result, uint64_t *dropped)
+{
+  shm_channel ch;
+  if (shm_channel_create(&ch, CHANNEL_NAME, RING_SIZE, 1, 1) != 0)
+    exit(1);
+
+  int fds[2];
+  if (pipe(fds) != 0)
+  {
+    perror("pipe");
+    exit(1);
+  }
+  pid_t child = fork();
+  if (child < 0)
+  {
+    perror("fork");
+    exit(1);
+  }
+  if (child == 0)
+  {
+    close(fds[0]);
+    shm_consumer(fds[1]);
+  }
+  close(fds[1]);
+
+  shm_trade t = {0, 0, 0.0, 1.0, 1, "BTC-USDT"};
+  int64_t start = now_ns();
+  for (uint64_t i = 0; i < trades; ++i)
+  {
+    if (rate > 0.0)
+      sleep_until(start + (int64_t)(i * 1e9 / rate));
+    t.price = trade_price(i);
+    t.receive_ts_ms = now_ns();
+    while (!shm_channel_push(&ch, &t) && rate == 0.0)
+      sched_yield(); // flat out: wait for space (the channel counts these retries, ignored below)
+  }
+  t.symbol[0] = '\0';
+  while (!shm_channel_push(&ch, &t))
+    sched_yield();
+
+  memset(result, 0, sizeof(*result));
+  if (read(fds[0], result, sizeof(*result)) != (ssize_t)sizeof(*result))
+    fprintf(stderr, "WARNING: Consumer process reported no results\n");
+  double elapsed = (now_ns() - start) / 1e9;
+  waitpid(child, NULL, 0);
+  close(fds[0]);
+
+  *dropped = rate > 0.0 ? shm_channel_dropped(&ch) : 0;
+  shm_channel_close(&ch);
+  return elapsed;
+}
+
+/**
+ * @brief Prints one result row.
+ * @param name Transport.
+ * @param elapsed Seconds.
+ * @param r Consumer results.
+ * @param dropped Dropped trades.
+ */
+static void print_row(const char *name, double elapsed, const bench_result *r, uint64_t dropped)
+{
+  printf("%-28s %12.0f %10" PRIu64 " %10" PRIu64, name, r->received / elapsed, r->received, dropped);
+  if (rate > 0.0 && r->received > 0)
+    printf(" %10.1f %10.1f", r->latency_sum_us / r->received, r->latency_max_us);
+  printf("\n");
+}
+
+/**
+ * @brief Entry point.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return 0 on success, 2 if a transport lost or corrupted trades.
+ */
+int main(int argc, char **argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n:r:h")) != -1)
+  {
+    switch (opt)
+    {
+    case 'n':
+      trades = strtoull(optarg, NULL, 10);
+      break;
+    case 'r':
+      rate = atof(optarg);
+      break;
+    default:
+      fprintf(stderr, "Usage: %s [-n TRADES] [-r RATE]\n", argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (trades == 0)
+    trades = 1;
+
+  double expected = 0.0;
+  for (uint64_t i = 0; i < trades; ++i)
+    expected += trade_price(i);
+
+  printf("Trades: %" PRIu64 ", %s\n", trades, rate > 0.0 ? "paced" : "flat out");
+  printf("%-28s %12s %10s %10s", "transport", "trades/s", "received", "dropped");
+  if (rate > 0.0)
+    printf(" %10s %10s", "mean_us", "max_us");
+  printf("\n");
+
+  uint64_t dropped;
+  double elapsed = run_queue(&dropped);
+  print_row("in-process queue (1 KB)", elapsed, &queue_result, dropped);
+  int ok = rate > 0.0 || (queue_result.received == trades && queue_result.checksum == expected);
+
+  bench_result shm_result;
+  elapsed = run_shm(&shm_result, &dropped);
+  print_row("shared memory, 2 processes", elapsed, &shm_result, dropped);
+  ok = ok && (rate > 0.0 || (shm_result.received == trades && shm_result.checksum == expected));
+
+  if (!ok)
+  {
+    fprintf(stderr, "ERROR: A transport lost or reordered trades\n");
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file latency_report.c
+ * @brief Summarizes the latency log the way plot.py's latency component analysis does.
+ *
+ * Usage: latency_report [-d DIR] [-o HOURLY_CSV] [FILE...]
+ *
+ * Reads binary (`.bin`) and CSV (`.csv`) latency segments, plain or gzipped. Without
+ * FILE arguments every `latency.*` segment in DIR (default data/performance) plus the
+ * active file is read. The summary is taken over the hourly means of the samples below
+ * the 99.9th percentile (see latency_stats.h).
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "latency_stats.h"
+
+int main(int argc, char **argv)
+{
+  const char *dir = "data/performance";
+  const char *hourly_csv = NULL;
+  static char *paths[LATENCY_MAX_INPUTS];
+  int num_paths = 0;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+      dir = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      hourly_csv = argv[++i];
+    else if (argv[i][0] == '-')
+    {
+      fprintf(stderr, "Usage: %s [-d DIR] [-o HOURLY_CSV] [FILE...]\n", argv[0]);
+      return 1;
+    }
+    else if (num_paths < LATENCY_MAX_INPUTS)
+      paths[num_paths++] = argv[i];
+  }
+
+  if (num_paths == 0)
+    num_paths = latency_default_inputs(dir, paths);
+
+  if (num_paths == 0)
+  {
+    fprintf(stderr, "ERROR: No latency logs found in %s\n", dir);
+    return 1;
+  }
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  latency_stats stats;
+  if (latency_stats_compute(paths, num_paths, &stats) < 0)
+  {
+    fprintf(stderr, "ERROR: No latency samples in %d file(s)\n", num_paths);
+    return 1;
+  }
+
+  if (hourly_csv)
+  {
+    FILE *out = fopen(hourly_csv, "w");
+    if (!out)
+    {
+      fprintf(stderr, "WARNING: Failed to open %s\n", hourly_csv);
+    }
+    else
+    {
+      latency_stats_write_hourly(&stats, out);
+      fclose(out);
+    }
+  }
+
+  /* summary over hourly means, as in the plot */
+  latency_summary summary;
+  latency_stats_summarize(&stats, &summary);
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double elapsed_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+  printf("Filtered %" PRIu64 " extreme outliers (top 0.1%%, total > %.1f ms) from %" PRIu64 " data points\n",
+         stats.count - stats.kept, stats.threshold_ms, stats.count);
+  printf("Total latency percentiles: p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, p99.9 %.1f ms\n",
+         latency_total_quantile(&stats, 0.50), latency_total_quantile(&stats, 0.90),
+         latency_total_quantile(&stats, 0.99), stats.threshold_ms);
+  printf("    Latency Performance Metrics\n");
+  printf("────────────────────────────────────\n");
+  printf("Network Latency (mean)   : %6.1f ms\n", summary.network_mean_ms);
+  printf("Processing Latency (mean): %6.1f ms\n", summary.processing_mean_ms);
+  printf("Total Latency (mean)     : %6.1f ms\n", summary.total_mean_ms);
+  printf("Total Latency (minimum)  : %6.1f ms\n", summary.total_min_ms);
+  printf("Total Latency (maximum)  : %6.1f ms\n", summary.total_max_ms);
+  printf("Hourly Data Points       : %3d hours\n", summary.hours);
+
+  fprintf(stderr, "INFO: %d file(s) analyzed in %.2f ms\n", num_paths, elapsed_ms);
+
+  latency_stats_free(&stats);
+  return 0;
+}
@@ -0,0 +1,468 @@
+/**
+ * @file latency_stats.h
+ * @brief Streaming latency statistics shared by the offline tools.
+ *
+ * Reads binary (`.bin`) and CSV (`.csv`) latency segments, plain or gzipped, and
+ * reproduces plot.py's latency component analysis: samples whose total latency
+ * exceeds the 99.9th percentile are dropped and the rest are averaged per UTC hour
+ * of exchange time.
+ *
+ * Two streaming passes keep memory bounded: the first builds a histogram of total
+ * latency (for exact percentiles) and finds the hour range, the second aggregates
+ * the filtered samples per hour.
+ *
+ * Header-only: the tools are single-file programs.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <glob.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "../src/logging/latency_record.h"
+
+#define LATENCY_MS_PER_HOUR 3600000LL
+#define LATENCY_MAX_INPUTS 4096
+#define LATENCY_READ_BATCH_RECORDS 4096
+#define LATENCY_OUTLIER_QUANTILE 0.999
+
+/* Histogram of total latency covers [LATENCY_HIST_MIN_MS, LATENCY_HIST_MIN_MS + LATENCY_HIST_BUCKETS) exactly */
+#define LATENCY_HIST_MIN_MS (-65536)
+#define LATENCY_HIST_BUCKETS (1 << 21)
+
+/**
+ * @brief Callback invoked for every decoded latency sample.
+ */
+typedef void (*latency_sample_fn)(void *ctx, int64_t exchange_ts_ms, int64_t network_ms, int64_t processing_ms);
+
+/**
+ * @brief Per-hour sums of the filtered samples.
+ */
+typedef struct
+{
+  double network_sum, processing_sum;
+  uint64_t count;
+} latency_hour;
+
+/**
+ * @brief Distribution of total latency and hourly aggregation below the outlier threshold.
+ */
+typedef struct
+{
+  /* pass 1 */
+  uint64_t *hist;
+  int64_t *outside; /**< totals outside the histogram range (sorted after pass 1) */
+  size_t num_outside, cap_outside;
+  uint64_t count;
+  int64_t min_ts_ms, max_ts_ms;
+
+  /* pass 2 */
+  double threshold_ms;
+  int64_t first_hour;
+  latency_hour *hours;
+  int64_t num_hours;
+  uint64_t kept;
+} latency_stats;
+
+/**
+ * @brief Summary over the hourly means, as printed by plot.py.
+ */
+typedef struct
+{
+  double network_mean_ms, processing_mean_ms, total_mean_ms;
+  double total_min_ms, total_max_ms;
+  int hours;
+} latency_summary;
+
+/**
+ * @brief Checks whether a path names a binary latency segment (.bin or .bin.gz).
+ * @param path File path.
+ * @return 1 if binary, 0 if CSV.
+ */
+static int latency_is_binary_path(const char *path)
+{
+  return strstr(path, ".bin") != NULL;
+}
+
+/**
+ * @brief Decodes a binary latency segment.
+ * @param in Open (possibly gzipped) file.
+ * @param path File path for diagnostics.
+ * @param fn Sample callback.
+ * @param ctx Callback context.
+ * @return Number of samples decoded.
+ */
+static uint64_t latency_read_binary(gzFile in, const char *path, latency_sample_fn fn, void *ctx)
+{
+  char magic[LATENCY_LOG_MAGIC_LEN];
+  if (gzread(in, magic, sizeof(magic)) != (int)sizeof(magic) ||
+      memcmp(magic, LATENCY_LOG_MAGIC, LATENCY_LOG_MAGIC_LEN) != 0)
+  {
+    fprintf(stderr, "WARNING: %s is not a binary latency log\n", path);
+    return 0;
+  }
+
+  static latency_record batch[LATENCY_READ_BATCH_RECORDS];
+  int64_t ts_ms = 0;
+  int based = 0;
+  uint64_t samples = 0;
+  int bytes;
+
+  while ((bytes = gzread(in, batch, sizeof(batch))) > 0)
+  {
+    int n = bytes / (int)sizeof(latency_record);
+    for (int i = 0; i < n; ++i)
+    {
+      const latency_record *rec = &batch[i];
+      if (rec->symbol_index == LATENCY_REBASE_SYMBOL)
+      {
+        ts_ms = latency_record_rebase_ts(rec);
+        based = 1;
+        continue;
+      }
+      if (!based)
+        continue;
+
+      ts_ms += rec->exchange_delta_ms;
+      fn(ctx, ts_ms, rec->network_latency_ms, rec->processing_latency_ms);
+      samples++;
+    }
+  }
+
+  return samples;
+}
+
+/**
+ * @brief Decodes a CSV latency segment (header line optional).
+ * @param in Open (possibly gzipped) file.
+ * @param fn Sample callback.
+ * @param ctx Callback context.
+ * @return Number of samples decoded.
+ */
+static uint64_t latency_read_csv(gzFile in, latency_sample_fn fn, void *ctx)
+{
+  char line[512];
+  uint64_t samples = 0;
+
+  while (gzgets(in, line, sizeof(line)))
+  {
+    /* symbol_index,exchange_ts,recv_ts,process_ts,network_lat,process_lat,total_lat */
+    if ((line[0] < '0' || line[0] > '9') && line[0] != '-')
+      continue;
+
+    char *p = line;
+    int64_t fields[6];
+    int ok = 1;
+    for (int f = 0; f < 6 && ok; ++f)
+    {
+      char *endp;
+      fields[f] = strtoll(p, &endp, 10);
+      ok = endp != p && *endp == ',';
+      p = endp + 1;
+    }
+    if (!ok)
+      continue;
+
+    fn(ctx, fields[1], fields[4], fields[5]);
+    samples++;
+  }
+
+  return samples;
+}
+
+/**
+ * @brief Runs a callback over every sample of every input file.
+ * @param paths Input paths.
+ * @param num_paths Number of inputs.
+ * @param fn Sample callback.
+ * @param ctx Callback context.
+ */
+static void latency_for_each_sample(char **paths, int num_paths, latency_sample_fn fn, void *ctx)
+{
+  for (int k = 0; k < num_paths; ++k)
+  {
+    gzFile in = gzopen(paths[k], "rb");
+    if (!in)
+    {
+      fprintf(stderr, "WARNING: Failed to open %s\n", paths[k]);
+      continue;
+    }
+    gzbuffer(in, 256 * 1024);
+
+    if (latency_is_binary_path(paths[k]))
+      latency_read_binary(in, paths[k], fn, ctx);
+    else
+      latency_read_csv(in, fn, ctx);
+
+    gzclose(in);
+  }
+}
+
+/**
+ * @brief Collects the latency logs of a performance directory: closed segments, then active files.
+ * @param dir Performance directory.
+ * @param paths Output array of allocated paths (LATENCY_MAX_INPUTS entries).
+ * @return Number of paths collected.
+ */
+static int latency_default_inputs(const char *dir, char **paths)
+{
+  int n = 0;
+  const char *patterns[] = {"%s/latency.*.bin*", "%s/latency.*.csv*", "%s/latency.bin", "%s/latency.csv"};
+
+  for (int p = 0; p < 4; ++p)
+  {
+    char pattern[256];
+    glob_t g;
+    snprintf(pattern, sizeof(pattern), patterns[p], dir);
+    if (glob(pattern, 0, NULL, &g) != 0)
+      continue;
+
+    for (size_t i = 0; i < g.gl_pathc && n < LATENCY_MAX_INPUTS; ++i)
+      paths[n++] = strdup(g.gl_pathv[i]);
+    globfree(&g);
+  }
+
+  return n;
+}
+
+/**
+ * @brief Floor division of a timestamp into hours (pandas' floor('H')).
+ * @param ts_ms Timestamp in ms.
+ * @return Hours since the epoch.
+ */
+static int64_t latency_hour_of(int64_t ts_ms)
+{
+  int64_t h = ts_ms / LATENCY_MS_PER_HOUR;
+  if (ts_ms % LATENCY_MS_PER_HOUR < 0)
+    h--;
+  return h;
+}
+
+/**
+ * @brief Pass 1 callback: histogram of total latency and exchange time range.
+ */
+static void latency_distribution_sample(void *ctx, int64_t exchange_ts_ms, int64_t network_ms, int64_t processing_ms)
+{
+  latency_stats *s = ctx;
+  int64_t total_ms = network_ms + processing_ms;
+  int64_t bucket = total_ms - LATENCY_HIST_MIN_MS;
+
+  if (bucket >= 0 && bucket < LATENCY_HIST_BUCKETS)
+  {
+    s->hist[bucket]++;
+  }
+  else
+  {
+    if (s->num_outside == s->cap_outside)
+    {
+      s->cap_outside = s->cap_outside ? 2 * s->cap_outside : 1024;
+      s->outside = realloc(s->outside, s->cap_outside * sizeof(int64_t));
+      if (!s->outside)
+      {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        exit(1);
+      }
+    }
+    s->outside[s->num_outside++] = total_ms;
+  }
+
+  if (s->count == 0 || exchange_ts_ms < s->min_ts_ms)
+    s->min_ts_ms = exchange_ts_ms;
+  if (s->count == 0 || exchange_ts_ms > s->max_ts_ms)
+    s->max_ts_ms = exchange_ts_ms;
+  s->count++;
+}
+
+/**
+ * @brief Pass 2 callback: per-hour sums of samples at or below the threshold.
+ */
+static void latency_hourly_sample(void *ctx, int64_t exchange_ts_ms, int64_t network_ms, int64_t processing_ms)
+{
+  latency_stats *s = ctx;
+  if ((double)(network_ms + processing_ms) > s->threshold_ms)
+    return;
+
+  int64_t idx = latency_hour_of(exchange_ts_ms) - s->first_hour;
+  if (idx < 0 || idx >= s->num_hours)
+    return;
+
+  s->hours[idx].network_sum += (double)network_ms;
+  s->hours[idx].processing_sum += (double)processing_ms;
+  s->hours[idx].count++;
+  s->kept++;
+}
+
+/**
+ * @brief Sort int64 ascending.
+ */
+static int latency_compare_i64(const void *a, const void *b)
+{
+  int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the k-th smallest total latency (0-based).
+ * @param s Statistics after pass 1.
+ * @param k Rank.
+ * @return The value at rank k.
+ */
+static int64_t latency_nth_total(const latency_stats *s, uint64_t k)
+{
+  /* outside values below the histogram come first, those above it last */
+  size_t below = 0;
+  while (below < s->num_outside && s->outside[below] < LATENCY_HIST_MIN_MS)
+    below++;
+
+  if (k < below)
+    return s->outside[k];
+  k -= below;
+
+  for (int64_t b = 0; b < LATENCY_HIST_BUCKETS; ++b)
+  {
+    if (k < s->hist[b])
+      return b + LATENCY_HIST_MIN_MS;
+    k -= s->hist[b];
+  }
+
+  return s->outside[below + k];
+}
+
+/**
+ * @brief Quantile of total latency with linear interpolation (pandas' default).
+ * @param s Statistics after pass 1.
+ * @param q Quantile in [0, 1].
+ * @return The quantile value.
+ */
+static double latency_total_quantile(const latency_stats *s, double q)
+{
+  double pos = (double)(s->count - 1) * q;
+  uint64_t lo = (uint64_t)floor(pos);
+  uint64_t hi = (uint64_t)ceil(pos);
+  double v_lo = (double)latency_nth_total(s, lo);
+  double v_hi = (double)latency_nth_total(s, hi);
+  return v_lo + (v_hi - v_lo) * (pos - (double)lo);
+}
+
+/**
+ * @brief Runs both passes over the inputs.
+ * @param paths Input paths.
+ * @param num_paths Number of inputs.
+ * @param s Pointer to the statistics to fill (release with latency_stats_free).
+ * @return 0 on success, -1 if no samples were found.
+ */
+static int latency_stats_compute(char **paths, int num_paths, latency_stats *s)
+{
+  memset(s, 0, sizeof(*s));
+  s->hist = calloc(LATENCY_HIST_BUCKETS, sizeof(uint64_t));
+  if (!s->hist)
+  {
+    fprintf(stderr, "ERROR: Out of memory\n");
+    exit(1);
+  }
+
+  latency_for_each_sample(paths, num_paths, latency_distribution_sample, s);
+  if (s->count == 0)
+    return -1;
+
+  qsort(s->outside, s->num_outside, sizeof(int64_t), latency_compare_i64);
+
+  s->threshold_ms = latency_total_quantile(s, LATENCY_OUTLIER_QUANTILE);
+  s->first_hour = latency_hour_of(s->min_ts_ms);
+  s->num_hours = latency_hour_of(s->max_ts_ms) - s->first_hour + 1;
+  s->hours = calloc(s->num_hours, sizeof(latency_hour));
+  if (!s->hours)
+  {
+    fprintf(stderr, "ERROR: Out of memory\n");
+    exit(1);
+  }
+
+  latency_for_each_sample(paths, num_paths, latency_hourly_sample, s);
+  return 0;
+}
+
+/**
+ * @brief Writes the hourly means as CSV (hours without samples are skipped).
+ * @param s Computed statistics.
+ * @param out Output stream.
+ */
+static void latency_stats_write_hourly(const latency_stats *s, FILE *out)
+{
+  fprintf(out, "hour_ts_ms,network_latency_ms,processing_latency_ms,total_latency_ms,samples\n");
+
+  for (int64_t i = 0; i < s->num_hours; ++i)
+  {
+    const latency_hour *h = &s->hours[i];
+    if (h->count == 0)
+      continue;
+
+    double network_mean = h->network_sum / (double)h->count;
+    double processing_mean = h->processing_sum / (double)h->count;
+    fprintf(out, "%" PRId64 ",%.3f,%.3f,%.3f,%" PRIu64 "\n",
+            (int64_t)((s->first_hour + i) * LATENCY_MS_PER_HOUR), network_mean, processing_mean,
+            network_mean + processing_mean, h->count);
+  }
+}
+
+/**
+ * @brief Summarizes the hourly means (mean of means, min/max hourly total).
+ * @param s Computed statistics.
+ * @param out Pointer to the summary to fill.
+ */
+static void latency_stats_summarize(const latency_stats *s, latency_summary *out)
+{
+  double network_sum = 0.0, processing_sum = 0.0;
+
+  memset(out, 0, sizeof(*out));
+  out->total_min_ms = INFINITY;
+  out->total_max_ms = -INFINITY;
+
+  for (int64_t i = 0; i < s->num_hours; ++i)
+  {
+    const latency_hour *h = &s->hours[i];
+    if (h->count == 0)
+      continue;
+
+    double network_mean = h->network_sum / (double)h->count;
+    double processing_mean = h->processing_sum / (double)h->count;
+    double total_mean = network_mean + processing_mean;
+
+    network_sum += network_mean;
+    processing_sum += processing_mean;
+    if (total_mean < out->total_min_ms)
+      out->total_min_ms = total_mean;
+    if (total_mean > out->total_max_ms)
+      out->total_max_ms = total_mean;
+    out->hours++;
+  }
+
+  if (out->hours > 0)
+  {
+    out->network_mean_ms = network_sum / out->hours;
+    out->processing_mean_ms = processing_sum / out->hours;
+    out->total_mean_ms = out->network_mean_ms + out->processing_mean_ms;
+  }
+}
+
+/**
+ * @brief Releases the buffers of latency statistics.
+ * @param s Pointer to the statistics.
+ */
+static void latency_stats_free(latency_stats *s)
+{
+  free(s->hist);
+  free(s->outside);
+  free(s->hours);
+}
+
+#endif /* LATENCY_STATS_H */
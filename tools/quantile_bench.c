@@ -0,0 +1,274 @@
+/**
+ * @file quantile_bench.c
+ * @brief Measures the per-trade cost of the window quantile sets.
+ *
+ * Usage: quantile_bench [-r RATE] [-n TRADES] [FILE.jsonl]
+ *
+ * Streams trades through a 15-minute sliding window exactly as `sliding_window_add_trade`
+ * does (insert the new trade, evict the expired ones) and times the price and size
+ * quantile sets in both modes against a window without them. Trades come from an
+ * archived OKX JSONL file, or are synthetic at RATE trades per second (default 100).
+ * Also reports memory per set and the approximate mode's relative error.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/data/quantiles.h"
+
+#define WINDOW_MS (15 * 60 * 1000LL)
+#define WINDOW_CAPACITY 50000
+#define SAMPLE_EVERY 1000 /**< trades between error samples */
+
+/**
+ * @brief A benchmark trade.
+ */
+typedef struct
+{
+  int64_t ts_ms;
+  double price;
+  double size;
+} bench_trade;
+
+/**
+ * @brief Extracts the value of a quoted JSON field.
+ * @param line JSON text.
+ * @param key Quoted key, e.g. "\"px\"".
+ * @param out Pointer to store the number.
+ * @return 1 on success, 0 if missing.
+ */
+static int json_number(const char *line, const char *key, double *out)
+{
+  const char *p = strstr(line, key);
+  if (!p || !(p = strchr(p, ':')))
+    return 0;
+  while (*p == ':' || *p == ' ' || *p == '"')
+    p++;
+  *out = strtod(p, NULL);
+  return 1;
+}
+
+/**
+ * @brief Loads trades from an archived JSONL file.
+ * @param path File path.
+ * @param max Maximum trades to load.
+ * @param out Output array.
+ * @return Number of trades loaded.
+ */
+static size_t load_trades(const char *path, size_t max, bench_trade *out)
+{
+  FILE *fp = fopen(path, "r");
+  if (!fp)
+  {
+    fprintf(stderr, "ERROR: Failed to open %s\n", path);
+    return 0;
+  }
+
+  static char line[4096];
+  size_t n = 0;
+  while (n < max && fgets(line, sizeof(line), fp))
+  {
+    double ts;
+    if (json_number(line, "\"px\"", &out[n].price) && json_number(line, "\"sz\"", &out[n].size) &&
+        json_number(line, "\"ts\"", &ts) && out[n].price > 0 && out[n].size > 0)
+    {
+      out[n].ts_ms = (int64_t)ts;
+      n++;
+    }
+  }
+
+  fclose(fp);
+  return n;
+}
+
+/**
+ * @brief Generates a random-walk price with log-normal sizes.
+ * @param n Number of trades.
+ * @param rate Trades per second.
+ * @param out Output array.
+ */
+static void synth_trades(size_t n, double rate, bench_trade *out)
+{
+  double price = 100.0;
+  srand(42);
+  for (size_t i = 0; i < n; ++i)
+  {
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0), u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+    price *= exp(1e-4 * z);
+    out[i].ts_ms = 1700000000000LL + (int64_t)(i * 1000.0 / rate);
+    out[i].price = round(price * 100.0) / 100.0; // tick size 0.01: many duplicates
+    out[i].size = exp(z * 1.5 - 2.0);
+  }
+}
+
+/**
+ * @brief Streams trades through a sliding window, optionally maintaining quantile sets.
+ * @param trades Trades in time order.
+ * @param n Number of trades.
+ * @param price_q Price set (NULL for the baseline).
+ * @param size_q Size set (NULL for the baseline).
+ * @return Elapsed nanoseconds.
+ */
+static double run_window(const bench_trade *trades, size_t n, quantile_set *price_q, quantile_set *size_q)
+{
+  size_t head = 0;
+  volatile double sink = 0;
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    while (head < i && (trades[head].ts_ms < trades[i].ts_ms - WINDOW_MS || i - head >= WINDOW_CAPACITY))
+    {
+      if (price_q)
+      {
+        quantile_set_remove(price_q, trades[head].price);
+        quantile_set_remove(size_q, trades[head].size);
+      }
+      sink += trades[head].size;
+      head++;
+    }
+    if (price_q)
+    {
+      quantile_set_insert(price_q, trades[i].price);
+      quantile_set_insert(size_q, trades[i].size);
+    }
+    sink += trades[i].price;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  (void)sink;
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+/**
+ * @brief Replays the window with both modes side by side and returns the worst relative error.
+ * @param trades Trades in time order.
+ * @param n Number of trades.
+ * @param levels Quantile levels to compare.
+ * @param num_levels Number of levels.
+ * @param use_size Nonzero to compare sizes, zero for prices.
+ * @return Maximum |approx - exact| / exact over the samples.
+ */
+static double approx_error(const bench_trade *trades, size_t n, const double *levels, int num_levels, int use_size)
+{
+  quantile_set exact, approx;
+  quantile_set_init(&exact, QUANTILE_EXACT, WINDOW_CAPACITY);
+  quantile_set_init(&approx, QUANTILE_APPROX, WINDOW_CAPACITY);
+
+  size_t head = 0;
+  double worst = 0.0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    while (head < i && (trades[head].ts_ms < trades[i].ts_ms - WINDOW_MS || i - head >= WINDOW_CAPACITY))
+    {
+      double x = use_size ? trades[head].size : trades[head].price;
+      quantile_set_remove(&exact, x);
+      quantile_set_remove(&approx, x);
+      head++;
+    }
+    double x = use_size ? trades[i].size : trades[i].price;
+    quantile_set_insert(&exact, x);
+    quantile_set_insert(&approx, x);
+
+    if (i % SAMPLE_EVERY == SAMPLE_EVERY - 1)
+    {
+      for (int k = 0; k < num_levels; ++k)
+      {
+        /* the sketch answers with a rank, so compare against the nearest-rank exact value */
+        double e = quantile_set_query(&exact, floor(levels[k] * (exact.size - 1)) / (exact.size - 1 ? exact.size - 1 : 1));
+        double a = quantile_set_query(&approx, levels[k]);
+        double err = fabs(a - e) / e;
+        if (err > worst)
+          worst = err;
+      }
+    }
+  }
+
+  quantile_set_cleanup(&exact);
+  quantile_set_cleanup(&approx);
+  return worst;
+}
+
+int main(int argc, char **argv)
+{
+  size_t num_trades = 1000000;
+  double rate = 100.0;
+  const char *path = NULL;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      num_trades = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      rate = atof(argv[++i]);
+    else if (argv[i][0] == '-')
+    {
+      fprintf(stderr, "Usage: %s [-r RATE] [-n TRADES] [FILE.jsonl]\n", argv[0]);
+      return 1;
+    }
+    else
+      path = argv[i];
+  }
+
+  bench_trade *trades = malloc(num_trades * sizeof(bench_trade));
+  if (!trades || num_trades == 0)
+  {
+    fprintf(stderr, "ERROR: Failed to allocate %zu trades\n", num_trades);
+    return 1;
+  }
+
+  if (path)
+    num_trades = load_trades(path, num_trades, trades);
+  else
+    synth_trades(num_trades, rate, trades);
+
+  if (num_trades == 0)
+  {
+    fprintf(stderr, "ERROR: No trades to replay\n");
+    return 1;
+  }
+
+  double span_s = (trades[num_trades - 1].ts_ms - trades[0].ts_ms) / 1000.0;
+  printf("Trades: %zu over %.0f s (%.1f trades/s)\n", num_trades, span_s,
+         span_s > 0 ? num_trades / span_s : 0.0);
+
+  double base_ns = run_window(trades, num_trades, NULL, NULL);
+
+  static const char *mode_names[] = {"exact (treap)", "approx (sketch)"};
+  for (int mode = QUANTILE_EXACT; mode <= QUANTILE_APPROX; ++mode)
+  {
+    quantile_set price_q, size_q;
+    if (quantile_set_init(&price_q, mode, WINDOW_CAPACITY) < 0 || quantile_set_init(&size_q, mode, WINDOW_CAPACITY) < 0)
+    {
+      fprintf(stderr, "ERROR: Failed to allocate quantile sets\n");
+      return 1;
+    }
+
+    double ns = run_window(trades, num_trades, &price_q, &size_q);
+    printf("%-16s: %7.1f ns/trade over the plain window (price + size sets), %7.1f KB per set\n",
+           mode_names[mode], (ns - base_ns) / num_trades, quantile_set_memory(&price_q) / 1024.0);
+
+    quantile_set_cleanup(&price_q);
+    quantile_set_cleanup(&size_q);
+  }
+
+  static const double levels[] = {0.50, 0.90, 0.99};
+  printf("Approximate mode worst relative error (p50/p90/p99, alpha %.2f): price %.4f, size %.4f\n",
+         QUANTILE_SKETCH_ALPHA, approx_error(trades, num_trades, levels, 3, 0),
+         approx_error(trades, num_trades, levels, 3, 1));
+
+  free(trades);
+  return 0;
+}
@@ -0,0 +1,598 @@
+/**
+ * @file report.c
+ * @brief Streams the data directory once into small aggregate CSVs for plotting.
+ *
+ * Usage: report [-d DATA_DIR] [-o OUT_DIR]
+ *
+ * Replaces plot.py's full pandas loads of the raw logs with bounded-memory passes:
+ *   throughput_minute.csv          trades per exchange minute, total and per symbol
+ *   scheduler_drift_summary.csv    min/mean/max/std of scheduler drift
+ *   scheduler_drift_histogram.csv  50-bin drift histogram
+ *   latency_hourly.csv             hourly network/processing means below the p99.9 cut
+ *   latency_summary.csv            sample counts, cut threshold and total latency percentiles
+ *   correlation_frequency.csv      how often each symbol pair was the best correlation,
+ *                                  with mean coefficient and lag
+ *
+ * DATA_DIR defaults to data, OUT_DIR to DATA_DIR/reports. Trade and latency segments
+ * may be plain or gzipped; plot.py uses these files when they exist.
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "latency_stats.h"
+#include "../src/logging/trade_index.h"
+
+#define MS_PER_MINUTE 60000LL
+#define MAX_SYMBOLS 64
+#define DRIFT_HISTOGRAM_BINS 50
+
+/**
+ * @brief Symbol names discovered from the file names of the data directory.
+ */
+typedef struct
+{
+  char names[MAX_SYMBOLS][32];
+  int count;
+} symbol_table;
+
+/**
+ * @brief Per-minute counters for each symbol, grown as minutes are seen.
+ */
+typedef struct
+{
+  int64_t first_minute; /**< minute number of row 0 */
+  size_t rows, capacity;
+  int cols;
+  uint32_t *counts; /**< rows x cols */
+} minute_series;
+
+/**
+ * @brief Running statistics of the best correlation of one symbol pair.
+ */
+typedef struct
+{
+  uint64_t count;
+  double correlation_sum;
+  double lag_minutes_sum;
+} pair_stats;
+
+/**
+ * @brief Returns the index of a symbol, adding it if new.
+ * @param t Symbol table.
+ * @param name Symbol name (may be followed by other characters after `len`).
+ * @param len Length of the name.
+ * @return Index, or -1 if the table is full.
+ */
+static int symbol_index(symbol_table *t, const char *name, size_t len)
+{
+  if (len == 0 || len >= sizeof(t->names[0]))
+    return -1;
+
+  for (int i = 0; i < t->count; ++i)
+    if (strlen(t->names[i]) == len && strncmp(t->names[i], name, len) == 0)
+      return i;
+
+  if (t->count == MAX_SYMBOLS)
+    return -1;
+
+  memcpy(t->names[t->count], name, len);
+  t->names[t->count][len] = '\0';
+  return t->count++;
+}
+
+/**
+ * @brief Extracts the symbol from `<dir>/<SYMBOL>.<...>`.
+ * @param path File path.
+ * @param out_len Pointer to store the name length.
+ * @return Pointer to the start of the name.
+ */
+static const char *path_symbol(const char *path, size_t *out_len)
+{
+  const char *base = strrchr(path, '/');
+  base = base ? base + 1 : path;
+  const char *dot = strchr(base, '.');
+  *out_len = dot ? (size_t)(dot - base) : strlen(base);
+  return base;
+}
+
+/**
+ * @brief Checks whether a string ends with a suffix.
+ * @param s String.
+ * @param suffix Suffix.
+ * @return 1 if it does, 0 otherwise.
+ */
+static int has_suffix(const char *s, const char *suffix)
+{
+  size_t len = strlen(s), suffix_len = strlen(suffix);
+  return len >= suffix_len && strcmp(s + len - suffix_len, suffix) == 0;
+}
+
+/**
+ * @brief Ensures a minute series can hold a number of rows.
+ * @param s Minute series.
+ * @param rows Required number of rows.
+ */
+static void minute_series_reserve(minute_series *s, size_t rows)
+{
+  if (rows <= s->capacity)
+    return;
+
+  size_t capacity = s->capacity ? s->capacity : 1024;
+  while (capacity < rows)
+    capacity *= 2;
+
+  s->counts = realloc(s->counts, capacity * s->cols * sizeof(uint32_t));
+  if (!s->counts)
+  {
+    fprintf(stderr, "ERROR: Out of memory\n");
+    exit(1);
+  }
+  s->capacity = capacity;
+}
+
+/**
+ * @brief Adds one event to a minute counter, growing the series in either direction.
+ * @param s Minute series.
+ * @param minute Minute number (ts_ms / 60000).
+ * @param col Column (symbol index).
+ */
+static void minute_series_add(minute_series *s, int64_t minute, int col)
+{
+  size_t row_bytes = s->cols * sizeof(uint32_t);
+
+  if (s->rows == 0)
+    s->first_minute = minute;
+
+  if (minute < s->first_minute) // earlier than any trade so far: move rows up
+  {
+    size_t shift = (size_t)(s->first_minute - minute);
+    minute_series_reserve(s, s->rows + shift);
+    memmove(s->counts + shift * s->cols, s->counts, s->rows * row_bytes);
+    memset(s->counts, 0, shift * row_bytes);
+    s->first_minute = minute;
+    s->rows += shift;
+  }
+
+  size_t row = (size_t)(minute - s->first_minute);
+  if (row >= s->rows)
+  {
+    minute_series_reserve(s, row + 1);
+    memset(s->counts + s->rows * s->cols, 0, (row + 1 - s->rows) * row_bytes);
+    s->rows = row + 1;
+  }
+
+  s->counts[row * s->cols + col]++;
+}
+
+/**
+ * @brief Opens an output CSV in the report directory.
+ * @param out_dir Report directory.
+ * @param name File name.
+ * @return FILE pointer, or NULL on error.
+ */
+static FILE *open_report(const char *out_dir, const char *name)
+{
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s", out_dir, name);
+  FILE *fp = fopen(path, "w");
+  if (!fp)
+    fprintf(stderr, "ERROR: Failed to open %s: %s\n", path, strerror(errno));
+  return fp;
+}
+
+/**
+ * @brief Counts trades per exchange minute and symbol across all trade segments.
+ * @param data_dir Data directory.
+ * @param out_dir Report directory.
+ * @return Number of trades counted.
+ */
+static uint64_t report_throughput(const char *data_dir, const char *out_dir)
+{
+  symbol_table symbols = {.count = 0};
+  char pattern[256];
+  glob_t g;
+
+  snprintf(pattern, sizeof(pattern), "%s/trades/*.jsonl*", data_dir);
+  if (glob(pattern, 0, NULL, &g) != 0)
+  {
+    fprintf(stderr, "WARNING: No trade logs in %s/trades\n", data_dir);
+    return 0;
+  }
+
+  /* columns first, so every row has its final width */
+  for (size_t i = 0; i < g.gl_pathc; ++i)
+  {
+    size_t len;
+    const char *name = path_symbol(g.gl_pathv[i], &len);
+    symbol_index(&symbols, name, len);
+  }
+
+  minute_series series = {.cols = symbols.count};
+  char line[4096];
+  uint64_t trades = 0;
+
+  for (size_t i = 0; i < g.gl_pathc; ++i)
+  {
+    size_t len;
+    const char *name = path_symbol(g.gl_pathv[i], &len);
+    int col = symbol_index(&symbols, name, len);
+    if (col < 0 || has_suffix(g.gl_pathv[i], TRADE_INDEX_SUFFIX))
+      continue;
+
+    gzFile in = gzopen(g.gl_pathv[i], "rb");
+    if (!in)
+    {
+      fprintf(stderr, "WARNING: Failed to open %s\n", g.gl_pathv[i]);
+      continue;
+    }
+    gzbuffer(in, 256 * 1024);
+
+    while (gzgets(in, line, sizeof(line)))
+    {
+      if (line[0] == '\0') // zero-filled tail of a segment that is still being written
+        break;
+
+      const char *p = strstr(line, "\"ts\":\"");
+      if (!p)
+        continue;
+
+      int64_t ts_ms = strtoll(p + 6, NULL, 10);
+      if (ts_ms <= 0)
+        continue;
+
+      minute_series_add(&series, ts_ms / MS_PER_MINUTE, col);
+      trades++;
+    }
+
+    gzclose(in);
+  }
+  globfree(&g);
+
+  FILE *out = open_report(out_dir, "throughput_minute.csv");
+  if (out)
+  {
+    fprintf(out, "minute_ts_ms,total");
+    for (int c = 0; c < symbols.count; ++c)
+      fprintf(out, ",%s", symbols.names[c]);
+    fputc('\n', out);
+
+    for (size_t r = 0; r < series.rows; ++r)
+    {
+      const uint32_t *row = series.counts + r * series.cols;
+      uint64_t total = 0;
+      for (int c = 0; c < series.cols; ++c)
+        total += row[c];
+
+      fprintf(out, "%" PRId64 ",%" PRIu64, (int64_t)((series.first_minute + (int64_t)r) * MS_PER_MINUTE), total);
+      for (int c = 0; c < series.cols; ++c)
+        fprintf(out, ",%u", row[c]);
+      fputc('\n', out);
+    }
+    fclose(out);
+  }
+
+  if (series.rows > 0)
+    printf("Throughput: %" PRIu64 " trades of %d symbol(s) over %zu minutes (%.1f msg/min)\n",
+           trades, symbols.count, series.rows, (double)trades / (double)series.rows);
+
+  free(series.counts);
+  return trades;
+}
+
+/**
+ * @brief Reads the drift column of scheduler.csv.
+ * @param fp Open scheduler log (positioned after the header).
+ * @param out_drift Pointer to store the drift.
+ * @return 1 if a sample was read, 0 at end of file.
+ */
+static int next_drift(FILE *fp, double *out_drift)
+{
+  char line[256];
+  while (fgets(line, sizeof(line), fp))
+  {
+    /* scheduled_ms,actual_ms,drift_ms */
+    const char *p = strrchr(line, ',');
+    if (!p || line[0] < '0' || line[0] > '9')
+      continue;
+    *out_drift = strtod(p + 1, NULL);
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Summarizes and bins the scheduler drift (two passes over a small file).
+ * @param data_dir Data directory.
+ * @param out_dir Report directory.
+ */
+static void report_scheduler(const char *data_dir, const char *out_dir)
+{
+  char path[512];
+  snprintf(path, sizeof(path), "%s/performance/scheduler.csv", data_dir);
+
+  FILE *fp = fopen(path, "r");
+  if (!fp)
+  {
+    fprintf(stderr, "WARNING: Scheduler log not found at %s\n", path);
+    return;
+  }
+
+  /* pass 1: Welford mean/variance and range */
+  uint64_t n = 0;
+  double mean = 0.0, m2 = 0.0, lo = INFINITY, hi = -INFINITY, drift;
+
+  while (next_drift(fp, &drift))
+  {
+    n++;
+    double delta = drift - mean;
+    mean += delta / (double)n;
+    m2 += delta * (drift - mean);
+    if (drift < lo)
+      lo = drift;
+    if (drift > hi)
+      hi = drift;
+  }
+
+  if (n == 0)
+  {
+    fclose(fp);
+    return;
+  }
+  double std = n > 1 ? sqrt(m2 / (double)(n - 1)) : 0.0;
+
+  /* pass 2: equal-width bins over [min, max], last bin closed (as numpy.histogram) */
+  uint64_t bins[DRIFT_HISTOGRAM_BINS] = {0};
+  double width = (hi - lo) / DRIFT_HISTOGRAM_BINS;
+
+  rewind(fp);
+  while (next_drift(fp, &drift))
+  {
+    int b = width > 0.0 ? (int)((drift - lo) / width) : 0;
+    if (b >= DRIFT_HISTOGRAM_BINS)
+      b = DRIFT_HISTOGRAM_BINS - 1;
+    if (b < 0)
+      b = 0;
+    bins[b]++;
+  }
+  fclose(fp);
+
+  FILE *out = open_report(out_dir, "scheduler_drift_summary.csv");
+  if (out)
+  {
+    fprintf(out, "samples,min_drift_ms,mean_drift_ms,max_drift_ms,std_drift_ms\n");
+    fprintf(out, "%" PRIu64 ",%.4f,%.4f,%.4f,%.4f\n", n, lo, mean, hi, std);
+    fclose(out);
+  }
+
+  out = open_report(out_dir, "scheduler_drift_histogram.csv");
+  if (out)
+  {
+    fprintf(out, "bin_start_ms,bin_end_ms,count\n");
+    for (int b = 0; b < DRIFT_HISTOGRAM_BINS; ++b)
+      fprintf(out, "%.4f,%.4f,%" PRIu64 "\n", lo + b * width, lo + (b + 1) * width, bins[b]);
+    fclose(out);
+  }
+
+  printf("Scheduler drift: %" PRIu64 " ticks, min %.2f ms, mean %.2f ms, max %.2f ms, std %.2f ms\n",
+         n, lo, mean, hi, std);
+}
+
+/**
+ * @brief Hourly latency means and total latency percentiles.
+ * @param data_dir Data directory.
+ * @param out_dir Report directory.
+ */
+static void report_latency(const char *data_dir, const char *out_dir)
+{
+  char dir[512];
+  static char *paths[LATENCY_MAX_INPUTS];
+  snprintf(dir, sizeof(dir), "%s/performance", data_dir);
+
+  int num_paths = latency_default_inputs(dir, paths);
+  latency_stats stats;
+
+  if (num_paths == 0 || latency_stats_compute(paths, num_paths, &stats) < 0)
+  {
+    fprintf(stderr, "WARNING: No latency samples in %s\n", dir);
+    for (int k = 0; k < num_paths; ++k)
+      free(paths[k]);
+    return;
+  }
+
+  FILE *out = open_report(out_dir, "latency_hourly.csv");
+  if (out)
+  {
+    latency_stats_write_hourly(&stats, out);
+    fclose(out);
+  }
+
+  double p50 = latency_total_quantile(&stats, 0.50);
+  double p90 = latency_total_quantile(&stats, 0.90);
+  double p99 = latency_total_quantile(&stats, 0.99);
+
+  out = open_report(out_dir, "latency_summary.csv");
+  if (out)
+  {
+    fprintf(out, "samples,filtered,threshold_ms,p50_ms,p90_ms,p99_ms,p999_ms\n");
+    fprintf(out, "%" PRIu64 ",%" PRIu64 ",%.1f,%.1f,%.1f,%.1f,%.1f\n", stats.count,
+            stats.count - stats.kept, stats.threshold_ms, p50, p90, p99, stats.threshold_ms);
+    fclose(out);
+  }
+
+  latency_summary summary;
+  latency_stats_summarize(&stats, &summary);
+  printf("Latency: %" PRIu64 " samples, p50 %.1f ms, p99 %.1f ms, p99.9 %.1f ms, "
+         "hourly mean %.1f ms (network %.1f + processing %.1f)\n",
+         stats.count, p50, p99, stats.threshold_ms, summary.total_mean_ms,
+         summary.network_mean_ms, summary.processing_mean_ms);
+
+  latency_stats_free(&stats);
+  for (int k = 0; k < num_paths; ++k)
+    free(paths[k]);
+}
+
+/**
+ * @brief Parses an ISO time with numeric offset (YYYY-mm-ddTHH:MM:SS+hhmm) to epoch minutes.
+ * @param text Input text.
+ * @param out_minute Pointer to store the minute number.
+ * @return 1 on success, 0 on failure.
+ */
+static int iso_minute(const char *text, int64_t *out_minute)
+{
+  struct tm tm;
+  char sign = '+';
+  int off_h = 0, off_m = 0;
+  memset(&tm, 0, sizeof(tm));
+
+  int n = sscanf(text, "%d-%d-%dT%d:%d:%d%c%2d%2d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                 &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &sign, &off_h, &off_m);
+  if (n < 6)
+    return 0;
+
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  int64_t offset_min = n == 9 ? (off_h * 60 + off_m) * (sign == '-' ? -1 : 1) : 0;
+  *out_minute = (int64_t)timegm(&tm) / 60 - offset_min;
+  return 1;
+}
+
+/**
+ * @brief Frequency table of the best-correlated symbol pairs.
+ * @param data_dir Data directory.
+ * @param out_dir Report directory.
+ */
+static void report_correlations(const char *data_dir, const char *out_dir)
+{
+  char pattern[256];
+  glob_t g;
+  snprintf(pattern, sizeof(pattern), "%s/metrics/correlations/*.csv", data_dir);
+  if (glob(pattern, 0, NULL, &g) != 0)
+  {
+    fprintf(stderr, "WARNING: No correlation logs in %s/metrics/correlations\n", data_dir);
+    return;
+  }
+
+  symbol_table symbols = {.count = 0};
+  static pair_stats pairs[MAX_SYMBOLS][MAX_SYMBOLS];
+  static uint64_t rows_per_symbol[MAX_SYMBOLS];
+  char line[512];
+  uint64_t rows = 0;
+
+  memset(pairs, 0, sizeof(pairs));
+  memset(rows_per_symbol, 0, sizeof(rows_per_symbol));
+
+  for (size_t i = 0; i < g.gl_pathc; ++i)
+  {
+    size_t len;
+    const char *name = path_symbol(g.gl_pathv[i], &len);
+    int base = symbol_index(&symbols, name, len);
+    FILE *fp = base >= 0 ? fopen(g.gl_pathv[i], "r") : NULL;
+    if (!fp)
+      continue;
+
+    while (fgets(line, sizeof(line), fp))
+    {
+      /* timestamp_iso,correlated_with,correlation,lag_timestamp_iso */
+      char *f1 = strchr(line, ',');
+      char *f2 = f1 ? strchr(f1 + 1, ',') : NULL;
+      char *f3 = f2 ? strchr(f2 + 1, ',') : NULL;
+      if (!f3 || line[0] < '0' || line[0] > '9')
+        continue;
+
+      int other = symbol_index(&symbols, f1 + 1, (size_t)(f2 - f1 - 1));
+      double correlation = strtod(f2 + 1, NULL);
+      int64_t minute, lag_minute;
+      if (other < 0 || isnan(correlation) || !iso_minute(line, &minute) || !iso_minute(f3 + 1, &lag_minute))
+        continue;
+
+      pair_stats *ps = &pairs[base][other];
+      ps->count++;
+      ps->correlation_sum += correlation;
+      ps->lag_minutes_sum += (double)(minute - lag_minute);
+      rows_per_symbol[base]++;
+      rows++;
+    }
+    fclose(fp);
+  }
+  globfree(&g);
+
+  FILE *out = open_report(out_dir, "correlation_frequency.csv");
+  if (out)
+  {
+    fprintf(out, "symbol,correlated_with,count,share,mean_correlation,mean_lag_minutes\n");
+    for (int a = 0; a < symbols.count; ++a)
+    {
+      for (int b = 0; b < symbols.count; ++b)
+      {
+        const pair_stats *ps = &pairs[a][b];
+        if (ps->count == 0)
+          continue;
+        fprintf(out, "%s,%s,%" PRIu64 ",%.4f,%.6f,%.2f\n", symbols.names[a], symbols.names[b], ps->count,
+                (double)ps->count / (double)rows_per_symbol[a], ps->correlation_sum / (double)ps->count,
+                ps->lag_minutes_sum / (double)ps->count);
+      }
+    }
+    fclose(out);
+  }
+
+  printf("Correlations: %" PRIu64 " best-match rows across %d symbol(s)\n", rows, symbols.count);
+}
+
+int main(int argc, char **argv)
+{
+  const char *data_dir = "data";
+  const char *out_arg = NULL;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+      data_dir = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+      out_arg = argv[++i];
+    else
+    {
+      fprintf(stderr, "Usage: %s [-d DATA_DIR] [-o OUT_DIR]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  char out_dir[512];
+  if (out_arg)
+    snprintf(out_dir, sizeof(out_dir), "%s", out_arg);
+  else
+    snprintf(out_dir, sizeof(out_dir), "%s/reports", data_dir);
+
+  if (mkdir(out_dir, 0755) < 0 && errno != EEXIST)
+  {
+    fprintf(stderr, "ERROR: Failed to create %s: %s\n", out_dir, strerror(errno));
+    return 1;
+  }
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  report_throughput(data_dir, out_dir);
+  report_scheduler(data_dir, out_dir);
+  report_latency(data_dir, out_dir);
+  report_correlations(data_dir, out_dir);
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double elapsed_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+  fprintf(stderr, "INFO: Reports written to %s in %.2f ms\n", out_dir, elapsed_ms);
+
+  return 0;
+}
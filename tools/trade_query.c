@@ -0,0 +1,282 @@
+/**
+ * @file trade_query.c
+ * @brief Extracts archived trades of one symbol within a time range.
+ *
+ * Usage: trade_query [-d DIR] SYMBOL FROM TO
+ *
+ * FROM/TO are epoch milliseconds or UTC times (YYYY-MM-DDTHH:MM[:SS]); both ends are
+ * inclusive. Matching raw JSON lines are written to stdout in archive order, so the
+ * output can be fed straight into `main --replay -`.
+ *
+ * Segments whose `.idx` minute index does not cover the range are skipped, and the
+ * others are entered at the offset the index records, so only the requested minutes
+ * are read. Segments without an index are scanned in full.
+ * Gzipped segments are read transparently (seeking decompresses up to the offset).
+ *
+ * @author Fraidakis Ioannis
+ * @date September 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <glob.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "../src/logging/trade_index.h"
+
+#define MS_PER_MINUTE 60000LL
+#define ORDER_SLACK_MS MS_PER_MINUTE /**< tolerated disorder between exchange and receive time */
+#define MAX_SEGMENTS 4096
+
+/**
+ * @brief A trade log segment and the start time encoded in its name.
+ */
+typedef struct
+{
+  char path[256];
+  int64_t start_ms;
+} segment_file;
+
+/**
+ * @brief Parses epoch milliseconds or a UTC time (YYYY-MM-DDTHH:MM[:SS]).
+ * @param text Input text.
+ * @param out_ms Pointer to store the timestamp.
+ * @return 1 on success, 0 on failure.
+ */
+static int parse_time_arg(const char *text, int64_t *out_ms)
+{
+  char *endp;
+  long long ms = strtoll(text, &endp, 10);
+  if (*endp == '\0')
+  {
+    *out_ms = ms;
+    return 1;
+  }
+
+  struct tm tm;
+  memset(&tm, 0, sizeof(tm));
+  int n = sscanf(text, "%d-%d-%dT%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                 &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+  if (n < 5)
+    return 0;
+
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  *out_ms = (int64_t)timegm(&tm) * 1000;
+  return 1;
+}
+
+/**
+ * @brief Extracts the segment start time from `<dir>/<symbol>.<YYYYmmddTHHMMSSmmm>.jsonl[.gz]`.
+ * @param path Segment path.
+ * @param symbol Symbol name.
+ * @return Start time in ms, or -1 if the name does not match.
+ */
+static int64_t segment_start_ms(const char *path, const char *symbol)
+{
+  const char *base = strrchr(path, '/');
+  base = base ? base + 1 : path;
+
+  size_t sym_len = strlen(symbol);
+  if (strncmp(base, symbol, sym_len) != 0 || base[sym_len] != '.')
+    return -1;
+
+  struct tm tm;
+  int ms;
+  memset(&tm, 0, sizeof(tm));
+  if (sscanf(base + sym_len + 1, "%4d%2d%2dT%2d%2d%2d%3d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+             &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &ms) != 7)
+    return -1;
+
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  return (int64_t)timegm(&tm) * 1000 + ms;
+}
+
+/**
+ * @brief Sort segments by start time.
+ */
+static int compare_segments(const void *a, const void *b)
+{
+  int64_t sa = ((const segment_file *)a)->start_ms;
+  int64_t sb = ((const segment_file *)b)->start_ms;
+  return (sa > sb) - (sa < sb);
+}
+
+/**
+ * @brief Decides whether and where to read a segment for trades in [from_ms, to_ms].
+ * @param segment_path Segment path (possibly ending in .gz).
+ * @param from_ms Start of the requested range.
+ * @param to_ms End of the requested range.
+ * @param out_offset Pointer to store the byte offset in the uncompressed segment.
+ * @return 0 if the index shows the segment holds no trades in range, 1 otherwise
+ * (with offset 0 when there is no usable index).
+ */
+static int index_lookup(const char *segment_path, int64_t from_ms, int64_t to_ms, uint64_t *out_offset)
+{
+  char index_path[300];
+  size_t base_len = strlen(segment_path);
+  if (base_len > 3 && strcmp(segment_path + base_len - 3, ".gz") == 0)
+    base_len -= 3;
+  snprintf(index_path, sizeof(index_path), "%.*s%s", (int)base_len, segment_path, TRADE_INDEX_SUFFIX);
+
+  *out_offset = 0;
+
+  FILE *fp = fopen(index_path, "rb");
+  if (!fp)
+    return 1;
+
+  /* entries are in increasing minute order: keep the last one safely before the range */
+  int64_t target_minute_ms = ((from_ms - ORDER_SLACK_MS) / MS_PER_MINUTE) * MS_PER_MINUTE;
+  int64_t first_minute_ms = INT64_MAX, last_minute_ms = INT64_MIN;
+  trade_index_entry entry;
+
+  while (fread(&entry, sizeof(entry), 1, fp) == 1)
+  {
+    if (first_minute_ms == INT64_MAX)
+      first_minute_ms = entry.minute_ts_ms;
+    last_minute_ms = entry.minute_ts_ms;
+    if (entry.minute_ts_ms <= target_minute_ms)
+      *out_offset = entry.offset;
+  }
+
+  fclose(fp);
+
+  if (last_minute_ms == INT64_MIN) // empty index: fall back to a full scan
+    return 1;
+
+  return last_minute_ms + MS_PER_MINUTE + ORDER_SLACK_MS >= from_ms &&
+         first_minute_ms - ORDER_SLACK_MS <= to_ms;
+}
+
+/**
+ * @brief Reads the exchange timestamp ("ts") of a raw OKX trade line.
+ * @param line Raw JSON line.
+ * @param out_ts_ms Pointer to store the timestamp.
+ * @return 1 on success, 0 if the line has no timestamp.
+ */
+static int line_trade_ts(const char *line, int64_t *out_ts_ms)
+{
+  const char *p = strstr(line, "\"ts\":\"");
+  if (!p)
+    return 0;
+
+  *out_ts_ms = strtoll(p + 6, NULL, 10);
+  return *out_ts_ms > 0;
+}
+
+int main(int argc, char **argv)
+{
+  const char *dir = "data/trades";
+  int argi = 1;
+
+  if (argc > 2 && strcmp(argv[1], "-d") == 0)
+  {
+    dir = argv[2];
+    argi = 3;
+  }
+
+  int64_t from_ms, to_ms;
+  if (argc - argi != 3 || !parse_time_arg(argv[argi + 1], &from_ms) || !parse_time_arg(argv[argi + 2], &to_ms))
+  {
+    fprintf(stderr, "Usage: %s [-d DIR] SYMBOL FROM TO\n", argv[0]);
+    fprintf(stderr, "  FROM/TO: epoch ms or UTC YYYY-MM-DDTHH:MM[:SS] (inclusive)\n");
+    return 1;
+  }
+  const char *symbol = argv[argi];
+
+  /* collect plain and gzipped segments of the symbol */
+  static segment_file segments[MAX_SEGMENTS];
+  int num_segments = 0;
+  const char *patterns[] = {"%s/%s.*.jsonl", "%s/%s.*.jsonl.gz"};
+
+  for (int p = 0; p < 2; ++p)
+  {
+    char pattern[256];
+    glob_t g;
+    snprintf(pattern, sizeof(pattern), patterns[p], dir, symbol);
+    if (glob(pattern, 0, NULL, &g) != 0)
+      continue;
+
+    for (size_t i = 0; i < g.gl_pathc && num_segments < MAX_SEGMENTS; ++i)
+    {
+      int64_t start_ms = segment_start_ms(g.gl_pathv[i], symbol);
+      if (start_ms < 0)
+        continue;
+      snprintf(segments[num_segments].path, sizeof(segments[num_segments].path), "%s", g.gl_pathv[i]);
+      segments[num_segments].start_ms = start_ms;
+      num_segments++;
+    }
+    globfree(&g);
+  }
+
+  qsort(segments, num_segments, sizeof(segment_file), compare_segments);
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  char line[4096];
+  long long matched = 0, scanned_lines = 0;
+  unsigned long long skipped_bytes = 0;
+  int scanned_segments = 0;
+
+  for (int k = 0; k < num_segments; ++k)
+  {
+    uint64_t offset;
+    if (!index_lookup(segments[k].path, from_ms, to_ms, &offset))
+      continue;
+
+    gzFile in = gzopen(segments[k].path, "rb");
+    if (!in)
+    {
+      fprintf(stderr, "WARNING: Failed to open %s\n", segments[k].path);
+      continue;
+    }
+    gzbuffer(in, 256 * 1024);
+
+    if (offset > 0 && gzseek(in, (z_off_t)offset, SEEK_SET) < 0)
+    {
+      gzrewind(in);
+      offset = 0;
+    }
+    skipped_bytes += offset;
+    scanned_segments++;
+
+    while (gzgets(in, line, sizeof(line)))
+    {
+      if (line[0] == '\0') // zero-filled tail of a segment that is still being written
+        break;
+
+      int64_t ts_ms;
+      scanned_lines++;
+      if (!line_trade_ts(line, &ts_ms))
+        continue;
+
+      if (ts_ms > to_ms + ORDER_SLACK_MS) // the rest of the segment is later still
+        break;
+
+      if (ts_ms >= from_ms && ts_ms <= to_ms)
+      {
+        fputs(line, stdout);
+        matched++;
+      }
+    }
+
+    gzclose(in);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double elapsed_ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+  fprintf(stderr, "INFO: %lld trades matched, %lld lines scanned in %d segment(s), "
+                  "%llu bytes skipped via index, %.2f ms\n",
+          matched, scanned_lines, scanned_segments, skipped_bytes, elapsed_ms);
+
+  return 0;
+}